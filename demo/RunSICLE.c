@@ -10,14 +10,48 @@
 #include "iftArgs.h"
 #include "iftSICLE.h"
 
+#ifdef IFT_OMP //-------------------------------------------------------------|
+#include <omp.h>
+#endif //---------------------------------------------------------------------|
+
+typedef struct scale_output
+{
+	const char *path; // Output path, whose basename is suffixed by the scale
+	bool is_video; // Whether the scales are written as video folders
+} ScaleOutput;
+
 /* PROTOTYPES ****************************************************************/
 void readImgInputs
-(iftArgs *args, iftImage **img, iftImage **mask, iftImage **objsm, 
-	const char **path, bool *is_video);
+(iftArgs *args, iftImage **img, iftMImage **mimg, iftImage **mask, 
+	iftImage **objsm, const char **path, bool *is_video, char **scratch_dir);
 
 void readSICLEArgs
 (iftArgs *args, iftSICLEArgs **sargs);
 
+iftIntArray *readIntList
+(iftArgs *args, const char *name);
+
+void writeScale
+(iftImage *label_img, int scale, void *user_data);
+
+void runStreaming
+(iftArgs *args);
+
+void writeFrame
+(iftImage *label_frame, int frame_id, void *user_data);
+
+void runTiled
+(iftArgs *args);
+
+void writeTile
+(iftImage *label_tile, int x0, int y0, void *user_data);
+
+void runBatch
+(iftArgs *args);
+
+const char *checkImageFile
+(const char *path);
+
 void usage();
 
 char *remove_ext (const char* myStr, char extSep, char pathSep);
@@ -37,24 +71,68 @@ int main(int argc, char const *argv[])
 	if(!has_req || has_help)
 	{ usage(); iftDestroyArgs(&args); return EXIT_FAILURE; }
 	//-----------------------------------------------------------------------//
-	bool multiscale, is_video;
+	if(iftExistArg(args, "window") == true) // Streaming over a video?
+	{ runStreaming(args); iftDestroyArgs(&args); return EXIT_SUCCESS; }
+	if(iftExistArg(args, "img-tile") == true) // Tiled over a large image?
+	{ runTiled(args); iftDestroyArgs(&args); return EXIT_SUCCESS; }
+	if(iftExistArg(args, "batch") == true) // Many images in one process?
+	{ runBatch(args); iftDestroyArgs(&args); return EXIT_SUCCESS; }
+
+	bool multiscale, hierarchy, is_video;
+	char *scratch_dir;
 	const char* OUT;
 	iftSICLEArgs *sargs;
 	iftSICLE *sicle;
 	iftImage *img, *objsm, *mask;
+	iftMImage *mimg;
 
 	multiscale = iftExistArg(args, "multiscale");
-	readImgInputs(args, &img, &mask, &objsm, &OUT, &is_video);
+	hierarchy = iftExistArg(args, "hierarchy");
+	if(hierarchy == true && multiscale == false)
+	{ iftError("A hierarchy requires a multiscale segmentation", __func__); }
+	readImgInputs(args, &img, &mimg, &mask, &objsm, &OUT, &is_video, 
+								&scratch_dir);
 	readSICLEArgs(args, &sargs);
 	iftDestroyArgs(&args);
 	
-	sicle = iftCreateSICLE(img, objsm, mask);
-	iftDestroyImage(&img);
+	if(mimg != NULL) // Out-of-core?
+	{ sicle = iftCreateMappedSICLE(mimg, objsm, mask, scratch_dir); }
+	else { sicle = iftCreateSICLE(img, objsm, mask); iftDestroyImage(&img); }
+	if(scratch_dir != NULL) { free(scratch_dir); }
 	if(objsm != NULL) { iftDestroyImage(&objsm); }
 	if(mask != NULL) { iftDestroyImage(&mask); }
 
 	iftVerifySICLEArgs(sicle, sargs);
-	if(multiscale == false)
+	if(sargs->nf_targets != NULL) // A segmentation per Nf target
+	{
+		char *basename;
+		const char *EXT;
+		iftImage **segms;
+
+		if(multiscale == true)
+		{ iftError("Nf targets cannot be used with multiscale", __func__); }
+
+		EXT = iftFileExt(OUT);
+		basename = remove_ext(OUT,'.','/');
+		segms = iftRunMultiTargetSICLE(sicle, sargs);
+		for(long i = 0; i < sargs->nf_targets->n; ++i)
+		{
+			const int TARGET = sargs->nf_targets->val[i];
+
+			if(is_video == false)
+			{ iftWriteImageByExt(segms[i], "%s_nf%d%s", basename, TARGET, EXT); }
+			else
+			{ 
+				char tmp[IFT_STR_DEFAULT_SIZE];
+
+				sprintf(tmp, "%s_nf%d/%s",basename,TARGET,EXT);
+				iftWriteVolumeAsSingleVideoFolder(segms[i], tmp); 
+			}
+			iftDestroyImage(&(segms[i]));
+		}
+		free(segms); free(basename);
+	}
+	else if(multiscale == false)
 	{
 		iftImage *segm;
 
@@ -65,30 +143,20 @@ int main(int argc, char const *argv[])
 		{ iftWriteVolumeAsSingleVideoFolder(segm, OUT); }
 		iftDestroyImage(&segm);
 	}
-	else
+	else if(hierarchy == true) // A single file with every scale
 	{
-		const char *EXT;
-		int num_scales;
-		char *basename;
-		iftImage **multisegm;
+		iftSICLEHierarchy *hier;
 
-	  EXT = iftFileExt(OUT);
-	  basename = remove_ext(OUT,'.','/');
-		multisegm = iftRunMultiscaleSICLE(sicle, sargs, &num_scales);
-		for(int i = 0; i < num_scales; ++i)
-		{
-			if(is_video == false)
-			{ iftWriteImageByExt(multisegm[i], "%s_%d%s", basename, i+1, EXT); }
-			else
-			{ 
-				char tmp[IFT_STR_DEFAULT_SIZE];
+		hier = iftRunHierarchicalSICLE(sicle, sargs);
+		iftWriteSICLEHierarchy(hier, OUT);
+		iftDestroySICLEHierarchy(&hier);
+	}
+	else // Each scale is written while the next ones are computed
+	{
+		ScaleOutput out;
 
-				sprintf(tmp, "%s_%d/%s",basename,i+1,EXT);
-				iftWriteVolumeAsSingleVideoFolder(multisegm[i], tmp); 
-			}
-			iftDestroyImage(&(multisegm[i]));
-		}
-		free(multisegm);
+		out.path = OUT; out.is_video = is_video;
+		iftRunEmittedMultiscaleSICLE(sicle, sargs, true, writeScale, &out);
 	}
 	iftDestroySICLE(&sicle);
 	iftDestroySICLEArgs(&sargs);
@@ -98,15 +166,28 @@ int main(int argc, char const *argv[])
 }
 /* METHODS********************************************************************/
 void readImgInputs
-(iftArgs *args, iftImage **img, iftImage **mask, iftImage **objsm, 
-	const char **path, bool *is_video)
+(iftArgs *args, iftImage **img, iftMImage **mimg, iftImage **mask, 
+	iftImage **objsm, const char **path, bool *is_video, char **scratch_dir)
 {
 	const char *VAL;
+
+	if(iftExistArg(args, "scratch-dir") == false) { (*scratch_dir) = NULL; }
+	else if(iftHasArgVal(args, "scratch-dir") == true)
+	{ (*scratch_dir) = iftCopyString(iftGetArg(args, "scratch-dir")); }
+	else { iftError("No scratch directory was given", __func__); }
+
+	(*mimg) = NULL;
 	if(iftHasArgVal(args, "img") == true)
 	{
 		VAL = iftGetArg(args,"img");
 		if(iftIsImageFile(VAL) == true) 
 		{ (*img) = iftReadImageByExt(VAL); (*is_video) = false; }
+		else if(iftDirExists(VAL) == true && (*scratch_dir) != NULL)
+		{ 
+			(*img) = NULL; (*is_video) = true;
+			(*mimg) = iftReadImageFolderAsMappedMImage(VAL, LAB_CSPACE, 
+																								 (*scratch_dir));
+		}
 		else if(iftDirExists(VAL) == true)
 		{ (*img) = iftReadImageFolderAsVolume(VAL); (*is_video) = true;}
 		else { iftError("Unknown image/video format", __func__); } 
@@ -127,7 +208,7 @@ void readImgInputs
 		{ (*mask) = iftReadImageFolderAsVolume(VAL); }
 		else { iftError("Unknown image/video format", __func__); }
 
-		iftVerifyImageDomains((*img), (*mask), __func__);
+		if((*img) != NULL) { iftVerifyImageDomains((*img), (*mask), __func__); }
  	}
 	else { iftError("No mask path was given", __func__); }
 
@@ -141,7 +222,7 @@ void readImgInputs
 		{ (*objsm) = iftReadImageFolderAsVolume(VAL); } 
 		else { iftError("Unknown image/video format", __func__); }
 
-		iftVerifyImageDomains((*img), (*objsm), __func__);
+		if((*img) != NULL) { iftVerifyImageDomains((*img), (*objsm), __func__); }
 	}
 	else { iftError("No saliency map path was given", __func__); }
 }
@@ -153,6 +234,21 @@ void readSICLEArgs
 
 	(*sargs)->use_diag = !iftExistArg(args, "no-diag");
 	(*sargs)->use_dift = !iftExistArg(args, "no-dift");
+	(*sargs)->use_bqueue = iftExistArg(args, "bqueue");
+
+	if(iftExistArg(args, "buckets") == true)
+	{
+		if(iftHasArgVal(args, "buckets") == true) 
+		{ (*sargs)->num_buckets = atoi(iftGetArg(args, "buckets")); }
+		else { iftError("No quantity of buckets was given", __func__); }
+	}
+
+	if(iftExistArg(args, "tile-size") == true)
+	{
+		if(iftHasArgVal(args, "tile-size") == true) 
+		{ (*sargs)->tile_size = atoi(iftGetArg(args, "tile-size")); }
+		else { iftError("No tile size was given", __func__); }
+	}
 
 	if(iftExistArg(args, "max-iters") == true)
 	{
@@ -275,35 +371,20 @@ void readSICLEArgs
 	}
 	
 	if(iftExistArg(args, "ni") == true)
-  {
-    if(iftHasArgVal(args, "ni") == true)
-    {
-      const char *VAL;
-      char *tmp, *tok;
-      int i;
-      iftSet *vals;
-
-      vals = NULL;
-      VAL = iftGetArg(args, "ni");
-      tmp = iftCopyString(VAL);
-      tok = strtok(tmp, ",");
-
-      i = 0;
-      while(tok != NULL)
-      {
-        iftInsertSet(&vals, atoi(tok));
-        tok = strtok(NULL, ",");
-        ++i;
-     	}
-      free(tmp);
-      if(vals == NULL) { iftError("No list of Ni values was provided", __func__); }
-
-      (*sargs)->user_ni = iftCreateIntArray(i);
-      while(vals != NULL)
-      { (*sargs)->user_ni->val[--i] = iftRemoveSet(&vals);}
-    }
-    else { iftError("No list of Ni values was provided", __func__); }
-  }
+	{ (*sargs)->user_ni = readIntList(args, "ni"); }
+	if(iftExistArg(args, "nf-targets") == true)
+	{ 
+		int last_target;
+
+		(*sargs)->nf_targets = readIntList(args, "nf-targets"); 
+		last_target = (*sargs)->nf_targets->val[(*sargs)->nf_targets->n - 1];
+		if(iftExistArg(args, "nf") == true && (*sargs)->nf != last_target)
+		{
+			iftError("The Nf of %d differs from the last (smallest) Nf target of %d", 
+							 __func__, (*sargs)->nf, last_target);
+		}
+		(*sargs)->nf = last_target; // The run stops at the smallest target
+	}
   if(iftExistArg(args, "reseg") == true)
   {
 	if(iftHasArgVal(args,"reseg") == true){
@@ -335,6 +416,420 @@ void readSICLEArgs
   
 }
 
+iftIntArray *readIntList
+(iftArgs *args, const char *name)
+{
+	char *tmp, *tok;
+	int i;
+	iftSet *vals;
+	iftIntArray *list;
+
+	if(iftHasArgVal(args, name) == false)
+	{ iftError("No list of %s values was provided", __func__, name); }
+
+	vals = NULL;
+	tmp = iftCopyString(iftGetArg(args, name));
+	tok = strtok(tmp, ",");
+
+	i = 0;
+	while(tok != NULL)
+	{
+		iftInsertSet(&vals, atoi(tok));
+		tok = strtok(NULL, ",");
+		++i;
+	}
+	free(tmp);
+	if(vals == NULL) 
+	{ iftError("No list of %s values was provided", __func__, name); }
+
+	list = iftCreateIntArray(i);
+	while(vals != NULL) { list->val[--i] = iftRemoveSet(&vals); }
+
+	return list;
+}
+
+void runStreaming
+(iftArgs *args)
+{
+	int window_size = 0, overlap;
+	const char *VAL;
+	iftFileSet *frames;
+	iftSICLEArgs *sargs;
+
+	if(iftExistArg(args, "mask") || iftExistArg(args, "objsm") ||
+		 iftExistArg(args, "multiscale") || iftExistArg(args, "scratch-dir"))
+	{ 
+		iftError("Streaming does not support masks, saliency maps, multiscale "
+						 "or scratch directories", __func__);
+	}
+
+	VAL = iftGetArg(args, "img");
+	if(VAL == NULL || iftDirExists(VAL) == false)
+	{ iftError("Streaming requires a video folder", __func__); }
+	frames = iftLoadFileSetFromDirOrCSV(VAL, 0, true);
+
+	if(iftHasArgVal(args, "out") == false)
+	{ iftError("No output path was given", __func__); }
+
+	if(iftHasArgVal(args, "window") == true)
+	{ window_size = atoi(iftGetArg(args, "window")); }
+	else { iftError("No window size was given", __func__); }
+
+	overlap = 1;
+	if(iftExistArg(args, "overlap") == true)
+	{
+		if(iftHasArgVal(args, "overlap") == true) 
+		{ overlap = atoi(iftGetArg(args, "overlap")); }
+		else { iftError("No window overlap was given", __func__); }
+	}
+
+	readSICLEArgs(args, &sargs);
+	iftRunStreamingSICLE(frames, sargs, window_size, overlap, writeFrame, 
+											 (void*)iftGetArg(args, "out"));
+
+	iftDestroySICLEArgs(&sargs);
+	iftDestroyFileSet(&frames);
+}
+
+void writeScale
+(iftImage *label_img, int scale, void *user_data)
+{
+	const char *EXT;
+	char *basename;
+	ScaleOutput *out;
+
+	out = (ScaleOutput*)user_data;
+	EXT = iftFileExt(out->path);
+	basename = remove_ext(out->path,'.','/');
+	if(out->is_video == false)
+	{ iftWriteImageByExt(label_img, "%s_%d%s", basename, scale+1, EXT); }
+	else
+	{ 
+		char tmp[IFT_STR_DEFAULT_SIZE];
+
+		sprintf(tmp, "%s_%d/%s",basename,scale+1,EXT);
+		iftWriteVolumeAsSingleVideoFolder(label_img, tmp); 
+	}
+	free(basename);
+}
+
+void writeFrame
+(iftImage *label_frame, int frame_id, void *user_data)
+{
+	const char *OUT, *EXT;
+	char *base;
+	char tmp[IFT_STR_DEFAULT_SIZE];
+
+	OUT = (const char*)user_data;
+	EXT = iftFileExt(OUT);
+	base = iftRemoveSuffix(OUT, EXT);
+
+	// Same naming as iftWriteVolumeAsSingleVideoFolder
+	sprintf(tmp, "%s%0*d%s", base, IFT_VIDEO_FOLDER_FRAME_NZEROES, frame_id, EXT);
+	iftWriteImageByExt(label_frame, tmp);
+	free(base);
+}
+
+void runTiled
+(iftArgs *args)
+{
+	int tile_size = 0, overlap, global_nf;
+	const char *IMG, *OUT;
+	FILE *fp;
+	iftImageDomain dom;
+	iftSICLEArgs *sargs;
+
+	if(iftExistArg(args, "mask") || iftExistArg(args, "objsm") ||
+		 iftExistArg(args, "multiscale") || iftExistArg(args, "scratch-dir"))
+	{ 
+		iftError("Tiling does not support masks, saliency maps, multiscale "
+						 "or scratch directories", __func__);
+	}
+
+	IMG = iftGetArg(args, "img");
+	if(IMG == NULL || iftIsImageFile(IMG) == false)
+	{ iftError("Tiling requires an image file", __func__); }
+
+	OUT = iftGetArg(args, "out");
+	if(OUT == NULL || iftCompareStrings(iftFileExt(OUT), ".pgm") == false)
+	{ iftError("Tiling requires a PGM output path", __func__); }
+
+	if(iftHasArgVal(args, "img-tile") == true)
+	{ tile_size = atoi(iftGetArg(args, "img-tile")); }
+	else { iftError("No image tile size was given", __func__); }
+
+	overlap = tile_size / 8;
+	if(iftExistArg(args, "img-overlap") == true)
+	{
+		if(iftHasArgVal(args, "img-overlap") == true) 
+		{ overlap = atoi(iftGetArg(args, "img-overlap")); }
+		else { iftError("No image tile overlap was given", __func__); }
+	}
+
+	global_nf = 0;
+	if(iftExistArg(args, "global-nf") == true)
+	{
+		if(iftHasArgVal(args, "global-nf") == true) 
+		{ global_nf = atoi(iftGetArg(args, "global-nf")); }
+		else { iftError("No global quantity of superpixels was given", __func__); }
+	}
+
+	// The 16-bit label map is allocated and then written tile by tile
+	dom = iftReadImageDomain(IMG);
+	fp = fopen(OUT, "wb+");
+	if(fp == NULL) { iftError(MSG_FILE_OPEN_ERROR, __func__, OUT); }
+	fprintf(fp, "P5\n%d %d\n65535\n", dom.xsize, dom.ysize);
+	fseek(fp, ftell(fp) + 2L * dom.xsize * dom.ysize - 1, SEEK_SET);
+	fputc(0, fp);
+
+	readSICLEArgs(args, &sargs);
+	iftRunTiledSICLE(IMG, sargs, tile_size, overlap, global_nf, 
+									 iftExistArg(args, "parallel-tiles"), writeTile, fp);
+
+	fclose(fp);
+	iftDestroySICLEArgs(&sargs);
+}
+
+void writeTile
+(iftImage *label_tile, int x0, int y0, void *user_data)
+{
+	int xsize, ysize, maxval;
+	long data_start;
+	uchar *row;
+	FILE *fp;
+
+	fp = (FILE*)user_data;
+	rewind(fp);
+	if(fscanf(fp, "P5 %d %d %d", &xsize, &ysize, &maxval) != 3)
+	{ iftError("Reading error", __func__); }
+	data_start = ftell(fp) + 1;
+
+	row = iftAllocUCharArray(2 * label_tile->xsize);
+	for(int y = 0; y < label_tile->ysize; ++y)
+	{
+		for(int x = 0; x < label_tile->xsize; ++x)
+		{
+			int label;
+
+			label = label_tile->val[x + label_tile->tby[y]];
+			if(label > maxval) 
+			{ iftError("Label %d does not fit within a 16-bit PGM", __func__, label); }
+			row[2 * x] = label >> 8; row[2 * x + 1] = label & 0xff; // Big endian
+		}
+		fseek(fp, data_start + 2L * ((long)(y0 + y) * xsize + x0), SEEK_SET);
+		fwrite(row, 2, label_tile->xsize, fp);
+	}
+	iftFree(row);
+}
+
+void runBatch
+(iftArgs *args)
+{
+	int num_workers;
+	char **status;
+	const char *IMG, *OUT;
+	float *times;
+	FILE *timing_fp;
+	iftFileSet *files;
+	iftSICLEArgs *sargs;
+
+	if(iftExistArg(args, "mask") || iftExistArg(args, "objsm") ||
+		 iftExistArg(args, "multiscale") || iftExistArg(args, "scratch-dir"))
+	{ 
+		iftError("Batch mode does not support masks, saliency maps, multiscale "
+						 "or scratch directories", __func__);
+	}
+
+	IMG = iftGetArg(args, "img"); OUT = iftGetArg(args, "out");
+	if(IMG == NULL) { iftError("No image folder or CSV was given", __func__); }
+	if(OUT == NULL) { iftError("No output folder was given", __func__); }
+	files = iftLoadFileSetFromDirOrCSV(IMG, 0, true);
+	if(iftDirExists(OUT) == false) { iftMakeDir(OUT); }
+
+	num_workers = 1;
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	num_workers = omp_get_max_threads();
+	#endif //-------------------------------------------------------------------|
+	if(iftExistArg(args, "workers") == true)
+	{
+		if(iftHasArgVal(args, "workers") == true) 
+		{ num_workers = atoi(iftGetArg(args, "workers")); }
+		else { iftError("No quantity of workers was given", __func__); }
+		if(num_workers < 1) { iftError("There must be at least one worker", __func__); }
+	}
+
+	timing_fp = NULL;
+	if(iftExistArg(args, "timing") == true) // Opened before any work
+	{
+		if(iftHasArgVal(args, "timing") == false)
+		{ iftError("No timing CSV path was given", __func__); }
+
+		timing_fp = fopen(iftGetArg(args, "timing"), "w");
+		if(timing_fp == NULL) 
+		{ iftError(MSG_FILE_OPEN_ERROR, __func__, iftGetArg(args, "timing")); }
+	}
+
+	readSICLEArgs(args, &sargs);
+	times = calloc(files->n * 3, sizeof(float)); // Decoding, SICLE and encoding
+	status = calloc(files->n, sizeof(char*)); // NULL if segmented
+	assert(times != NULL); assert(status != NULL);
+
+	// A bad image must not abort the other ones, so the files which cannot be
+	// decoded are skipped beforehand
+	for(long i = 0; i < files->n; ++i)
+	{
+		const char *REASON;
+
+		REASON = checkImageFile(files->files[i]->path);
+		if(REASON != NULL) { status[i] = iftCopyString("%s", REASON); }
+	}
+
+	// Each worker decodes, segments and encodes its images, so the stages of 
+	// different images overlap. Its prototype is reused for same-sized images
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel num_threads(num_workers)
+	#endif //-------------------------------------------------------------------|
+	{
+		bool was_color;
+		iftImageDomain dom;
+		iftSICLE *sicle;
+
+		sicle = NULL; was_color = false; dom.xsize = dom.ysize = dom.zsize = 0;
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp for schedule(dynamic)
+		#endif //-----------------------------------------------------------------|
+		for(long i = 0; i < files->n; ++i)
+		{
+			const char *PATH;
+			char *name;
+			timer *tic;
+			iftImage *img, *segm;
+
+			if(status[i] != NULL) { continue; }
+
+			PATH = files->files[i]->path;
+			tic = iftTic();
+			img = iftReadImageByExt(PATH);
+			times[i * 3] = iftCompTime(tic, iftToc());
+
+			if(sargs->n0 >= img->n) // The only image-dependent argument
+			{ 
+				status[i] = iftCopyString("N0 of %d is not below its %d spels", 
+																	sargs->n0, img->n);
+				iftDestroyImage(&img);
+				continue;
+			}
+
+			tic = iftTic();
+			if(sicle != NULL && was_color == iftIsColorImage(img) &&
+				 dom.xsize == img->xsize && dom.ysize == img->ysize && 
+				 dom.zsize == img->zsize)
+			{ iftUpdateSICLE(sicle, img, NULL, NULL); }
+			else
+			{ 
+				if(sicle != NULL) { iftDestroySICLE(&sicle); }
+				sicle = iftCreateSICLE(img, NULL, NULL); 
+				was_color = iftIsColorImage(img);
+				dom.xsize = img->xsize; dom.ysize = img->ysize; dom.zsize = img->zsize;
+			}
+			iftVerifySICLEArgs(sicle, sargs);
+			segm = iftRunSICLE(sicle, sargs);
+			times[i * 3 + 1] = iftCompTime(tic, iftToc());
+
+			tic = iftTic();
+			name = iftFilename(PATH, iftFileExt(PATH));
+			iftWriteImageByExt(segm, "%s/%s.pgm", OUT, name);
+			times[i * 3 + 2] = iftCompTime(tic, iftToc());
+
+			free(name);
+			iftDestroyImage(&segm);
+			iftDestroyImage(&img);
+		}
+		if(sicle != NULL) { iftDestroySICLE(&sicle); }
+	}
+
+	for(long i = 0; i < files->n; ++i)
+	{
+		if(status[i] != NULL)
+		{ 
+			iftWarning("Image %s was skipped: %s", __func__, 
+								 files->files[i]->path, status[i]); 
+		}
+	}
+
+	if(timing_fp != NULL)
+	{
+		fprintf(timing_fp, "image,decode_ms,sicle_ms,encode_ms,status\n");
+		for(long i = 0; i < files->n; ++i)
+		{
+			fprintf(timing_fp, "%s,%.3f,%.3f,%.3f,%s\n", files->files[i]->path, 
+							times[i * 3], times[i * 3 + 1], times[i * 3 + 2], 
+							(status[i] != NULL) ? status[i] : "ok");
+		}
+		fclose(timing_fp);
+	}
+
+	for(long i = 0; i < files->n; ++i)
+	{ if(status[i] != NULL) { free(status[i]); } }
+	free(status);
+	free(times);
+	iftDestroySICLEArgs(&sargs);
+	iftDestroyFileSet(&files);
+}
+
+const char *checkImageFile
+(const char *path)
+{
+	char magic[8], *ext;
+	size_t len;
+	const char *REASON;
+	FILE *fp;
+
+	fp = fopen(path, "rb");
+	if(fp == NULL) { return "cannot be opened"; }
+	len = fread(magic, 1, 8, fp);
+	fclose(fp);
+
+	// Same formats as iftReadImageByExt, recognized by their magic numbers
+	ext = iftLowerString(iftFileExt(path));
+	REASON = NULL;
+	if(iftCompareStrings(ext, ".png"))
+	{
+		#ifdef IFT_LIBPNG //------------------------------------------------------|
+		if(len < 8 || memcmp(magic, "\x89PNG\r\n\x1a\n", 8) != 0) 
+		{ REASON = "not a PNG file"; }
+		#else //------------------------------------------------------------------|
+		REASON = "LibPNG support was not enabled";
+		#endif //-----------------------------------------------------------------|
+	}
+	else if(iftCompareStrings(ext, ".jpg") || iftCompareStrings(ext, ".jpeg"))
+	{
+		#ifdef IFT_LIBJPEG //-----------------------------------------------------|
+		if(len < 2 || memcmp(magic, "\xff\xd8", 2) != 0) 
+		{ REASON = "not a JPEG file"; }
+		#else //------------------------------------------------------------------|
+		REASON = "LibJPEG support was not enabled";
+		#endif //-----------------------------------------------------------------|
+	}
+	else if(iftCompareStrings(ext, ".pgm"))
+	{
+		if(len < 2 || (memcmp(magic, "P5", 2) != 0 && memcmp(magic, "P2", 2) != 0))
+		{ REASON = "not a PGM file"; }
+	}
+	else if(iftCompareStrings(ext, ".ppm"))
+	{
+		if(len < 2 || memcmp(magic, "P6", 2) != 0) { REASON = "not a binary PPM file"; }
+	}
+	else if(iftCompareStrings(ext, ".scn"))
+	{ 
+		if(len < 3 || memcmp(magic, "SCN", 3) != 0) { REASON = "not a SCN file"; } 
+	}
+	else { REASON = "unsupported image format"; }
+	free(ext);
+
+	return REASON;
+}
+
 void usage()
 {
 	const int SKIP_IND = 15; // For indentation purposes
@@ -364,10 +859,38 @@ void usage()
 	printf("\nOptional general parameters:\n");
 	printf("%-*s %s\n", SKIP_IND, "--multiscale",
 		"Generates a multiscale segmentation.");
+	printf("%-*s %s\n", SKIP_IND, "--hierarchy",
+		"Writes the multiscale segmentation as a single hierarchy file.");
 	printf("%-*s %s\n", SKIP_IND, "--no-diag",
 		"Disable diagonal neighborhood (i.e., 8- or 26-adjacency).");
 	printf("%-*s %s\n", SKIP_IND, "--no-dift",
 		"Disable differential computation.");
+	printf("%-*s %s\n", SKIP_IND, "--bqueue",
+		"Use a bucket queue over quantized path-costs. Fmax only.");
+	printf("%-*s %s\n", SKIP_IND, "--buckets",
+		"Bucket queue's quantity of cost quantization levels. Default: 65536");
+	printf("%-*s %s\n", SKIP_IND, "--tile-size",
+		"Tile's side length for a parallel partitioned IFT. Default: 0 (off)");
+	printf("%-*s %s\n", SKIP_IND, "--scratch-dir",
+		"Directory for memory-mapped scratch files. Volumes (folders) only.");
+	printf("%-*s %s\n", SKIP_IND, "--window",
+		"Streams a video (folder) in sliding windows of this many frames.");
+	printf("%-*s %s\n", SKIP_IND, "--overlap",
+		"Frames shared by consecutive streaming windows. Default: 1");
+	printf("%-*s %s\n", SKIP_IND, "--img-tile",
+		"Segments an image file in tiles of this side length. PGM output only.");
+	printf("%-*s %s\n", SKIP_IND, "--img-overlap",
+		"Tiles' expansion on each side for stitching. Default: 1/8 of the tile");
+	printf("%-*s %s\n", SKIP_IND, "--global-nf",
+		"Quantity of superpixels in the tiled image. Default: 0 (--nf per tile)");
+	printf("%-*s %s\n", SKIP_IND, "--parallel-tiles",
+		"Segments the image's tiles in parallel.");
+	printf("%-*s %s\n", SKIP_IND, "--batch",
+		"Segments every image of the --img folder or CSV into the --out folder.");
+	printf("%-*s %s\n", SKIP_IND, "--workers",
+		"Batch mode's quantity of worker threads. Default: OpenMP's maximum");
+	printf("%-*s %s\n", SKIP_IND, "--timing",
+		"Batch mode's CSV of per-image stage times (ms) and skip reasons.");
 	printf("%-*s %s\n", SKIP_IND, "--alpha",
 		"Saliency information importance. Default: 0.0");
 	printf("%-*s %s\n", SKIP_IND, "--irreg",
@@ -383,6 +906,8 @@ void usage()
 		"Desired final number of superpixels. Default: 200");
 	printf("%-*s %s\n", SKIP_IND, "--ni",
 		"Comma-separated list of intermediary seed quantity.");
+	printf("%-*s %s\n", SKIP_IND, "--nf-targets",
+		"Decreasing list of Nf values, each written as <out>_nf<Nf>. The last is Nf");
 	printf("%-*s %s\n", SKIP_IND, "--reseg",
 		"file for resegmentation using new seed's strategy");
 
@@ -0,0 +1,405 @@
+/*****************************************************************************\
+* RunSICLEServer.c
+*
+* AUTHOR  : Felipe Belem
+* DATE    : 2026-10-17
+* LICENSE : MIT License
+* EMAIL   : felipe.belem@ic.unicamp.br
+\*****************************************************************************/
+#include "ift.h"
+#include "iftArgs.h"
+#include "iftSICLE.h"
+
+/*
+ * Long-running SICLE server answering one request per line of stdin. It keeps
+ * the decoded image, its SICLE prototype and its last segmentation in memory,
+ * so interactive clients avoid spawning processes and re-encoding images.
+ * Every response starts by a line "ok ..." or "err <message>", and binary
+ * payloads follow their header immediately:
+ *
+ *  load <path>           -> ok <xsize> <ysize>
+ *  segment [<n0> [<nf>]] -> ok <number of scales> <number of superpixels>
+ *  scale <k>             -> ok <number of superpixels>
+ *  reseg <x> <y> [<k>]   -> ok <number of superpixels>
+ *  seed add <x> <y>      -> ok <x0> <y0> <x1> <y1>
+ *  seed remove <x> <y>   -> ok <x0> <y0> <x1> <y1>
+ *  seed move <x> <y> <x'> <y'> -> ok <x0> <y0> <x1> <y1>
+ *  labels                -> ok <xsize> <ysize> <nbytes>, native-endian int32
+ *  overlay <r> <g> <b>   -> ok <xsize> <ysize> <nbytes>, 8-bit RGB
+ *  quit                  -> ok
+ *
+ * The current labels are those of the last scale after "segment", those of
+ * the k-th scale (from the finest) after "scale", and the finest ones within
+ * the k-th scale's superpixel at (x,y) after "reseg", as in RunReseg. The
+ * border colors are normalized within [0,1], as in RunOvlayBorders. After
+ * "segment", the seeds of the last scale may be added, removed (by a spel of
+ * its superspel) or moved (from a spel of its superspel), and only the
+ * affected superspels are recomputed. Their labels are updated within the 
+ * bounding box [x0,x1]x[y0,y1] answered, and the others keep their labels.
+ */
+typedef struct server_state
+{
+	iftImage *img; // Decoded image
+	iftSICLE *sicle; // SICLE prototype of the image
+	iftSICLEHierarchy *hier; // Last multiscale segmentation, from the finest
+	iftImage *labels; // Current labels. Owned by the server
+	bool is_forest; // Whether the labels are those of the prototype's forest
+} ServerState;
+
+/* PROTOTYPES ****************************************************************/
+void answerRequest
+(ServerState *state, char *line, bool *quit);
+
+void clearSegmentation
+(ServerState *state);
+
+void editSeed
+(ServerState *state, char *line);
+
+void setLabels
+(ServerState *state, iftImage *labels);
+
+void writeLabels
+(ServerState *state);
+
+void writeOverlay
+(ServerState *state, float r, float g, float b);
+
+void usage();
+
+/* MAIN **********************************************************************/
+int main(int argc, char const *argv[])
+{
+	//-----------------------------------------------------------------------//
+	bool has_help;
+	iftArgs *args;
+
+	args = iftCreateArgs(argc, argv);
+	has_help = iftExistArg(args, "help");
+	iftDestroyArgs(&args);
+
+	if(has_help) { usage(); return EXIT_FAILURE; }
+	//-----------------------------------------------------------------------//
+	bool quit;
+	char line[IFT_STR_DEFAULT_SIZE];
+	ServerState state;
+
+	state.img = NULL; state.sicle = NULL; state.labels = NULL;
+	state.hier = NULL; state.is_forest = false;
+
+	quit = false;
+	while(!quit && fgets(line, IFT_STR_DEFAULT_SIZE, stdin) != NULL)
+	{
+		line[strcspn(line, "\r\n")] = '\0';
+		answerRequest(&state, line, &quit);
+		fflush(stdout);
+	}
+
+	clearSegmentation(&state);
+	if(state.sicle != NULL) { iftDestroySICLE(&(state.sicle)); }
+	if(state.img != NULL) { iftDestroyImage(&(state.img)); }
+
+	return EXIT_SUCCESS;
+}
+
+/* METHODS********************************************************************/
+void answerRequest
+(ServerState *state, char *line, bool *quit)
+{
+	char cmd[IFT_STR_DEFAULT_SIZE];
+	int offset;
+
+	if(sscanf(line, "%s%n", cmd, &offset) != 1) { printf("err Empty request\n"); }
+	else if(iftCompareStrings(cmd, "quit")) { (*quit) = true; printf("ok\n"); }
+	else if(iftCompareStrings(cmd, "load"))
+	{
+		const char *PATH;
+
+		PATH = line + offset + strspn(line + offset, " \t");
+		if(iftIsImageFile(PATH) == false)
+		{ printf("err Unknown image format: %s\n", PATH); return; }
+
+		clearSegmentation(state);
+		if(state->sicle != NULL) { iftDestroySICLE(&(state->sicle)); }
+		if(state->img != NULL) { iftDestroyImage(&(state->img)); }
+
+		state->img = iftReadImageByExt(PATH);
+		if(iftIs3DImage(state->img))
+		{ iftDestroyImage(&(state->img)); printf("err Only 2D images\n"); return; }
+		state->sicle = iftCreateSICLE(state->img, NULL, NULL);
+		printf("ok %d %d\n", state->img->xsize, state->img->ysize);
+	}
+	else if(state->img == NULL) { printf("err No image was loaded\n"); }
+	else if(iftCompareStrings(cmd, "segment"))
+	{
+		int n0, nf;
+		iftSICLEArgs *sargs;
+
+		sargs = iftCreateSICLEArgs();
+		n0 = sargs->n0; nf = sargs->nf;
+		sscanf(line + offset, "%d %d", &n0, &nf);
+
+		// Validated here, since invalid arguments would end the server
+		if(n0 <= 2 || n0 >= state->img->n || nf < 2 || nf >= n0)
+		{
+			printf("err Invalid N0 = %d and Nf = %d\n", n0, nf);
+			iftDestroySICLEArgs(&sargs); return;
+		}
+		sargs->n0 = n0; sargs->nf = nf;
+
+		clearSegmentation(state);
+		state->hier = iftRunHierarchicalSICLE(state->sicle, sargs);
+		setLabels(state, iftGetSICLEHierarchyScale(state->hier, 
+																							 state->hier->num_scales - 1));
+		state->is_forest = true;
+		printf("ok %d %d\n", state->hier->num_scales, 
+					 iftMaximumValue(state->labels));
+		iftDestroySICLEArgs(&sargs);
+	}
+	else if(state->hier == NULL) { printf("err No segmentation was run\n"); }
+	else if(iftCompareStrings(cmd, "scale"))
+	{
+		int k;
+
+		if(sscanf(line + offset, "%d", &k) != 1 || k < 0 || 
+			 k >= state->hier->num_scales)
+		{ printf("err Invalid scale\n"); return; }
+
+		setLabels(state, iftGetSICLEHierarchyScale(state->hier, k));
+		state->is_forest = false;
+		printf("ok %d\n", iftMaximumValue(state->labels));
+	}
+	else if(iftCompareStrings(cmd, "reseg"))
+	{
+		int k, label, max_label, num_labels;
+		bool *is_used;
+		iftVoxel vxl;
+		iftImage *labels, *scale;
+
+		k = iftMin(4, state->hier->num_scales - 1); vxl.z = 0;
+		if(sscanf(line + offset, "%d %d %d", &(vxl.x), &(vxl.y), &k) < 2 ||
+			 !iftValidVoxel(state->img, vxl) || k < 0 || 
+			 k >= state->hier->num_scales)
+		{ printf("err Invalid coordinates or scale\n"); return; }
+
+		// Finest superpixels within the k-th scale's superpixel at (x,y)
+		scale = iftGetSICLEHierarchyScale(state->hier, k);
+		label = iftImgVoxelVal(scale, vxl);
+		labels = iftCreateImage(state->img->xsize, state->img->ysize, 1);
+		for(int p_idx = 0; p_idx < labels->n; ++p_idx)
+		{
+			if(scale->val[p_idx] == label)
+			{ labels->val[p_idx] = state->hier->finest->val[p_idx]; }
+		}
+		iftDestroyImage(&scale);
+		setLabels(state, labels);
+		state->is_forest = false;
+
+		max_label = iftMaximumValue(labels);
+		is_used = calloc(max_label + 1, sizeof(bool));
+		assert(is_used != NULL);
+		for(int p_idx = 0; p_idx < labels->n; ++p_idx)
+		{ is_used[labels->val[p_idx]] = true; }
+
+		num_labels = 0;
+		for(int l = 1; l <= max_label; ++l) { num_labels += is_used[l]; }
+		free(is_used);
+		printf("ok %d\n", num_labels);
+	}
+	else if(iftCompareStrings(cmd, "seed")) { editSeed(state, line + offset); }
+	else if(iftCompareStrings(cmd, "labels")) { writeLabels(state); }
+	else if(iftCompareStrings(cmd, "overlay"))
+	{
+		float r, g, b;
+
+		r = g = b = 0.0;
+		sscanf(line + offset, "%f %f %f", &r, &g, &b);
+		if(r < 0 || r > 1 || g < 0 || g > 1 || b < 0 || b > 1)
+		{ printf("err Border color must be within [0,1]\n"); return; }
+		writeOverlay(state, r, g, b);
+	}
+	else { printf("err Unknown request: %s\n", cmd); }
+}
+
+void clearSegmentation
+(ServerState *state)
+{
+	if(state->hier != NULL) { iftDestroySICLEHierarchy(&(state->hier)); }
+	if(state->labels != NULL) { iftDestroyImage(&(state->labels)); }
+}
+
+void editSeed
+(ServerState *state, char *line)
+{
+	char op[IFT_STR_DEFAULT_SIZE];
+	int num_read;
+	bool is_seed, is_valid;
+	iftVoxel src, dst;
+	iftIntArray *seeds;
+	iftBoundingBox bb;
+
+	if(state->is_forest == false)
+	{ printf("err Seeds can only be edited after segment\n"); return; }
+
+	src.z = dst.z = 0;
+	num_read = sscanf(line, "%s %d %d %d %d", op, &(src.x), &(src.y), 
+										&(dst.x), &(dst.y));
+	if(iftCompareStrings(op, "add") || iftCompareStrings(op, "remove"))
+	{ dst = src; num_read += 2; }
+	if(num_read != 5 || !iftValidVoxel(state->img, src) || 
+		 !iftValidVoxel(state->img, dst))
+	{ printf("err Invalid seed request or coordinates\n"); return; }
+
+	// Validated here, since invalid edits would end the server
+	seeds = iftGetSICLESeeds(state->sicle);
+	is_seed = false;
+	for(int i = 0; i < seeds->n; ++i)
+	{ is_seed = is_seed || seeds->val[i] == iftGetVoxelIndex(state->img, dst); }
+
+	is_valid = false;
+	if(iftCompareStrings(op, "add"))
+	{
+		if(is_seed) { printf("err Spel is already a seed\n"); }
+		else
+		{
+			bb = iftAddSICLESeed(state->sicle, NULL, dst, state->labels);
+			is_valid = true;
+		}
+	}
+	else if(iftCompareStrings(op, "remove"))
+	{
+		if(seeds->n <= 1) { printf("err The last seed cannot be removed\n"); }
+		else
+		{
+			bb = iftRemoveSICLESeed(state->sicle, NULL, src, state->labels);
+			is_valid = true;
+		}
+	}
+	else if(iftCompareStrings(op, "move"))
+	{
+		if(is_seed && iftImgVoxelVal(state->labels, src) != 
+									iftImgVoxelVal(state->labels, dst)) // Another's seed?
+		{ printf("err Spel is already a seed\n"); }
+		else 
+		{
+			bb = iftMoveSICLESeed(state->sicle, NULL, src, dst, state->labels);
+			is_valid = true;
+		}
+	}
+	else { printf("err Unknown seed edition: %s\n", op); }
+
+	if(is_valid)
+	{ printf("ok %d %d %d %d\n", bb.begin.x, bb.begin.y, bb.end.x, bb.end.y); }
+	iftDestroyIntArray(&seeds);
+}
+
+void setLabels
+(ServerState *state, iftImage *labels)
+{
+	if(state->labels != NULL) { iftDestroyImage(&(state->labels)); }
+	state->labels = labels;
+}
+
+void writeLabels
+(ServerState *state)
+{
+	size_t nbytes;
+
+	nbytes = state->labels->n * sizeof(int);
+	printf("ok %d %d %lu\n", state->labels->xsize, state->labels->ysize, 
+				 (unsigned long)nbytes);
+	fwrite(state->labels->val, sizeof(int), state->labels->n, stdout);
+}
+
+void writeOverlay
+(ServerState *state, float r, float g, float b)
+{
+	int norm_val;
+	uchar *rgb;
+	iftAdjRel *A;
+	iftImage *img;
+
+	img = state->img;
+	A = iftCircular(1.0);
+	norm_val = iftMaxImageRange(iftImageDepth(img));
+	rgb = iftAllocUCharArray(3 * img->n);
+
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int p_idx = 0; p_idx < img->n; ++p_idx)
+	{
+		bool is_border;
+		iftVoxel p_vxl;
+
+		is_border = false;
+		p_vxl = iftGetVoxelCoord(img, p_idx);
+		for(int i = 1; !is_border && i < A->n; ++i)
+		{
+			iftVoxel q_vxl;
+
+			q_vxl = iftGetAdjacentVoxel(A, p_vxl, i);
+			if(iftValidVoxel(img, q_vxl) && state->labels->val[p_idx] !=
+				 state->labels->val[iftGetVoxelIndex(img, q_vxl)])
+			{ is_border = true; }
+		}
+
+		if(is_border)
+		{
+			rgb[3 * p_idx] = iftRound(r * 255);
+			rgb[3 * p_idx + 1] = iftRound(g * 255);
+			rgb[3 * p_idx + 2] = iftRound(b * 255);
+		}
+		else if(iftIsColorImage(img))
+		{
+			iftColor YCbCr, RGB;
+
+			YCbCr.val[0] = img->val[p_idx];
+			YCbCr.val[1] = img->Cb[p_idx]; YCbCr.val[2] = img->Cr[p_idx];
+			RGB = iftYCbCrtoRGB(YCbCr, norm_val);
+			for(int c = 0; c < 3; ++c)
+			{
+				rgb[3 * p_idx + c] = iftMin(norm_val, iftMax(0, RGB.val[c])) * 255L /
+														 norm_val;
+			}
+		}
+		else
+		{
+			for(int c = 0; c < 3; ++c)
+			{ rgb[3 * p_idx + c] = (long)img->val[p_idx] * 255 / norm_val; }
+		}
+	}
+	iftDestroyAdjRel(&A);
+
+	printf("ok %d %d %d\n", img->xsize, img->ysize, 3 * img->n);
+	fwrite(rgb, sizeof(uchar), 3 * img->n, stdout);
+	iftFree(rgb);
+}
+
+void usage()
+{
+	const int SKIP_IND = 15; // For indentation purposes
+	printf("\nReads one request per line from stdin and answers on stdout:\n");
+	printf("%-*s %s\n", SKIP_IND, "load",
+		"<path>: Decodes the image and creates its SICLE prototype");
+	printf("%-*s %s\n", SKIP_IND, "segment",
+		"[<n0> [<nf>]]: Runs a multiscale SICLE. Default: 3000 200");
+	printf("%-*s %s\n", SKIP_IND, "scale",
+		"<k>: Selects the labels of the k-th scale, from the finest");
+	printf("%-*s %s\n", SKIP_IND, "reseg",
+		"<x> <y> [<k>]: Finest labels within the k-th scale's superpixel");
+	printf("%-*s %s\n", SKIP_IND, "seed",
+		"add|remove <x> <y> or move <x> <y> <x'> <y'>: Edits the last scale's seeds");
+	printf("%-*s %s\n", SKIP_IND, "labels",
+		"Sends the current labels (native-endian int32)");
+	printf("%-*s %s\n", SKIP_IND, "overlay",
+		"<r> <g> <b>: Sends the image (8-bit RGB) with the borders overlayed");
+	printf("%-*s %s\n", SKIP_IND, "quit",
+		"Ends the server");
+
+	printf("\nOptional parameters:\n");
+	printf("%-*s %s\n", SKIP_IND, "--help",
+		"Prints this message");
+
+	printf("\n");
+}
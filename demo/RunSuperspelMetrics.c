@@ -13,6 +13,8 @@
 void usage();
 void readImgInputs
 (const iftArgs *args, iftImage **label_img,  iftImage **img, iftImage **gt_img);
+void appendMetric
+(char *out_str, const char *name, float val, bool as_csv);
 
 int main(int argc, char const *argv[])
 {
@@ -33,9 +35,10 @@ int main(int argc, char const *argv[])
   }
   //-------------------------------------------------------------------------//
   bool as_csv;
-  int min_label, max_label, num_labels;
+  int min_label, max_label, num_labels, metrics;
   char out_str[IFT_STR_DEFAULT_SIZE], tmp_str[IFT_STR_DEFAULT_SIZE];
   iftImage *label_img, *img, *gt_img;
+  iftSuperspelMetrics res;
 
   readImgInputs(args, &label_img, &img, &gt_img);
 
@@ -52,72 +55,35 @@ int main(int argc, char const *argv[])
   else sprintf(tmp_str, "%d", num_labels);
   strcat(out_str, tmp_str);
 
-	if(iftExistArg(args, "all") || iftExistArg(args, "asa"))
-	{
-		float asa = iftEvalASA(label_img, gt_img);
-		if(!as_csv){ sprintf(tmp_str, "ASA(+): %.3f\n", asa);  }
-		else { sprintf(tmp_str, ",%f", asa); }
-		strcat(out_str, tmp_str);
-	}
-
-	if(iftExistArg(args, "all") || iftExistArg(args, "br"))
-	{
-		float br = iftEvalBR(label_img, gt_img);
-		if(!as_csv){ sprintf(tmp_str, "BR(+): %.3f\n", br);  }
-		else { sprintf(tmp_str, ",%f", br); }
-		strcat(out_str, tmp_str);
-	}
-
-	if(iftExistArg(args, "all") || iftExistArg(args, "cd"))
-	{
-		float cd = iftEvalCD(label_img);
-		if(!as_csv){ sprintf(tmp_str, "CD(-): %.3f\n", cd);  }
-		else { sprintf(tmp_str, ",%f", cd); }
-		strcat(out_str, tmp_str);
-	}
-  
-	if(iftExistArg(args, "all") || iftExistArg(args, "co"))
-	{
-		float co = iftEvalCO(label_img);
-		if(!as_csv){ sprintf(tmp_str, "CO(+): %.3f\n", co);  }
-		else { sprintf(tmp_str, ",%f", co); }
-		strcat(out_str, tmp_str);
-	}
-
-	if(iftExistArg(args, "all") || iftExistArg(args, "ev"))
-	{
-		float ev = iftEvalEV(label_img, img);
-		if(!as_csv){ sprintf(tmp_str, "EV(+): %.3f\n", ev);  }
-		else { sprintf(tmp_str, ",%f", ev); }
-		strcat(out_str, tmp_str);
-	}
-
-	if(iftExistArg(args, "all") || iftExistArg(args, "tex"))
-	{
-		float tex = iftEvalTEX(label_img);
-		if(!as_csv){ sprintf(tmp_str, "TEX(+): %.3f\n", tex);  }
-		else { sprintf(tmp_str, ",%f", tex); }
-		strcat(out_str, tmp_str);
-	}
-
-	if(iftExistArg(args, "all") || iftExistArg(args, "ue"))
-	{
-		float ue = iftEvalUE(label_img, gt_img);
-		if(!as_csv){ sprintf(tmp_str, "UE(-): %.3f\n", ue);  }
-		else { sprintf(tmp_str, ",%f", ue); }
-		strcat(out_str, tmp_str);
-	}
-       if(iftExistArg(args, "all") || iftExistArg(args, "dice"))
-	{      
-              // int min = IFT_INFINITY_INT;
-              // int max = IFT_INFINITY_INT_NEG;
-              // iftMinMaxValues(gt_img, &min, &max);
-              // printf("Min %d Max %d\n",min, max);
-		float dice = iftEvalDICE(label_img, gt_img, 255);
-		if(!as_csv){ sprintf(tmp_str, "DICE(-): %.3f\n", dice);  }
-		else { sprintf(tmp_str, ",%f", dice); }
-		strcat(out_str, tmp_str);
-	}
+  metrics = 0;
+  if(iftExistArg(args, "all")) { metrics = IFT_METRICS_ALL; }
+  if(iftExistArg(args, "asa")) { metrics |= IFT_METRICS_ASA; }
+  if(iftExistArg(args, "br")) { metrics |= IFT_METRICS_BR; }
+  if(iftExistArg(args, "cd")) { metrics |= IFT_METRICS_CD; }
+  if(iftExistArg(args, "co")) { metrics |= IFT_METRICS_CO; }
+  if(iftExistArg(args, "ev")) { metrics |= IFT_METRICS_EV; }
+  if(iftExistArg(args, "tex")) { metrics |= IFT_METRICS_TEX; }
+  if(iftExistArg(args, "ue")) { metrics |= IFT_METRICS_UE; }
+  if(iftExistArg(args, "dice")) { metrics |= IFT_METRICS_DICE; }
+
+  // Every requested metric within a single sweep
+  res = iftEvalSuperspelMetrics(label_img, img, gt_img, metrics, 255);
+  if(metrics & IFT_METRICS_ASA) 
+  { appendMetric(out_str, "ASA(+)", res.asa, as_csv); }
+  if(metrics & IFT_METRICS_BR) 
+  { appendMetric(out_str, "BR(+)", res.br, as_csv); }
+  if(metrics & IFT_METRICS_CD) 
+  { appendMetric(out_str, "CD(-)", res.cd, as_csv); }
+  if(metrics & IFT_METRICS_CO) 
+  { appendMetric(out_str, "CO(+)", res.co, as_csv); }
+  if(metrics & IFT_METRICS_EV) 
+  { appendMetric(out_str, "EV(+)", res.ev, as_csv); }
+  if(metrics & IFT_METRICS_TEX) 
+  { appendMetric(out_str, "TEX(+)", res.tex, as_csv); }
+  if(metrics & IFT_METRICS_UE) 
+  { appendMetric(out_str, "UE(-)", res.ue, as_csv); }
+  if(metrics & IFT_METRICS_DICE) 
+  { appendMetric(out_str, "DICE(-)", res.dice, as_csv); }
 
   iftDestroyArgs(&args);
   iftDestroyImage(&label_img);
@@ -168,6 +134,16 @@ void usage()
   printf("\n");
 }
 
+void appendMetric
+(char *out_str, const char *name, float val, bool as_csv)
+{
+  char tmp_str[IFT_STR_DEFAULT_SIZE];
+
+  if(!as_csv){ sprintf(tmp_str, "%s: %.3f\n", name, val);  }
+  else { sprintf(tmp_str, ",%f", val); }
+  strcat(out_str, tmp_str);
+}
+
 void readImgInputs
 (const iftArgs *args, iftImage **label_img,  iftImage **img, iftImage **gt_img)
 {
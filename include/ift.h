@@ -324,6 +324,37 @@ void      iftGoDownDHeap(iftDHeap *H, int i);
 void      iftResetDHeap(iftDHeap *H);
 
 // ---------- iftDHeap.h end
+// ---------- iftBQueue.h start
+
+/* 
+ * Two-level bucket queue for non-negative double priorities quantized into
+ * nbuckets levels within [0,maxvalue], with those above maxvalue in the last
+ * bucket. The bucket being removed (and any lower insertion) is moved into a
+ * binary heap, so elements are removed in exact priority order.
+ */
+typedef struct ift_bqueue {
+    double *value;
+    double  scale;
+    char   *color;
+    int    *next;
+    int    *prev;
+    iftDHeap *active; // Elements of the buckets up to actbucket
+    int     actbucket;
+    int     minbucket;
+    int     nbuckets;
+    int     nelems;
+    int     n;
+} iftBQueue;
+
+iftBQueue *iftCreateBQueue(int n, int nbuckets, double maxvalue, double *value);
+void       iftDestroyBQueue(iftBQueue **Q);
+char       iftEmptyBQueue(iftBQueue *Q);
+void       iftInsertBQueue(iftBQueue *Q, int elem);
+int        iftRemoveBQueue(iftBQueue *Q);
+void       iftRemoveBQueueElem(iftBQueue *Q, int elem);
+void       iftResetBQueue(iftBQueue *Q);
+
+// ---------- iftBQueue.h end
 // ---------- iftFile.h start
 
 #if defined(__WIN32) || defined(__WIN64)
@@ -376,6 +407,9 @@ void iftDestroyBMap(iftBMap **bmap);
 inline void iftBMapSet1(iftBMap *bmap, int b) {
     bmap->val[b >> 3] |= (1 << (b & 0x07));
 }
+inline void iftBMapSet0(iftBMap *bmap, int b) {
+    bmap->val[b >> 3] &= ~(1 << (b & 0x07));
+}
 inline bool iftBMapValue(const iftBMap *bmap, int b) {
     return ((bmap->val[b >> 3] & (1 << (b & 0x07))) != 0);
 }
@@ -411,10 +445,14 @@ typedef struct ift_image {
     float dz;
     int *tby, *tbz;
     int n;
+    size_t mapped_size; // Bytes of val within a scratch file (0 if none)
 } iftImage;
 
 iftImage *iftReadImageByExt(const char *filename, ...);
 iftImage *iftCreateImage(int xsize, int ysize, int zsize);
+/* Same as iftCreateImage, but val is mapped from a scratch file */
+iftImage *iftCreateMappedImage(int xsize, int ysize, int zsize, 
+                               const char *scratch_dir);
 iftImage *iftCopyImage(const iftImage *img);
 void iftDestroyImage(iftImage **img);
 void iftWriteImageByExt(const iftImage *img, const char *filename, ...);
@@ -491,11 +529,15 @@ typedef struct ift_mimage {
     float dx,dy,dz; 
     int *tby, *tbz;
     int n,m;
+    size_t mapped_size; // Bytes of val and data within a scratch file (0 if none)
 } iftMImage;
 
 #define iftMGetVoxelIndex(s,v) ((v.x)+(s)->tby[(v.y)]+(s)->tbz[(v.z)])
 
 iftMImage  *iftCreateMImage(int xsize,int ysize,int zsize, int nbands);
+/* Same as iftCreateMImage, but val and data are mapped from a scratch file */
+iftMImage  *iftCreateMappedMImage(int xsize,int ysize,int zsize, int nbands,
+                                  const char *scratch_dir);
 void iftDestroyMImage(iftMImage **img);
 iftMImage *iftImageToMImage(const iftImage *img, char color_space);
 iftImage *iftMImageToImage(const iftMImage *img, int Imax, int band);
@@ -505,6 +547,7 @@ static inline bool iftIs3DMImage(const iftMImage *img) {
 iftVoxel    iftMGetVoxelCoord(const iftMImage *img, int p);
 char iftMValidVoxel(const iftMImage *img, iftVoxel v);
 float iftMMaximumValue(const iftMImage *img, int band);
+float *iftMImageToAlignedArray(const iftMImage *img, int lanes);
 
 // ---------- iftMImage.h end
 // ---------- iftKernel.h start
@@ -610,6 +653,14 @@ static inline void iftFree(void *data) {
 }
 
 char *iftGetLine(FILE *stream) ;
+
+/*
+ * Maps an anonymous scratch file of the given size, created (and 
+ * immediately unlinked) within the directory provided. Its pages are zeroed
+ * and backed by the file, so the kernel may evict them instead of swapping.
+ */
+void *iftMapScratchFile(const char *dir, size_t size);
+void iftUnmapScratchFile(void *ptr, size_t size);
 // ---------- iftStream.h end
 // ---------- iftString.h start 
 
@@ -674,6 +725,33 @@ iftImage* iftReadVideoFolderAsVolume(const char* folder_name, int start_frame, i
 
 iftImage* iftReadImageFolderAsVolume(const char* folder_name);
 
+/*
+ * Reads the slices within the folder, one at a time, straight into a 
+ * multiband volume mapped from a scratch file within scratch_dir. Colored 
+ * slices are converted to color_space (LAB_CSPACE or GRAY_CSPACE), while 
+ * grayscale ones yield a single band. Colored volumes are read twice, since
+ * the conversion is normalized by the volume's maximum value.
+ */
+iftMImage *iftReadImageFolderAsMappedMImage(const char *folder_name,
+                                            char color_space,
+                                            const char *scratch_dir);
+
+/*
+ * Reads the domain of a 2D image from the header of a binary PNM (P5/P6) or 
+ * non-interlaced PNG file. Other formats cannot be read by regions (see 
+ * iftReadImageRegion), so they are rejected.
+ */
+iftImageDomain iftReadImageDomain(const char *filename);
+
+/*
+ * Reads the region of a 2D image within the (inclusive) bounding box, which 
+ * is clipped to the image's domain, without decoding the whole image. Binary
+ * 8- or 16-bit PNM (P5/P6) files are read row by row from the region's 
+ * offsets, whereas non-interlaced PNG files are decoded row by row up to the 
+ * region's last one. Other formats are rejected.
+ */
+iftImage *iftReadImageRegion(const char *filename, iftBoundingBox bb);
+
 void iftWriteVolumeAsVideoFolder(iftImage *video, const char *folder_name, char *frame_name);
 
 void iftConvertVideoFileToVideoFolder(const char *video_path, const char *output_folder, int rotate);
@@ -744,6 +822,31 @@ inline float iftEuclDistance
   return sqrtf(dist);
 }
 
+#if defined(IFT_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+
+/*
+ * Computes the euclidean distances between u and four vectors at once, all of
+ * them 16-byte aligned and padded to 4 lanes (see iftMImageToAlignedArray).
+ * The squared differences are summed in the same order as iftEuclDistance.
+ */
+static inline __m128 iftEuclDistance4x4
+(const float *u, const float *v0, const float *v1, const float *v2,
+ const float *v3)
+{
+  __m128 r, d0, d1, d2, d3;
+
+  r = _mm_load_ps(u);
+  d0 = _mm_sub_ps(r, _mm_load_ps(v0)); d0 = _mm_mul_ps(d0, d0);
+  d1 = _mm_sub_ps(r, _mm_load_ps(v1)); d1 = _mm_mul_ps(d1, d1);
+  d2 = _mm_sub_ps(r, _mm_load_ps(v2)); d2 = _mm_mul_ps(d2, d2);
+  d3 = _mm_sub_ps(r, _mm_load_ps(v3)); d3 = _mm_mul_ps(d3, d3);
+  _MM_TRANSPOSE4_PS(d0, d1, d2, d3); // Lane k now holds the k-th vector
+
+  return _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(d0, d1), d2), d3));
+}
+#endif
+
 inline float iftFastNatPow
 (float base, int exp)
 {
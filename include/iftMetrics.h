@@ -15,6 +15,30 @@ extern "C" {
 
 #include "ift.h"
 
+//############################################################################|
+// 
+//	STRUCTS, ENUMS, UNIONS & TYPEDEFS
+//
+//############################################################################|
+typedef enum ift_metrics_opt
+{
+  IFT_METRICS_ASA = 1 << 0, // Achievable segmentation accuracy. GT needed
+  IFT_METRICS_BR = 1 << 1, // Boundary recall. GT needed
+  IFT_METRICS_CD = 1 << 2, // Contour density
+  IFT_METRICS_CO = 1 << 3, // Compactness
+  IFT_METRICS_EV = 1 << 4, // Explained variation. Original image needed
+  IFT_METRICS_TEX = 1 << 5, // Temporal extension
+  IFT_METRICS_UE = 1 << 6, // Under-segmentation error. GT needed
+  IFT_METRICS_DICE = 1 << 7, // Dice coefficient. GT needed
+  IFT_METRICS_ALL = (1 << 8) - 1, // Every metric above
+} iftMetricsOpt;
+
+typedef struct ift_superspel_metrics
+{
+  int num_labels; // Number of superspels (i.e., of the label range)
+  float asa, br, cd, co, ev, tex, ue, dice; // Requested metrics. NaN otherwise
+} iftSuperspelMetrics;
+
 //############################################################################|
 // 
 //	PUBLIC METHODS
@@ -176,6 +200,28 @@ float iftEvalDICE
 float iftEvalUE
 (iftImage *label_img, iftImage *gt_img);
 
+//============================================================================|
+// Fused
+//============================================================================|
+/*
+ * Evaluates any subset of the metrics above within a single parallel sweep 
+ * over the label image, which shares its neighborhoods, per-superspel 
+ * moments and label-GT intersections among the metrics. Its values equal 
+ * those of the individual functions, except for rounding.
+ *
+ * PARAMETERS:
+ * 	label_img[in] - REQUIRED: Superspel segmentation
+ * 	orig_img[in] - OPTIONAL: Original image. Required by EV
+ * 	gt_img[in] - OPTIONAL: Ground-truth. Required by ASA, BR, UE and DICE
+ * 	metrics[in] - REQUIRED: Requested metrics (i.e., iftMetricsOpt flags)
+ * 	obj_label[in] - OPTIONAL: Object's ground-truth label. DICE only
+ *
+ * RETURNS: Requested metrics' values
+ */
+iftSuperspelMetrics iftEvalSuperspelMetrics
+(iftImage *label_img, iftImage *orig_img, iftImage *gt_img, int metrics,
+ int obj_label);
+
 #ifdef __cplusplus
 }
 #endif
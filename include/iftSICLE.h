@@ -57,13 +57,17 @@ typedef struct ift_sicle_args
 {
 	bool use_diag; // Flag: use 8- or 26-neighborhood. Default: true
   bool use_dift; // Flag: use differential computation. Default: true
+  bool use_bqueue; // Flag: use a bucket queue (Fmax only). Default: false
 	int n0; // Initial quantity of seeds. Default: 3000
 	int nf; // Final quantity of superspels. Default: 200
 	int max_iters; // Maximum number of iterations for segmentation. Default: 5
 	int adhr; // Fsum: Boundary adherence factor. Default: 12
+  int num_buckets; // Bucket queue: Cost quantization levels. Default: 65536
+  int tile_size; // Partitioned IFT: Tile's side length (0 = off). Default: 0
   float irreg; // Fsum: Irregularity factor. Default: 0.12
   float alpha; // Saliency information importance. Default: 0
   iftIntArray *user_ni; // User-defined intermediary quantity of seeds.
+  iftIntArray *nf_targets; // Required quantities of superspels, within [Nf,N0[
   iftSICLESampl samplopt; // Option: Seed oversampling option: Default RND
 	iftSICLEConn connopt; // Option: IFT connectivity function. Default: FMAX
 	iftSICLECrit critopt; // Option: Seed removal criterion. Default: MINSC
@@ -72,6 +76,33 @@ typedef struct ift_sicle_args
 
 typedef struct ift_sicle_alg iftSICLE;
 
+// Receives a finalized frame of a streamed segmentation, which is free'd after
+// the call, its index within the video and the user's data
+typedef void (*iftSICLEFrameFunc)
+(iftImage *label_frame, int frame_id, void *user_data);
+
+// Receives a finalized tile of a tiled segmentation, which is free'd after 
+// the call, the coordinates of its upper-left pixel and the user's data
+typedef void (*iftSICLETileFunc)
+(iftImage *label_tile, int x0, int y0, void *user_data);
+
+// Multiscale segmentation kept as its finest label image and, for each 
+// coarser scale, the labels of the finest superspels along with the spels 
+// whose labels differ from theirs (i.e., the scales are mostly nested)
+typedef struct ift_sicle_hierarchy
+{
+	int num_scales; // Number of scales, from the first iteration to the last
+	iftImage *finest; // Label image of the first scale
+	iftIntArray **parent; // Scale's label of each finest label. NULL at 0
+	iftIntArray **exc_index; // Scale's spels not labeled as their parents
+	iftIntArray **exc_label; // Scale's labels of such spels
+} iftSICLEHierarchy;
+
+// Receives a finalized scale of a multiscale segmentation, which is free'd 
+// after the call, its index (from the finest) and the user's data
+typedef void (*iftSICLEScaleFunc)
+(iftImage *label_img, int scale, void *user_data);
+
 //############################################################################|
 // 
 //	PUBLIC METHODS
@@ -101,6 +132,46 @@ iftSICLEArgs *iftCreateSICLEArgs();
 iftSICLE *iftCreateSICLE
 (iftImage *img, iftImage *objsm, iftImage *mask);
 
+/*
+ * Creates an out-of-core instance from the spel features provided, whose
+ * ownership is taken by the prototype (e.g., a volume read through 
+ * iftReadImageFolderAsMappedMImage). Every spel-wise buffer of the
+ * executions (saliency, IFT maps, queue, stacks and the output label images)
+ * is mapped from unlinked scratch files within the directory given, so
+ * volumes larger than the memory are paged by the kernel. Only bit-maps
+ * (region of interest, borders and tracked spels) are kept in memory, at
+ * most 4 bits per voxel. Since spels are indexed by int, volumes must have
+ * at most INT_MAX voxels. A tiled execution (i.e., tile_size > 0) is advised,
+ * since it conquers the volume block by block along the slices. The bucket
+ * queue is unavailable. You may free the maps after the creation.
+ *
+ * PARAMETERS:
+ *	mimg[in] - REQUIRED: Spel features. Free'd along with the prototype
+ *	objsm[in] - OPTIONAL: Grayscale object saliency map
+ *	mask[in] - OPTIONAL: Binary mask indication the region of interest
+ *	scratch_dir[in] - REQUIRED: Existing directory for the scratch files
+ *
+ * RETURNS: SICLE prototype
+ */
+iftSICLE *iftCreateMappedSICLE
+(iftMImage *mimg, iftImage *objsm, iftImage *mask, const char *scratch_dir);
+
+/*
+ * Replaces the input images of the SICLE prototype provided, keeping its
+ * buffers and its IFT workspace for the next executions. Thus, segmenting a
+ * sequence of same-sized images avoids most reallocations. Since the 
+ * workspace is owned by the prototype, it must not be run concurrently by
+ * multiple threads. You may free the inputs after the update.
+ *
+ * PARAMETERS:
+ *	sicle[in/out] - REQUIRED: SICLE prototype to be updated
+ *	img[in] - REQUIRED: Original image with the prototype's domain
+ *	objsm[in] - OPTIONAL: Grayscale object saliency map
+ *	mask[in] - OPTIONAL: Binary mask indication the region of interest
+ */
+void iftUpdateSICLE
+(iftSICLE *sicle, iftImage *img, iftImage *objsm, iftImage *mask);
+
 /*
  * Deallocates the respective object 
  *
@@ -133,6 +204,9 @@ void iftDestroySICLE
  *  5) Adherence (Fsum) >= 0 ;
  *  6) Alpha >= 0 ;
  *  7) Penalization should be none when no saliency is provided ;
+ *  8) Bucket queue requires Fmax, at least 2 buckets, no IFT_COMPACT and an
+ *     in-memory prototype ;
+ *  9) Tile size >= 0 ;
  * 
  * PARAMETERS
  * 	sicle[in] - REQUIRED: SICLE prototype
@@ -173,6 +247,270 @@ iftImage *iftRunSICLE
 iftImage **iftRunMultiscaleSICLE
 (iftSICLE *sicle, iftSICLEArgs *args, int *num_scales);
 
+/*
+ * Runs the SICLE algorithm as iftRunMultiscaleSICLE, but emits every scale as
+ * soon as its forest is finalized, instead of keeping them all. If in 
+ * parallel, the scales are emitted by a writer thread, which overlaps with
+ * the next iterations, and at most one label image is kept at a time (i.e.,
+ * the next scale waits for the previous one's emission). Then, the receiver 
+ * must not call this prototype, and the calls are ordered by scale.
+ * 
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE prototype
+ *  args[in] - OPTIONAL: SICLE arguments
+ *  in_parallel[in] - REQUIRED: Whether a writer thread emits the scales
+ *  emit[in] - REQUIRED: Receiver of every finalized scale
+ *  user_data[in] - OPTIONAL: User's data given to the receiver
+ *
+ * RETURNS: Number of scales emitted
+ */
+int iftRunEmittedMultiscaleSICLE
+(iftSICLE *sicle, iftSICLEArgs *args, bool in_parallel, 
+ iftSICLEScaleFunc emit, void *user_data);
+
+/*
+ * Runs the SICLE algorithm once for several quantities of superspels. The Nf
+ * targets of the arguments are spliced into the Ni schedule, and the 
+ * segmentation of each one is kept, while the others are skipped. Thus, its
+ * cost is close to a single run to Nf.
+ * 
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE prototype
+ *  args[in] - REQUIRED: SICLE arguments, with the Nf targets
+ *
+ * RETURNS: Superspel segmentations ordered as the Nf targets, whose labels 
+ *          are within [1,target] or [0,target] if a mask was provided.
+ */
+iftImage **iftRunMultiTargetSICLE
+(iftSICLE *sicle, iftSICLEArgs *args);
+
+/*
+ * Runs the SICLE algorithm over overlapping sliding windows of a video's
+ * frames, such that only the frames within the current window are kept in
+ * memory. Each window is segmented as a volume whose oversampled seeds include
+ * a seed per superspel of the last window within the shared frames, which is 
+ * never removed. Then, its labels inherit the global labels they most overlap 
+ * with in those frames, which keep their previous labels, and the frame right
+ * after them is re-conquered from both sides. Finally, the frames not shared 
+ * with the next window are emitted. Thus, the output starts
+ * before the whole video is read, and its labels are unique across the video,
+ * but not necessarily consecutive. The last window is shifted back for keeping its
+ * size, whereas a window larger than the video covers it entirely.
+ * 
+ * PARAMETERS:
+ *  frames[in] - REQUIRED: Paths of the video's frames, in temporal order
+ *  args[in] - OPTIONAL: SICLE arguments applied for each window
+ *  window_size[in] - REQUIRED: Number of frames per window (>= 1)
+ *  overlap[in] - REQUIRED: Frames shared by consecutive windows, [0,window_size[
+ *  emit[in] - REQUIRED: Callback receiving each finalized frame
+ *  user_data[in] - OPTIONAL: Data passed to the callback
+ */
+void iftRunStreamingSICLE
+(const iftFileSet *frames, iftSICLEArgs *args, int window_size, int overlap,
+ iftSICLEFrameFunc emit, void *user_data);
+
+/*
+ * Runs the SICLE algorithm over overlapping tiles of a 2D image too large to
+ * be loaded, such that only the tiles being processed are kept in memory. 
+ * Each tile is read from the file (see iftReadImageRegion) expanded by the
+ * overlap on every side and segmented independently, optionally in parallel.
+ * Then, in raster order, its labels inherit the global labels they most 
+ * overlap with in its finalized (left and upper) neighbors, and its band
+ * next to them is re-conquered by an IFT seeded at the seams. Finally, its
+ * tile (i.e., without the overlap) is emitted. Its labels are unique across
+ * the image, but not necessarily consecutive. A tile too small for SICLE
+ * (i.e., with fewer than 4 spels) is a single superspel, which inherits the
+ * label of its neighbors, if overlapping. Be aware that random seed sampling
+ * is not reproducible when tiles are processed in parallel.
+ * 
+ * PARAMETERS:
+ *  img_path[in] - REQUIRED: Path of the 2D image
+ *  args[in] - OPTIONAL: SICLE arguments. N0 and Nf are applied per tile 
+ *             (clamped to its size) if no global quantity is given
+ *  tile_size[in] - REQUIRED: Tile's side length (>= 2)
+ *  overlap[in] - REQUIRED: Tile's expansion on each side, [0,tile_size[
+ *  global_nf[in] - REQUIRED: Quantity of superspels in the image, which is
+ *                  distributed according to the tiles' sizes (0 = per tile)
+ *  in_parallel[in] - REQUIRED: Whether tiles are segmented in parallel
+ *  emit[in] - REQUIRED: Callback receiving each finalized tile
+ *  user_data[in] - OPTIONAL: Data passed to the callback
+ */
+void iftRunTiledSICLE
+(const char *img_path, iftSICLEArgs *args, int tile_size, int overlap,
+ int global_nf, bool in_parallel, iftSICLETileFunc emit, void *user_data);
+
+//============================================================================|
+// Hierarchy
+//============================================================================|
+/*
+ * Runs the SICLE algorithm as iftRunMultiscaleSICLE, but keeps only the
+ * finest scale's label image and, for each coarser one, a relabeling table
+ * with its exceptions. Thus, it requires roughly the memory of a single label
+ * image, and any scale may be recovered exactly (see 
+ * iftGetSICLEHierarchyScale).
+ * 
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE prototype
+ *  args[in] - OPTIONAL: SICLE arguments
+ *
+ * RETURNS: Hierarchy of the scales, from the first iteration to the last
+ */
+iftSICLEHierarchy *iftRunHierarchicalSICLE
+(iftSICLE *sicle, iftSICLEArgs *args);
+
+/*
+ * Deallocates the hierarchy's memory
+ * 
+ * PARAMETERS:
+ *  hier[in/out] - REQUIRED: Pointer to the hierarchy to be free'd
+ */
+void iftDestroySICLEHierarchy
+(iftSICLEHierarchy **hier);
+
+/*
+ * Creates the label image of the hierarchy's scale, which is identical to the
+ * one of iftRunMultiscaleSICLE at the same index
+ * 
+ * PARAMETERS:
+ *  hier[in] - REQUIRED: SICLE hierarchy
+ *  scale[in] - REQUIRED: Index of the scale (within [0, num_scales-1])
+ *
+ * RETURNS: Superspel segmentation of the scale
+ */
+iftImage *iftGetSICLEHierarchyScale
+(const iftSICLEHierarchy *hier, int scale);
+
+/*
+ * Writes the hierarchy into a binary file, with a plain-text header followed
+ * by the finest label image and the tables of the coarser scales
+ * 
+ * PARAMETERS:
+ *  hier[in] - REQUIRED: SICLE hierarchy
+ *  path[in] - REQUIRED: Path to the output file
+ */
+void iftWriteSICLEHierarchy
+(const iftSICLEHierarchy *hier, const char *path);
+
+/*
+ * Reads a hierarchy written by iftWriteSICLEHierarchy
+ * 
+ * PARAMETERS:
+ *  path[in] - REQUIRED: Path to the input file
+ *
+ * RETURNS: SICLE hierarchy
+ */
+iftSICLEHierarchy *iftReadSICLEHierarchy
+(const char *path);
+
+//============================================================================|
+// Warm Start
+//============================================================================|
+/*
+ * Runs the SICLE algorithm warm-started from prior seeds, such as the final
+ * ones of the previous frame of a video (see iftGetSICLESeeds and 
+ * iftLabelsToSICLESeeds). The prior seeds are joined with a smaller random 
+ * or grid oversampling (i.e., of num_extra seeds instead of N0), and SICLE
+ * reduces them to Nf. Since there are fewer initial seeds, the early
+ * iterations are skipped, and the ones left are differential (if enabled). 
+ * Then, the prototype should be updated with the new frame beforehand (see
+ * iftUpdateSICLE). If there are fewer than Nf+1 valid seeds, random ones are
+ * added. The intermediary quantities of the arguments are ignored.
+ * 
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE prototype
+ *  args[in] - OPTIONAL: SICLE arguments, whose N0 is ignored
+ *  prior_seeds[in] - OPTIONAL: Spels' indexes of the prior seeds
+ *  num_extra[in] - REQUIRED: Quantity of seeds oversampled besides the prior
+ *                            ones (>= 0)
+ *
+ * RETURNS: Superspel segmentation whose labels are within [1,Nf] or [0,Nf]
+ * 	if a mask was provided.
+ */
+iftImage *iftRunWarmSICLE
+(iftSICLE *sicle, iftSICLEArgs *args, const iftIntArray *prior_seeds, 
+ int num_extra);
+
+/*
+ * Gets one seed per superspel of the label image provided, which is its spel
+ * nearest to its centroid. The background (i.e., label 0) is ignored.
+ * 
+ * PARAMETERS:
+ *  label_img[in] - REQUIRED: Superspel segmentation
+ *
+ * RETURNS: Spels' indexes of the seeds, ordered by their labels
+ */
+iftIntArray *iftLabelsToSICLESeeds
+(iftImage *label_img);
+
+//============================================================================|
+// Seed Edition
+//============================================================================|
+/*
+ * Gets the seeds of the prototype's last segmentation (i.e., the forest of
+ * its last execution or seed edition), as their spels' indexes.
+ * 
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE prototype
+ *
+ * RETURNS: Copy of the seeds, or NULL if there is no segmentation
+ */
+iftIntArray *iftGetSICLESeeds
+(iftSICLE *sicle);
+
+/*
+ * Adds a seed at the voxel provided to the prototype's last segmentation 
+ * (i.e., the forest of its last execution or seed edition), and updates only
+ * the trees affected by it through a differential IFT. Then, the label image
+ * of that segmentation is relabeled in-place within the bounding box
+ * returned, out of which it is unchanged. The new superspel is labeled by the
+ * greatest label plus one, and the others keep their labels.
+ * 
+ * PARAMETERS:
+ *  sicle[in/out] - REQUIRED: SICLE prototype with a segmentation
+ *  args[in] - OPTIONAL: SICLE arguments of the segmentation
+ *  vxl[in] - REQUIRED: Voxel within the region of interest and not a seed
+ *  label_img[in/out] - REQUIRED: Label image of the segmentation
+ *
+ * RETURNS: Bounding box of the spels whose labels may have changed
+ */
+iftBoundingBox iftAddSICLESeed
+(iftSICLE *sicle, iftSICLEArgs *args, iftVoxel vxl, iftImage *label_img);
+
+/*
+ * Removes the seed of the superspel containing the voxel provided from the
+ * prototype's last segmentation (see iftAddSICLESeed), whose spels are 
+ * conquered by the adjacent superspels. The other superspels keep their 
+ * labels, so they may become non-consecutive.
+ * 
+ * PARAMETERS:
+ *  sicle[in/out] - REQUIRED: SICLE prototype with a segmentation
+ *  args[in] - OPTIONAL: SICLE arguments of the segmentation
+ *  vxl[in] - REQUIRED: Voxel within the superspel to be removed
+ *  label_img[in/out] - REQUIRED: Label image of the segmentation
+ *
+ * RETURNS: Bounding box of the spels whose labels may have changed
+ */
+iftBoundingBox iftRemoveSICLESeed
+(iftSICLE *sicle, iftSICLEArgs *args, iftVoxel vxl, iftImage *label_img);
+
+/*
+ * Moves the seed of the superspel containing the source voxel to the 
+ * destination voxel within the prototype's last segmentation (see 
+ * iftAddSICLESeed). Every superspel, including the moved one, keeps its label.
+ * 
+ * PARAMETERS:
+ *  sicle[in/out] - REQUIRED: SICLE prototype with a segmentation
+ *  args[in] - OPTIONAL: SICLE arguments of the segmentation
+ *  src[in] - REQUIRED: Voxel within the superspel whose seed is moved
+ *  dst[in] - REQUIRED: Voxel within the region of interest and not a seed
+ *  label_img[in/out] - REQUIRED: Label image of the segmentation
+ *
+ * RETURNS: Bounding box of the spels whose labels may have changed
+ */
+iftBoundingBox iftMoveSICLESeed
+(iftSICLE *sicle, iftSICLEArgs *args, iftVoxel src, iftVoxel dst, 
+ iftImage *label_img);
+
 #ifdef __cplusplus
 }
 #endif
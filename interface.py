@@ -28,51 +28,79 @@ output_text = None
 image_path = None
 
 
-def run_sicle(image_path, n0=None, nf=None):
-    # Adjust the command to include the selected values of n0 and nf
-    cmd_sicle = ['./bin/RunSICLE', '--img', image_path, '--out', 'toyExOut1.pgm'] #, "--multiscale"]
+# Long-running SICLE server, which keeps the image and its segmentation
+server = None
+
+
+def request_server(line):
+    global server
+    # (Re)start the server if it is not running
+    if server is None or server.poll() is not None:
+        server = subprocess.Popen(['./bin/RunSICLEServer'],
+                                  stdin=subprocess.PIPE,
+                                  stdout=subprocess.PIPE)
+    server.stdin.write((line + "\n").encode())
+    server.stdin.flush()
+
+    header = server.stdout.readline().decode().split()
+    if not header:
+        raise RuntimeError("The SICLE server has terminated")
+    if header[0] != "ok":
+        raise RuntimeError(" ".join(header[1:]))
+    return header[1:]
+
+
+def show_error(message):
+    output_text.delete(1.0, tk.END)
+    output_text.insert(tk.END, message)
+    output_text.pack()  # Ensure the output text is visible
+
 
+def run_sicle(image_path, n0=None, nf=None):
+    # Load the image once, and segment it with the selected values of n0 and nf
+    cmd_segment = "segment"
     if n0 is not None:
-        cmd_sicle.extend(['--n0', n0])
-    if nf is not None:
-        cmd_sicle.extend(['--nf', nf])
-
-    process_sicle = subprocess.Popen(cmd_sicle,
-                                      stdout=subprocess.PIPE,
-                                      stderr=subprocess.PIPE)
-    stdout_sicle, stderr_sicle = process_sicle.communicate()
-
-    if stderr_sicle:
-        # If there's an error from RunSICLE, display it
-        output_text.delete(1.0, tk.END)
-        output_text.insert(tk.END, "RunSICLE Errors:\n" + stderr_sicle.decode())
-        output_text.pack()  # Ensure the output text is visible
+        cmd_segment += " " + n0
+        if nf is not None:
+            cmd_segment += " " + nf
+    elif nf is not None:
+        cmd_segment += " 3000 " + nf
+
+    try:
+        request_server("load " + image_path)
+        request_server(cmd_segment)
+    except RuntimeError as error:
+        # If there's an error from the server, display it
+        show_error("RunSICLEServer Errors:\n" + str(error))
     else:
-        # No error from RunSICLE, proceed to run RunOvlayBorders
-        run_ovlay_borders(image_path)
-
-
-def run_ovlay_borders(image_path):
-    # Command for RunOvlayBorders
-    cmd_ovlay = [
-        './bin/RunOvlayBorders', '--img', image_path, '--labels',
-        'toyExOut1.pgm', '--out', 'interface.out', '--rgb', '0,1,0'
-    ]
-    process_ovlay = subprocess.Popen(cmd_ovlay,
-                                      stdout=subprocess.PIPE,
-                                      stderr=subprocess.PIPE)
-    stdout_ovlay, stderr_ovlay = process_ovlay.communicate()
-
-    if stderr_ovlay:
-        # If there's an error from RunOvlayBorders, display it
-        output_text.delete(1.0, tk.END)
-        output_text.insert(tk.END,
-                           "RunOvlayBorders Errors:\n" + stderr_ovlay.decode())
-        output_text.pack()  # Ensure the output text is visible
+        # No error from the server, proceed to overlay the borders
+        run_ovlay_borders()
+
+
+def run_ovlay_borders():
+    # The overlayed image is received from memory as 8-bit RGB
+    try:
+        width, height, nbytes = map(int, request_server("overlay 0 1 0"))
+        data = server.stdout.read(nbytes)
+    except RuntimeError as error:
+        show_error("RunSICLEServer Errors:\n" + str(error))
     else:
         # If no error, hide the output_text widget and display the final image
         output_text.pack_forget()  # Hide the text widget if no errors
-        display_image('interface.out')  # Assuming 'interface.out' is an image file
+        display_image(Image.frombytes("RGB", (width, height), data))
+
+
+def run_reseg():
+    # Keep the finest superpixels within the located superpixel
+    if superpixel_coords is None:
+        show_error("Locate a superpixel first.")
+        return
+    try:
+        request_server("reseg %d %d" % superpixel_coords)
+    except RuntimeError as error:
+        show_error("RunSICLEServer Errors:\n" + str(error))
+    else:
+        run_ovlay_borders()
 
 
 def select_image():
@@ -88,7 +116,7 @@ def select_image():
         run_sicle(file_path, n0_value, nf_value)
 
 
-def display_image(image_path):
+def display_image(img):
 
     def on_click(event):
         # Check the current marking mode and perform the corresponding action
@@ -98,8 +126,7 @@ def display_image(image_path):
             locate_superpixel(event)
 
     global canvas_image
-    # Open the image without resizing
-    img = Image.open(image_path)
+    # Display the image without resizing
     imgTk = ImageTk.PhotoImage(img)
 
     # Adjust the canvas size to the image size
@@ -245,6 +272,10 @@ superpixel_button.pack(side=tk.LEFT)
 erase_button = tk.Button(frame, text="Erase", command=erase)
 erase_button.pack(side=tk.LEFT)
 
+# Create a button to resegment within the located superpixel
+reseg_button = tk.Button(frame, text="Reseg", command=run_reseg)
+reseg_button.pack(side=tk.LEFT)
+
 # Create a button to save coordinates
 save_button = tk.Button(frame, text="Save Coordinates", command=save_coordinates)
 save_button.pack(side=tk.LEFT)
@@ -262,3 +293,9 @@ canvas_image = None
 
 # Start the Tkinter event loop
 root.mainloop()
+
+# End the SICLE server along with the interface
+if server is not None and server.poll() is None:
+    server.stdin.write(b"quit\n")
+    server.stdin.flush()
+    server.wait()
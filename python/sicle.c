@@ -0,0 +1,836 @@
+/*****************************************************************************\
+* sicle.c
+*
+* AUTHOR  : Felipe Belem
+* DATE    : 2026-10-17
+* LICENSE : MIT License
+* EMAIL   : felipe.belem@ic.unicamp.br
+\*****************************************************************************/
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "ift.h"
+#include "iftSICLE.h"
+#include "iftMetrics.h"
+
+/*
+ * CPython extension exposing the SICLE prototype and the superspel metrics
+ * through the buffer protocol, so NumPy arrays (or any C-contiguous buffer)
+ * are exchanged without files or processes. Images are (H,W) or (H,W,3)
+ * uint8/uint16 buffers, decoded once into the prototype's features. Label
+ * images are (H,W) or (D,H,W) buffers, read in place when they are int32,
+ * and the segmentations are returned as Labels objects exporting the label
+ * image computed by the library, such that numpy.asarray(labels) is a view.
+ * The GIL is released while segmenting and evaluating, so distinct SICLE
+ * objects may run in parallel threads. Since the IFT workspace belongs to
+ * the prototype, running the same object from two threads raises an error.
+ */
+typedef struct labels_object
+{
+	PyObject_HEAD
+	iftImage *label_img; // Label image exported. Owned by the object
+	int ndim; // 2 for images, and 3 for volumes
+	Py_ssize_t shape[3]; // Exported shape, from the slowest axis
+	Py_ssize_t strides[3]; // Exported strides, in bytes
+} LabelsObject;
+
+typedef struct sicle_object
+{
+	PyObject_HEAD
+	iftSICLE *sicle; // SICLE prototype. Owned by the object
+	int xsize, ysize; // Prototype's domain
+	int num_vtx; // Spels within the region of interest
+	bool has_objsm; // Whether a saliency map was provided
+	bool is_busy; // Whether a thread is running the prototype
+} SICLEObject;
+
+/* PROTOTYPES ****************************************************************/
+static PyObject *newLabels
+(iftImage *label_img);
+
+static iftImage *bufferToImage
+(PyObject *obj, const char *name);
+
+static iftImage *bufferToLabelImage
+(PyObject *obj, const char *name, Py_buffer *view);
+
+static void releaseLabelImage
+(iftImage **label_img, Py_buffer *view);
+
+static bool sameDomain
+(iftImage *img1, iftImage *img2, const char *name);
+
+static int setInputs
+(SICLEObject *self, PyObject *args, PyObject *kwargs, iftImage **img,
+ iftImage **objsm, iftImage **mask);
+
+static iftSICLEArgs *parseSICLEArgs
+(SICLEObject *self, PyObject *args, PyObject *kwargs);
+
+static bool acquireSICLE
+(SICLEObject *self);
+
+/* LABELS ********************************************************************/
+static void Labels_dealloc
+(LabelsObject *self)
+{
+	if(self->label_img != NULL) { iftDestroyImage(&(self->label_img)); }
+	Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int Labels_getbuffer
+(LabelsObject *self, Py_buffer *view, int flags)
+{
+	view->obj = (PyObject*)self; Py_INCREF(self);
+	view->buf = self->label_img->val;
+	view->len = (Py_ssize_t)self->label_img->n * sizeof(int);
+	view->readonly = 0;
+	view->itemsize = sizeof(int);
+	view->format = (flags & PyBUF_FORMAT) ? "i" : NULL;
+	view->ndim = self->ndim;
+	view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+	view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ?
+									self->strides : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+
+	return 0;
+}
+
+static PyObject *Labels_getshape
+(LabelsObject *self, void *closure)
+{
+	if(self->ndim == 2)
+	{ return Py_BuildValue("(nn)", self->shape[0], self->shape[1]); }
+	return Py_BuildValue("(nnn)", self->shape[0], self->shape[1],
+											 self->shape[2]);
+}
+
+static PyBufferProcs Labels_as_buffer = {
+	.bf_getbuffer = (getbufferproc)Labels_getbuffer,
+	.bf_releasebuffer = NULL,
+};
+
+static PyGetSetDef Labels_getset[] = {
+	{"shape", (getter)Labels_getshape, NULL, "Shape of the label image", NULL},
+	{NULL}
+};
+
+static PyTypeObject LabelsType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "sicle.Labels",
+	.tp_doc = PyDoc_STR("Label image exported as an int32 buffer, such that "
+											"numpy.asarray(labels) shares its memory"),
+	.tp_basicsize = sizeof(LabelsObject),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_dealloc = (destructor)Labels_dealloc,
+	.tp_as_buffer = &Labels_as_buffer,
+	.tp_getset = Labels_getset,
+};
+
+/* SICLE *********************************************************************/
+static void SICLE_dealloc
+(SICLEObject *self)
+{
+	if(self->sicle != NULL) { iftDestroySICLE(&(self->sicle)); }
+	Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int SICLE_init
+(SICLEObject *self, PyObject *args, PyObject *kwargs)
+{
+	iftImage *img, *objsm, *mask;
+
+	if(self->sicle != NULL)
+	{ PyErr_SetString(PyExc_RuntimeError, "Use update() instead"); return -1; }
+	if(setInputs(self, args, kwargs, &img, &objsm, &mask) < 0) { return -1; }
+
+	Py_BEGIN_ALLOW_THREADS
+	self->sicle = iftCreateSICLE(img, objsm, mask);
+	Py_END_ALLOW_THREADS
+
+	iftDestroyImage(&img);
+	if(objsm != NULL) { iftDestroyImage(&objsm); }
+	if(mask != NULL) { iftDestroyImage(&mask); }
+
+	return 0;
+}
+
+static PyObject *SICLE_update
+(SICLEObject *self, PyObject *args, PyObject *kwargs)
+{
+	int old_xsize, old_ysize, old_num_vtx;
+	bool old_has_objsm;
+	iftImage *img, *objsm, *mask;
+
+	if(acquireSICLE(self) == false) { return NULL; }
+
+	old_xsize = self->xsize; old_ysize = self->ysize;
+	old_num_vtx = self->num_vtx; old_has_objsm = self->has_objsm;
+	if(setInputs(self, args, kwargs, &img, &objsm, &mask) < 0)
+	{ self->is_busy = false; return NULL; }
+
+	if(self->xsize != old_xsize || self->ysize != old_ysize)
+	{
+		self->xsize = old_xsize; self->ysize = old_ysize;
+		self->num_vtx = old_num_vtx; self->has_objsm = old_has_objsm;
+		iftDestroyImage(&img);
+		if(objsm != NULL) { iftDestroyImage(&objsm); }
+		if(mask != NULL) { iftDestroyImage(&mask); }
+		self->is_busy = false;
+		PyErr_SetString(PyExc_ValueError,
+										"The image's domain differs from the prototype's");
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	iftUpdateSICLE(self->sicle, img, objsm, mask);
+	Py_END_ALLOW_THREADS
+	self->is_busy = false;
+
+	iftDestroyImage(&img);
+	if(objsm != NULL) { iftDestroyImage(&objsm); }
+	if(mask != NULL) { iftDestroyImage(&mask); }
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *SICLE_run
+(SICLEObject *self, PyObject *args, PyObject *kwargs)
+{
+	iftSICLEArgs *sargs;
+	iftImage *label_img;
+
+	if((sargs = parseSICLEArgs(self, args, kwargs)) == NULL) { return NULL; }
+	if(acquireSICLE(self) == false)
+	{ iftDestroySICLEArgs(&sargs); return NULL; }
+
+	Py_BEGIN_ALLOW_THREADS
+	label_img = iftRunSICLE(self->sicle, sargs);
+	Py_END_ALLOW_THREADS
+	self->is_busy = false;
+	iftDestroySICLEArgs(&sargs);
+
+	return newLabels(label_img);
+}
+
+static PyObject *SICLE_run_multiscale
+(SICLEObject *self, PyObject *args, PyObject *kwargs)
+{
+	int num_scales;
+	iftSICLEArgs *sargs;
+	iftImage **multiscale;
+	PyObject *list;
+
+	if((sargs = parseSICLEArgs(self, args, kwargs)) == NULL) { return NULL; }
+	if(acquireSICLE(self) == false)
+	{ iftDestroySICLEArgs(&sargs); return NULL; }
+
+	Py_BEGIN_ALLOW_THREADS
+	multiscale = iftRunMultiscaleSICLE(self->sicle, sargs, &num_scales);
+	Py_END_ALLOW_THREADS
+	self->is_busy = false;
+	iftDestroySICLEArgs(&sargs);
+
+	list = PyList_New(num_scales);
+	for(int i = 0; i < num_scales; ++i)
+	{
+		PyObject *labels;
+
+		labels = (list != NULL) ? newLabels(multiscale[i]) : NULL;
+		if(labels == NULL) // Frees the scales not yet owned by the list
+		{
+			for(int j = (list != NULL) ? i + 1 : i; j < num_scales; ++j)
+			{ iftDestroyImage(&(multiscale[j])); }
+			Py_XDECREF(list); list = NULL;
+			break;
+		}
+		PyList_SET_ITEM(list, i, labels);
+	}
+	free(multiscale);
+
+	return list;
+}
+
+static PyMethodDef SICLE_methods[] = {
+	{"update", (PyCFunction)(void(*)(void))SICLE_update,
+	 METH_VARARGS | METH_KEYWORDS,
+	 PyDoc_STR("update(img, objsm=None, mask=None)\n\nReplaces the inputs of "
+						 "the prototype, keeping its workspace. The domain must not "
+						 "change.")},
+	{"run", (PyCFunction)(void(*)(void))SICLE_run, METH_VARARGS | METH_KEYWORDS,
+	 PyDoc_STR("run(**args) -> Labels\n\nRuns SICLE and returns labels within "
+						 "[1,nf], or [0,nf] if a mask was provided. Arguments: n0, "
+						 "nf, max_iters, irreg, adhr, alpha, sampl ('rnd','grid'), "
+						 "conn ('fmax','fsum'), crit ('minsc','maxsc','size',"
+						 "'spread'), pen ('none','obj','bord','osb','bobs'), diag, "
+						 "dift, bqueue, buckets and tile_size, as in RunSICLE.")},
+	{"run_multiscale", (PyCFunction)(void(*)(void))SICLE_run_multiscale,
+	 METH_VARARGS | METH_KEYWORDS,
+	 PyDoc_STR("run_multiscale(**args) -> list of Labels\n\nRuns SICLE and "
+						 "returns the labels of every iteration, from the first one. "
+						 "Same arguments as run().")},
+	{NULL}
+};
+
+static PyTypeObject SICLEType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "sicle.SICLE",
+	.tp_doc = PyDoc_STR("SICLE(img, objsm=None, mask=None)\n\nSICLE prototype "
+											"of a (H,W) or (H,W,3) uint8/uint16 image, with an "
+											"optional (H,W) saliency map and region of interest"),
+	.tp_basicsize = sizeof(SICLEObject),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)SICLE_init,
+	.tp_dealloc = (destructor)SICLE_dealloc,
+	.tp_methods = SICLE_methods,
+};
+
+/* METRICS *******************************************************************/
+static PyObject *evalLabels
+(PyObject *args, float (*eval)(iftImage*))
+{
+	float val;
+	PyObject *label_obj;
+	Py_buffer label_view;
+	iftImage *label_img;
+
+	if(!PyArg_ParseTuple(args, "O", &label_obj)) { return NULL; }
+	label_img = bufferToLabelImage(label_obj, "labels", &label_view);
+	if(label_img == NULL) { return NULL; }
+
+	Py_BEGIN_ALLOW_THREADS
+	val = eval(label_img);
+	Py_END_ALLOW_THREADS
+	releaseLabelImage(&label_img, &label_view);
+
+	return PyFloat_FromDouble(val);
+}
+
+static PyObject *evalLabelsGT
+(PyObject *args, float (*eval)(iftImage*, iftImage*))
+{
+	float val;
+	PyObject *label_obj, *gt_obj;
+	Py_buffer label_view, gt_view;
+	iftImage *label_img, *gt_img;
+
+	if(!PyArg_ParseTuple(args, "OO", &label_obj, &gt_obj)) { return NULL; }
+	label_img = bufferToLabelImage(label_obj, "labels", &label_view);
+	if(label_img == NULL) { return NULL; }
+	gt_img = bufferToLabelImage(gt_obj, "gt", &gt_view);
+	if(gt_img == NULL)
+	{ releaseLabelImage(&label_img, &label_view); return NULL; }
+
+	if(sameDomain(label_img, gt_img, "gt") == false)
+	{
+		releaseLabelImage(&label_img, &label_view);
+		releaseLabelImage(&gt_img, &gt_view);
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	val = eval(label_img, gt_img);
+	Py_END_ALLOW_THREADS
+	releaseLabelImage(&label_img, &label_view);
+	releaseLabelImage(&gt_img, &gt_view);
+
+	return PyFloat_FromDouble(val);
+}
+
+static PyObject *sicle_eval_co
+(PyObject *module, PyObject *args)
+{ return evalLabels(args, iftEvalCO); }
+
+static PyObject *sicle_eval_cd
+(PyObject *module, PyObject *args)
+{ return evalLabels(args, iftEvalCD); }
+
+static PyObject *sicle_eval_tex
+(PyObject *module, PyObject *args)
+{ return evalLabels(args, iftEvalTEX); }
+
+static PyObject *sicle_eval_asa
+(PyObject *module, PyObject *args)
+{ return evalLabelsGT(args, iftEvalASA); }
+
+static PyObject *sicle_eval_br
+(PyObject *module, PyObject *args)
+{ return evalLabelsGT(args, iftEvalBR); }
+
+static PyObject *sicle_eval_ue
+(PyObject *module, PyObject *args)
+{ return evalLabelsGT(args, iftEvalUE); }
+
+static PyObject *sicle_eval_ev
+(PyObject *module, PyObject *args)
+{
+	float val;
+	PyObject *label_obj, *img_obj;
+	Py_buffer label_view;
+	iftImage *label_img, *img;
+
+	if(!PyArg_ParseTuple(args, "OO", &label_obj, &img_obj)) { return NULL; }
+	label_img = bufferToLabelImage(label_obj, "labels", &label_view);
+	if(label_img == NULL) { return NULL; }
+	img = bufferToImage(img_obj, "img");
+	if(img == NULL) { releaseLabelImage(&label_img, &label_view); return NULL; }
+
+	if(sameDomain(label_img, img, "img") == false)
+	{
+		releaseLabelImage(&label_img, &label_view); iftDestroyImage(&img);
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	val = iftEvalEV(label_img, img);
+	Py_END_ALLOW_THREADS
+	releaseLabelImage(&label_img, &label_view);
+	iftDestroyImage(&img);
+
+	return PyFloat_FromDouble(val);
+}
+
+static PyObject *sicle_eval_dice
+(PyObject *module, PyObject *args)
+{
+	int obj_label;
+	float val;
+	PyObject *label_obj, *gt_obj;
+	Py_buffer label_view, gt_view;
+	iftImage *label_img, *gt_img;
+
+	obj_label = 255; // As in RunSuperspelMetrics
+	if(!PyArg_ParseTuple(args, "OO|i", &label_obj, &gt_obj, &obj_label))
+	{ return NULL; }
+	label_img = bufferToLabelImage(label_obj, "labels", &label_view);
+	if(label_img == NULL) { return NULL; }
+	gt_img = bufferToLabelImage(gt_obj, "gt", &gt_view);
+	if(gt_img == NULL)
+	{ releaseLabelImage(&label_img, &label_view); return NULL; }
+
+	if(sameDomain(label_img, gt_img, "gt") == false)
+	{
+		releaseLabelImage(&label_img, &label_view);
+		releaseLabelImage(&gt_img, &gt_view);
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	val = iftEvalDICE(label_img, gt_img, obj_label);
+	Py_END_ALLOW_THREADS
+	releaseLabelImage(&label_img, &label_view);
+	releaseLabelImage(&gt_img, &gt_view);
+
+	return PyFloat_FromDouble(val);
+}
+
+static PyMethodDef sicle_methods[] = {
+	{"eval_co", sicle_eval_co, METH_VARARGS,
+	 PyDoc_STR("eval_co(labels) -> Compacity. Higher is better")},
+	{"eval_cd", sicle_eval_cd, METH_VARARGS,
+	 PyDoc_STR("eval_cd(labels) -> Contour density. Lower is better")},
+	{"eval_tex", sicle_eval_tex, METH_VARARGS,
+	 PyDoc_STR("eval_tex(labels) -> Temporal extension. Higher is better")},
+	{"eval_ev", sicle_eval_ev, METH_VARARGS,
+	 PyDoc_STR("eval_ev(labels, img) -> Explained variation. Higher is better")},
+	{"eval_asa", sicle_eval_asa, METH_VARARGS,
+	 PyDoc_STR("eval_asa(labels, gt) -> Achievable segmentation accuracy. "
+						 "Higher is better")},
+	{"eval_br", sicle_eval_br, METH_VARARGS,
+	 PyDoc_STR("eval_br(labels, gt) -> Boundary recall. Higher is better")},
+	{"eval_ue", sicle_eval_ue, METH_VARARGS,
+	 PyDoc_STR("eval_ue(labels, gt) -> Under-segmentation error. Lower is "
+						 "better")},
+	{"eval_dice", sicle_eval_dice, METH_VARARGS,
+	 PyDoc_STR("eval_dice(labels, gt, obj_label=255) -> Dice coefficient of "
+						 "the superspel most overlapping the object. Higher is better")},
+	{NULL}
+};
+
+static struct PyModuleDef sicle_module = {
+	PyModuleDef_HEAD_INIT,
+	.m_name = "sicle",
+	.m_doc = PyDoc_STR("Superpixels through Iterative CLEarcutting (SICLE)"),
+	.m_size = -1,
+	.m_methods = sicle_methods,
+};
+
+PyMODINIT_FUNC PyInit_sicle(void)
+{
+	PyObject *module;
+
+	if(PyType_Ready(&LabelsType) < 0 || PyType_Ready(&SICLEType) < 0)
+	{ return NULL; }
+
+	if((module = PyModule_Create(&sicle_module)) == NULL) { return NULL; }
+
+	Py_INCREF(&LabelsType);
+	if(PyModule_AddObject(module, "Labels", (PyObject*)&LabelsType) < 0)
+	{ Py_DECREF(&LabelsType); Py_DECREF(module); return NULL; }
+
+	Py_INCREF(&SICLEType);
+	if(PyModule_AddObject(module, "SICLE", (PyObject*)&SICLEType) < 0)
+	{ Py_DECREF(&SICLEType); Py_DECREF(module); return NULL; }
+
+	return module;
+}
+
+/* METHODS********************************************************************/
+/*
+ * Wraps a label image computed by the library, whose ownership is taken
+ */
+static PyObject *newLabels
+(iftImage *label_img)
+{
+	LabelsObject *self;
+
+	self = PyObject_New(LabelsObject, &LabelsType);
+	if(self == NULL) { iftDestroyImage(&label_img); return NULL; }
+
+	self->label_img = label_img;
+	if(iftIs3DImage(label_img))
+	{
+		self->ndim = 3;
+		self->shape[0] = label_img->zsize; self->shape[1] = label_img->ysize;
+		self->shape[2] = label_img->xsize;
+	}
+	else
+	{
+		self->ndim = 2;
+		self->shape[0] = label_img->ysize; self->shape[1] = label_img->xsize;
+	}
+	self->strides[self->ndim - 1] = sizeof(int);
+	for(int i = self->ndim - 2; i >= 0; --i)
+	{ self->strides[i] = self->strides[i + 1] * self->shape[i + 1]; }
+
+	return (PyObject*)self;
+}
+
+/*
+ * Decodes a (H,W) or (H,W,3) uint8/uint16 buffer into a grayscale or YCbCr
+ * image, as the image readers do. Returns NULL with an exception set if the
+ * buffer is not supported
+ */
+static iftImage *bufferToImage
+(PyObject *obj, const char *name)
+{
+	bool is_color, is_16bit;
+	int xsize, ysize, norm_val;
+	Py_buffer view;
+	iftImage *img;
+
+	if(PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+	{ return NULL; }
+
+	is_16bit = strcmp(view.format, "H") == 0 || strcmp(view.format, "=H") == 0;
+	is_color = view.ndim == 3 && view.shape[2] == 3;
+	if((!is_16bit && strcmp(view.format, "B") != 0) ||
+		 (view.ndim != 2 && !is_color) || view.shape[0] < 1 || view.shape[1] < 1 ||
+		 view.shape[0] > INT_MAX || view.shape[1] > INT_MAX)
+	{
+		PyErr_Format(PyExc_ValueError, "%s must be a (H,W) or (H,W,3) uint8 or "
+								 "uint16 C-contiguous array", name);
+		PyBuffer_Release(&view);
+		return NULL;
+	}
+	ysize = view.shape[0]; xsize = view.shape[1];
+	norm_val = is_16bit ? 65535 : 255;
+
+	if(is_color) { img = iftCreateColorImage(xsize, ysize, 1, is_16bit ? 16 : 8); }
+	else { img = iftCreateImage(xsize, ysize, 1); }
+
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int p_idx = 0; p_idx < img->n; ++p_idx)
+	{
+		if(is_color)
+		{
+			iftColor RGB, YCbCr;
+
+			for(int c = 0; c < 3; ++c)
+			{
+				if(is_16bit) { RGB.val[c] = ((ushort*)view.buf)[3 * p_idx + c]; }
+				else { RGB.val[c] = ((uchar*)view.buf)[3 * p_idx + c]; }
+			}
+			YCbCr = iftRGBtoYCbCr(RGB, norm_val);
+			img->val[p_idx] = YCbCr.val[0];
+			img->Cb[p_idx] = YCbCr.val[1]; img->Cr[p_idx] = YCbCr.val[2];
+		}
+		else if(is_16bit) { img->val[p_idx] = ((ushort*)view.buf)[p_idx]; }
+		else { img->val[p_idx] = ((uchar*)view.buf)[p_idx]; }
+	}
+	PyBuffer_Release(&view);
+
+	return img;
+}
+
+/*
+ * Reads a (H,W) or (D,H,W) label buffer. An int32 buffer is shared by the
+ * returned image, and kept by the view until releaseLabelImage is called;
+ * whereas uint8/uint16 ones are copied. Returns NULL with an exception set
+ * if the buffer is not supported or if it has negative labels
+ */
+static iftImage *bufferToLabelImage
+(PyObject *obj, const char *name, Py_buffer *view)
+{
+	bool is_int32, has_neg;
+	int xsize, ysize, zsize;
+	iftImage *label_img;
+
+	if(PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+	{ return NULL; }
+
+	is_int32 = view->itemsize == sizeof(int) &&
+						 (strcmp(view->format, "i") == 0 || strcmp(view->format, "=i") == 0);
+	if((!is_int32 && strcmp(view->format, "B") != 0 &&
+			strcmp(view->format, "H") != 0 && strcmp(view->format, "=H") != 0) ||
+		 view->ndim < 2 || view->ndim > 3 || view->len == 0 ||
+		 view->len / view->itemsize > INT_MAX)
+	{
+		PyErr_Format(PyExc_ValueError, "%s must be a (H,W) or (D,H,W) int32, "
+								 "uint8 or uint16 C-contiguous array", name);
+		PyBuffer_Release(view);
+		return NULL;
+	}
+	zsize = (view->ndim == 3) ? view->shape[0] : 1;
+	ysize = view->shape[view->ndim - 2]; xsize = view->shape[view->ndim - 1];
+
+	if(is_int32)
+	{
+		label_img = iftCreateImageFromBuffer(xsize, ysize, zsize, view->buf);
+
+		has_neg = false;
+		for(int p_idx = 0; !has_neg && p_idx < label_img->n; ++p_idx)
+		{ has_neg = label_img->val[p_idx] < 0; }
+		if(has_neg)
+		{
+			releaseLabelImage(&label_img, view);
+			PyErr_Format(PyExc_ValueError, "%s must not have negative labels", name);
+			return NULL;
+		}
+	}
+	else
+	{
+		label_img = iftCreateImage(xsize, ysize, zsize);
+		for(int p_idx = 0; p_idx < label_img->n; ++p_idx)
+		{
+			if(view->itemsize == 1)
+			{ label_img->val[p_idx] = ((uchar*)view->buf)[p_idx]; }
+			else { label_img->val[p_idx] = ((ushort*)view->buf)[p_idx]; }
+		}
+		PyBuffer_Release(view); view->obj = NULL;
+	}
+
+	return label_img;
+}
+
+/*
+ * Frees a label image from bufferToLabelImage, without freeing the memory
+ * it shares with the buffer
+ */
+static void releaseLabelImage
+(iftImage **label_img, Py_buffer *view)
+{
+	if(view->obj != NULL) // Shared?
+	{ (*label_img)->val = NULL; PyBuffer_Release(view); }
+	iftDestroyImage(label_img);
+}
+
+static bool sameDomain
+(iftImage *img1, iftImage *img2, const char *name)
+{
+	if(img1->xsize != img2->xsize || img1->ysize != img2->ysize ||
+		 img1->zsize != img2->zsize)
+	{
+		PyErr_Format(PyExc_ValueError, "%s's shape differs from the labels'", name);
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Parses the inputs of the constructor and of update(), and sets the
+ * prototype's domain and the information needed for validating arguments
+ */
+static int setInputs
+(SICLEObject *self, PyObject *args, PyObject *kwargs, iftImage **img,
+ iftImage **objsm, iftImage **mask)
+{
+	static char *KWLIST[] = {"img", "objsm", "mask", NULL};
+	int num_vtx;
+	PyObject *img_obj, *objsm_obj, *mask_obj;
+	Py_buffer mask_view;
+
+	objsm_obj = mask_obj = Py_None;
+	if(!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OO", KWLIST, &img_obj,
+																	&objsm_obj, &mask_obj))
+	{ return -1; }
+
+	(*objsm) = (*mask) = NULL;
+	if(((*img) = bufferToImage(img_obj, "img")) == NULL) { return -1; }
+
+	if(objsm_obj != Py_None)
+	{
+		(*objsm) = bufferToImage(objsm_obj, "objsm");
+		if((*objsm) == NULL || iftIsColorImage(*objsm) ||
+			 !sameDomain(*objsm, *img, "objsm"))
+		{
+			if((*objsm) != NULL && iftIsColorImage(*objsm))
+			{ PyErr_SetString(PyExc_ValueError, "objsm must be a (H,W) array"); }
+			if((*objsm) != NULL) { iftDestroyImage(objsm); }
+			iftDestroyImage(img);
+			return -1;
+		}
+	}
+
+	num_vtx = (*img)->n;
+	if(mask_obj != Py_None)
+	{
+		iftImage *shared_mask;
+
+		shared_mask = bufferToLabelImage(mask_obj, "mask", &mask_view);
+		if(shared_mask == NULL || !sameDomain(shared_mask, *img, "mask"))
+		{
+			if(shared_mask != NULL) { releaseLabelImage(&shared_mask, &mask_view); }
+			if((*objsm) != NULL) { iftDestroyImage(objsm); }
+			iftDestroyImage(img);
+			return -1;
+		}
+
+		(*mask) = iftCopyImage(shared_mask);
+		releaseLabelImage(&shared_mask, &mask_view);
+
+		num_vtx = 0;
+		for(int p_idx = 0; p_idx < (*mask)->n; ++p_idx)
+		{ num_vtx += (*mask)->val[p_idx] != 0; }
+	}
+
+	self->xsize = (*img)->xsize; self->ysize = (*img)->ysize;
+	self->num_vtx = num_vtx;
+	self->has_objsm = (*objsm) != NULL;
+
+	return 0;
+}
+
+/*
+ * Parses the SICLE arguments, validated here as in iftVerifySICLEArgs, since
+ * invalid arguments would end the interpreter. Returns NULL with an exception
+ * set if they are invalid
+ */
+static iftSICLEArgs *parseSICLEArgs
+(SICLEObject *self, PyObject *args, PyObject *kwargs)
+{
+	static char *KWLIST[] = {"n0", "nf", "max_iters", "irreg", "adhr", "alpha",
+													 "sampl", "conn", "crit", "pen", "diag", "dift",
+													 "bqueue", "buckets", "tile_size", NULL};
+	int use_diag, use_dift, use_bqueue;
+	const char *sampl, *conn, *crit, *pen;
+	iftSICLEArgs *sargs;
+
+	if(self->sicle == NULL)
+	{ PyErr_SetString(PyExc_RuntimeError, "SICLE was not initialized"); return NULL; }
+
+	sargs = iftCreateSICLEArgs();
+	use_diag = sargs->use_diag; use_dift = sargs->use_dift;
+	use_bqueue = sargs->use_bqueue;
+	sampl = "rnd"; conn = "fmax"; crit = "minsc"; pen = "none";
+
+	if(!PyArg_ParseTupleAndKeywords(args, kwargs, "|$iiififssssppppii", KWLIST,
+																	&(sargs->n0), &(sargs->nf),
+																	&(sargs->max_iters), &(sargs->irreg),
+																	&(sargs->adhr), &(sargs->alpha), &sampl,
+																	&conn, &crit, &pen, &use_diag, &use_dift,
+																	&use_bqueue, &(sargs->num_buckets),
+																	&(sargs->tile_size)))
+	{ iftDestroySICLEArgs(&sargs); return NULL; }
+	sargs->use_diag = use_diag; sargs->use_dift = use_dift;
+	sargs->use_bqueue = use_bqueue;
+
+	if(iftCompareStrings(sampl, "rnd")) { sargs->samplopt = IFT_SICLE_SAMPL_RND; }
+	else if(iftCompareStrings(sampl, "grid"))
+	{ sargs->samplopt = IFT_SICLE_SAMPL_GRID; }
+	else { PyErr_Format(PyExc_ValueError, "Unknown sampling: %s", sampl); }
+
+	if(iftCompareStrings(conn, "fmax")) { sargs->connopt = IFT_SICLE_CONN_FMAX; }
+	else if(iftCompareStrings(conn, "fsum"))
+	{ sargs->connopt = IFT_SICLE_CONN_FSUM; }
+	else { PyErr_Format(PyExc_ValueError, "Unknown connectivity: %s", conn); }
+
+	if(iftCompareStrings(crit, "size")) { sargs->critopt = IFT_SICLE_CRIT_SIZE; }
+	else if(iftCompareStrings(crit, "minsc"))
+	{ sargs->critopt = IFT_SICLE_CRIT_MINSC; }
+	else if(iftCompareStrings(crit, "maxsc"))
+	{ sargs->critopt = IFT_SICLE_CRIT_MAXSC; }
+	else if(iftCompareStrings(crit, "spread"))
+	{ sargs->critopt = IFT_SICLE_CRIT_SPREAD; }
+	else { PyErr_Format(PyExc_ValueError, "Unknown criterion: %s", crit); }
+
+	if(iftCompareStrings(pen, "none")) { sargs->penopt = IFT_SICLE_PEN_NONE; }
+	else if(iftCompareStrings(pen, "obj")) { sargs->penopt = IFT_SICLE_PEN_OBJ; }
+	else if(iftCompareStrings(pen, "bord")) { sargs->penopt = IFT_SICLE_PEN_BORD; }
+	else if(iftCompareStrings(pen, "osb")) { sargs->penopt = IFT_SICLE_PEN_OSB; }
+	else if(iftCompareStrings(pen, "bobs")) { sargs->penopt = IFT_SICLE_PEN_BOBS; }
+	else { PyErr_Format(PyExc_ValueError, "Unknown penalization: %s", pen); }
+
+	if(PyErr_Occurred() != NULL) {}
+	else if(sargs->n0 <= 2 || sargs->n0 >= self->num_vtx)
+	{
+		PyErr_Format(PyExc_ValueError, "Invalid N0 value of %d. It must be within "
+								 "]2,%d[", sargs->n0, self->num_vtx);
+	}
+	else if(sargs->nf < 2 || sargs->nf >= sargs->n0)
+	{
+		PyErr_Format(PyExc_ValueError, "Invalid Nf value of %d. It must be within "
+								 "[2,%d[", sargs->nf, sargs->n0);
+	}
+	else if(sargs->max_iters < 2)
+	{ PyErr_SetString(PyExc_ValueError, "max_iters must be >= 2"); }
+	else if(sargs->irreg < 0 || sargs->adhr < 0 || sargs->alpha < 0)
+	{ PyErr_SetString(PyExc_ValueError, "irreg, adhr and alpha must be >= 0"); }
+	else if(self->has_objsm == false && sargs->penopt != IFT_SICLE_PEN_NONE)
+	{
+		PyErr_SetString(PyExc_ValueError,
+										"Penalization cannot be used without a saliency map");
+	}
+	else if(sargs->tile_size < 0)
+	{ PyErr_SetString(PyExc_ValueError, "tile_size must be >= 0"); }
+	else if(sargs->use_bqueue)
+	{
+		#ifdef IFT_COMPACT //-----------------------------------------------------|
+		PyErr_SetString(PyExc_ValueError,
+										"Bucket queue is unavailable in the compact build");
+		#else //------------------------------------------------------------------|
+		if(sargs->connopt != IFT_SICLE_CONN_FMAX || sargs->num_buckets < 2)
+		{
+			PyErr_SetString(PyExc_ValueError, "Bucket queue requires the Fmax "
+											"connectivity and at least 2 buckets");
+		}
+		#endif //-----------------------------------------------------------------|
+	}
+
+	if(PyErr_Occurred() != NULL) { iftDestroySICLEArgs(&sargs); return NULL; }
+
+	return sargs;
+}
+
+/*
+ * Marks the prototype as running. Since it is only called while holding the
+ * GIL, no other thread may acquire it in-between
+ */
+static bool acquireSICLE
+(SICLEObject *self)
+{
+	if(self->sicle == NULL)
+	{ PyErr_SetString(PyExc_RuntimeError, "SICLE was not initialized"); }
+	else if(self->is_busy)
+	{
+		PyErr_SetString(PyExc_RuntimeError,
+										"SICLE is already running in another thread");
+	}
+	else { self->is_busy = true; }
+
+	return !PyErr_Occurred();
+}
@@ -1037,6 +1037,149 @@ void iftResetDHeap(iftDHeap *H)
 }
 
 // ---------- iftDHeap.c end
+// ---------- iftBQueue.c start
+
+/* Bucket b is the circular list whose sentinel is the node n+b */
+#define iftBQueueBucket(Q, elem) \
+    ((int)iftMin(iftMax((Q)->value[(elem)] * (Q)->scale, 0.0), (Q)->nbuckets - 1))
+
+iftBQueue *iftCreateBQueue(int n, int nbuckets, double maxvalue, double *value)
+{
+    iftBQueue *Q = NULL;
+
+    if (value == NULL) {
+        iftError("Cannot create queue without priority value map", "iftCreateBQueue");
+    }
+    if (nbuckets < 1 || maxvalue <= 0.0) {
+        iftError("Invalid number of buckets or maximum value", "iftCreateBQueue");
+    }
+
+    Q = (iftBQueue *) iftAlloc(1, sizeof(iftBQueue));
+    if (Q != NULL) {
+        Q->n        = n;
+        Q->nbuckets = nbuckets;
+        Q->value    = value;
+        Q->scale    = (nbuckets - 1) / maxvalue;
+        Q->color    = (char *) iftAlloc(sizeof(char), n);
+        Q->next     = (int *) iftAlloc(sizeof(int), n + nbuckets);
+        Q->prev     = (int *) iftAlloc(sizeof(int), n + nbuckets);
+        Q->active   = iftCreateDHeap(n, value);
+        if (Q->color == NULL || Q->next == NULL || Q->prev == NULL)
+            iftError(MSG_MEMORY_ALLOC_ERROR, "iftCreateBQueue");
+        iftResetBQueue(Q);
+    }
+    else
+        iftError(MSG_MEMORY_ALLOC_ERROR, "iftCreateBQueue");
+
+    return Q;
+}
+
+void iftDestroyBQueue(iftBQueue **Q)
+{
+    iftBQueue *aux = *Q;
+    if (aux != NULL) {
+        if (aux->color != NULL) iftFree(aux->color);
+        if (aux->next != NULL)  iftFree(aux->next);
+        if (aux->prev != NULL)  iftFree(aux->prev);
+        iftDestroyDHeap(&(aux->active));
+        iftFree(aux);
+        *Q = NULL;
+    }
+}
+
+char iftEmptyBQueue(iftBQueue *Q)
+{
+    return (Q->nelems == 0);
+}
+
+void iftInsertBQueue(iftBQueue *Q, int elem)
+{
+    int b = iftBQueueBucket(Q, elem), head = Q->n + b;
+
+    if (b <= Q->actbucket) { // Ordered among the bucket being removed
+        Q->next[elem] = Q->prev[elem] = IFT_NIL;
+        iftInsertDHeap(Q->active, elem);
+    } else {
+        Q->next[elem] = head;
+        Q->prev[elem] = Q->prev[head];
+        Q->next[Q->prev[head]] = elem;
+        Q->prev[head] = elem;
+        if (b < Q->minbucket)
+            Q->minbucket = b;
+    }
+    Q->color[elem] = IFT_GRAY;
+    Q->nelems++;
+}
+
+int iftRemoveBQueue(iftBQueue *Q)
+{
+    int elem = IFT_NIL, head;
+
+    if (iftEmptyBQueue(Q)) {
+        iftWarning("BQueue is empty", "iftRemoveBQueue");
+        return elem;
+    }
+
+    if (iftEmptyDHeap(Q->active)) { // Moves the least bucket into the heap
+        head = Q->n + Q->minbucket;
+        while (Q->next[head] == head) {
+            Q->minbucket++;
+            head++;
+        }
+
+        elem = Q->next[head];
+        while (elem != head) {
+            int next = Q->next[elem];
+
+            Q->next[elem] = Q->prev[elem] = IFT_NIL;
+            iftInsertDHeap(Q->active, elem);
+            elem = next;
+        }
+        Q->next[head] = Q->prev[head] = head;
+        Q->actbucket = Q->minbucket;
+        Q->minbucket++;
+    }
+
+    elem = iftRemoveDHeap(Q->active);
+    Q->color[elem] = IFT_BLACK;
+    Q->nelems--;
+
+    return elem;
+}
+
+void iftRemoveBQueueElem(iftBQueue *Q, int elem)
+{
+    if (Q->color[elem] != IFT_GRAY)
+        iftError("Element is not in the queue", "iftRemoveBQueueElem");
+
+    if (Q->prev[elem] == IFT_NIL) { // Within the heap
+        iftRemoveDHeapElem(Q->active, elem);
+    } else {
+        Q->next[Q->prev[elem]] = Q->next[elem];
+        Q->prev[Q->next[elem]] = Q->prev[elem];
+        Q->next[elem] = Q->prev[elem] = IFT_NIL;
+    }
+    Q->color[elem] = IFT_WHITE;
+    Q->nelems--;
+}
+
+void iftResetBQueue(iftBQueue *Q)
+{
+    int i;
+
+    for (i = 0; i < Q->n; i++) {
+        Q->color[i] = IFT_WHITE;
+        Q->next[i]  = Q->prev[i] = IFT_NIL;
+    }
+    for (i = Q->n; i < Q->n + Q->nbuckets; i++)
+        Q->next[i] = Q->prev[i] = i;
+    iftResetDHeap(Q->active);
+    Q->actbucket = -1;
+    Q->minbucket = Q->nbuckets;
+    Q->nelems = 0;
+}
+
+// ---------- iftBQueue.c end
 // ---------- iftFile.c start
 
 bool iftFileExists(const char *pathname) 
@@ -1283,6 +1426,24 @@ iftImage  *iftCreateImage(int xsize,int ysize,int zsize)
     return iftCreateImageFromBuffer(xsize, ysize, zsize, val);
 }
 
+iftImage *iftCreateMappedImage(int xsize, int ysize, int zsize, 
+                               const char *scratch_dir)
+{
+    iftImage *img = NULL;
+    size_t    size;
+
+    if ((long) xsize * ysize * zsize > INT_MAX)
+        iftError("Image of %dx%dx%d voxels exceeds %d voxels", "iftCreateMappedImage",
+                 xsize, ysize, zsize, INT_MAX);
+
+    size = (size_t) xsize * ysize * zsize * sizeof(int);
+    img  = iftCreateImageFromBuffer(xsize, ysize, zsize, 
+                                    iftMapScratchFile(scratch_dir, size));
+    img->mapped_size = size;
+
+    return img;
+}
+
 iftImage *iftCopyImage(const iftImage *img) 
 {
     if (img == NULL)
@@ -1300,7 +1461,8 @@ void iftDestroyImage(iftImage **img)
         iftImage *aux = *img;
 
         if (aux != NULL) {
-            if (aux->val != NULL) iftFree(aux->val);
+            if (aux->mapped_size > 0) iftUnmapScratchFile(aux->val, aux->mapped_size);
+            else if (aux->val != NULL) iftFree(aux->val);
             if (aux->Cb != NULL) iftFree(aux->Cb);
             if (aux->Cr != NULL) iftFree(aux->Cr);
             if (aux->alpha != NULL) iftFree(aux->alpha);
@@ -1533,7 +1695,10 @@ iftImage *iftReadImage(const char *format, ...)
 }
 
 #if IFT_LIBPNG
-png_bytep* iftReadPngImageAux(const char *file_name, png_structp *png_ptr, png_infop *info_ptr)
+/*
+ * Opens a PNG file and reads its header, leaving the stream at the first row.
+ */
+FILE *_iftOpenPNG(const char *file_name, png_structp *png_ptr, png_infop *info_ptr)
 {
     png_byte header[8];    // 8 is the maximum size that can be checked
 
@@ -1545,9 +1710,6 @@ png_bytep* iftReadPngImageAux(const char *file_name, png_structp *png_ptr, png_i
     if (png_sig_cmp(header, 0, 8))
         iftError("File %s is not recognized as a PNG file", "iftReadPngImageAux", file_name);
 
-    int height;
-    png_bytep * row_pointers;
-
     /* initialize stuff */
     png_structp ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
 
@@ -1578,9 +1740,18 @@ png_bytep* iftReadPngImageAux(const char *file_name, png_structp *png_ptr, png_i
 	//if (png_get_sBIT(*png_ptr, *info_ptr, &sig_bit)) {
 	//	png_set_shift(*png_ptr, sig_bit);
 	//}
-    height = png_get_image_height(*png_ptr, *info_ptr);
     png_read_update_info(*png_ptr, *info_ptr);
 
+    return fp;
+}
+
+png_bytep* iftReadPngImageAux(const char *file_name, png_structp *png_ptr, png_infop *info_ptr)
+{
+    int height;
+    png_bytep * row_pointers;
+
+    FILE *fp = _iftOpenPNG(file_name, png_ptr, info_ptr);
+    height = png_get_image_height(*png_ptr, *info_ptr);
 
     /* read file */
     if (setjmp(png_jmpbuf(*png_ptr)))
@@ -1597,6 +1768,92 @@ png_bytep* iftReadPngImageAux(const char *file_name, png_structp *png_ptr, png_i
 
     return row_pointers;
 }
+
+/*
+ * Allocates the chrominance and alpha channels of an image read from a PNG
+ * file of the given color type.
+ */
+void _iftSetPNGChannels(iftImage *img, int color_type)
+{
+    if (color_type == PNG_COLOR_TYPE_RGB || color_type == PNG_COLOR_TYPE_RGB_ALPHA)
+        iftSetCbCr(img, 128);
+    if ((color_type == PNG_COLOR_TYPE_GRAY_ALPHA || color_type == PNG_COLOR_TYPE_RGB_ALPHA) &&
+        img->alpha == NULL)
+        iftSetAlpha(img, 0);
+}
+
+/*
+ * Converts the pixels [x0, x0 + ncols[ of a decoded PNG row into the image's
+ * pixels from q onwards, whose channels are set by _iftSetPNGChannels.
+ */
+void _iftPNGRowToImage(png_structp png_ptr, png_infop info_ptr, png_bytep row,
+                       int x0, int ncols, iftImage *img, int q)
+{
+    int color_type = png_get_color_type(png_ptr, info_ptr);
+    int depth = png_get_bit_depth(png_ptr, info_ptr);
+    unsigned int numberChannels = png_get_channels(png_ptr, info_ptr);
+    int byteshift = depth/8;
+    iftColor rgb, ycbcr;
+
+    for (int x = x0; x < x0 + ncols; x++, q++) {
+        png_byte* ptr = &(row[x*numberChannels*byteshift]);
+
+        if(color_type==PNG_COLOR_TYPE_GRAY)//gray image
+        {
+            img->val[q] = ptr[0];
+            if(depth==16) {
+                img->val[q] = (img->val[q]<<8)+ptr[1];
+            }
+        }else if(color_type==PNG_COLOR_TYPE_GRAY_ALPHA ){
+            if(depth == 8){
+                img->val[q] = ptr[0];
+                img->alpha[q] = ptr[1];
+            }
+            else if(depth==16) {
+                img->val[q] = ptr[0];
+                img->val[q] = (img->val[q]<<8)+ptr[1];
+                img->alpha[q] = ptr[2];
+                img->alpha[q] = (img->alpha[q]<<8)+ptr[3];
+            }
+        }
+        else if(color_type == PNG_COLOR_TYPE_RGB){//color image
+            rgb.val[0] = ptr[0*byteshift];
+            rgb.val[1] = ptr[1*byteshift];
+            rgb.val[2] = ptr[2*byteshift];
+
+            if(depth==16) { //read second byte in case of 16bit images
+                rgb.val[0] = (rgb.val[0]<<8) + ptr[1];
+                rgb.val[1] = (rgb.val[1]<<8) + ptr[3];
+                rgb.val[2] = (rgb.val[2]<<8) + ptr[5];
+            }
+
+            ycbcr = iftRGBtoYCbCrBT2020(rgb, depth, depth);
+
+            img->val[q] = ycbcr.val[0];
+            img->Cb[q]  = ycbcr.val[1];
+            img->Cr[q]  = ycbcr.val[2];
+        }else if(color_type == PNG_COLOR_TYPE_RGB_ALPHA){
+            rgb.val[0] = ptr[0*byteshift];
+            rgb.val[1] = ptr[1*byteshift];
+            rgb.val[2] = ptr[2*byteshift];
+            ushort alpha = ptr[3*byteshift];
+
+            if(depth==16) { //read second byte in case of 16bit images
+                rgb.val[0] = (rgb.val[0]<<8) + ptr[1];
+                rgb.val[1] = (rgb.val[1]<<8) + ptr[3];
+                rgb.val[2] = (rgb.val[2]<<8) + ptr[5];
+                alpha = (alpha<<8) +  ptr[7];
+            }
+
+            ycbcr = iftRGBtoYCbCr(rgb, depth==8?255:65535);
+
+            img->val[q] = ycbcr.val[0];
+            img->Cb[q] = ycbcr.val[1];
+            img->Cr[q] = ycbcr.val[2];
+            img->alpha[q] = alpha;
+        }
+    }
+}
 #endif
 
 iftImage* iftReadImagePNG(const char* format, ...) 
@@ -1615,119 +1872,15 @@ iftImage* iftReadImagePNG(const char* format, ...)
 
     row_pointers = iftReadPngImageAux(filename, &png_ptr, &info_ptr);
 
-    int width, height, color_type, depth;
+    int width, height, y;
 
     width = png_get_image_width(png_ptr, info_ptr);
     height = png_get_image_height(png_ptr, info_ptr);
-    color_type = png_get_color_type(png_ptr, info_ptr);
-    depth = png_get_bit_depth(png_ptr, info_ptr);
     iftImage* img = iftCreateImage(width, height, 1);
-    unsigned int numberChannels = png_get_channels(png_ptr, info_ptr);
-
-    int byteshift = depth/8;
-
-    int x, y;
-
-    int p = 0;
-
-    if(color_type==PNG_COLOR_TYPE_GRAY)//gray image
-    {
-        for (y=0; y<height; y++) {
-            png_byte* row = row_pointers[y];
-            for (x=0; x<width; x++) {
-                png_byte* ptr = &(row[x*numberChannels*byteshift]);
-                img->val[p] = ptr[0];
-                if(depth==16) {
-                    img->val[p] = (img->val[p]<<8)+ptr[1];
-                }
-                p++;
-            }
-        }
-    }else if(color_type==PNG_COLOR_TYPE_GRAY_ALPHA ){
-        if(img->alpha == NULL){
-            iftSetAlpha(img,0);
-        }
-        for (y=0; y<height; y++) {
-            png_byte* row = row_pointers[y];
-            for (x=0; x<width; x++) {
-                png_byte* ptr = &(row[x*numberChannels*byteshift]);
-                if(depth == 8){
-                    img->val[p] = ptr[0];
-                    img->alpha[p] = ptr[1];
-                }
-                else if(depth==16) {
-                    img->val[p] = ptr[0];
-                    img->val[p] = (img->val[p]<<8)+ptr[1];
-                    img->alpha[p] = ptr[2];
-                    img->alpha[p] = (img->alpha[p]<<8)+ptr[3];
-                }
-                p++;
-            }
-        }
-    }
-    else if(color_type == PNG_COLOR_TYPE_RGB){//color image
-
-        iftSetCbCr(img, 128);
-        iftColor rgb, ycbcr;
 
-        for (y=0; y<height; y++) {
-            png_byte* row = row_pointers[y];
-
-            for (x=0; x<width; x++) {
-                png_byte* ptr = &(row[x*numberChannels*byteshift]);
-                rgb.val[0] = ptr[0*byteshift];
-                rgb.val[1] = ptr[1*byteshift];
-                rgb.val[2] = ptr[2*byteshift];
-
-                if(depth==16) { //read second byte in case of 16bit images
-                    rgb.val[0] = (rgb.val[0]<<8) + ptr[1];
-                    rgb.val[1] = (rgb.val[1]<<8) + ptr[3];
-                    rgb.val[2] = (rgb.val[2]<<8) + ptr[5];
-                }
-
-                ycbcr = iftRGBtoYCbCrBT2020(rgb, depth, depth);
-
-                img->val[p] = ycbcr.val[0];
-                img->Cb[p]  = ycbcr.val[1];
-                img->Cr[p]  = ycbcr.val[2];
-
-                p++;
-            }
-        }
-    }else if(color_type == PNG_COLOR_TYPE_RGB_ALPHA){
-        iftSetCbCr(img, 128);
-        iftColor rgb, ycbcr;
-        if(img->alpha == NULL){
-            iftSetAlpha(img,0);
-        }
-
-        for (y=0; y<height; y++) {
-            png_byte* row = row_pointers[y];
-            for (x=0; x<width; x++) {
-                png_byte* ptr = &(row[x*numberChannels*byteshift]);
-                rgb.val[0] = ptr[0*byteshift];
-                rgb.val[1] = ptr[1*byteshift];
-                rgb.val[2] = ptr[2*byteshift];
-                ushort alpha = ptr[3*byteshift];
-
-                if(depth==16) { //read second byte in case of 16bit images
-                    rgb.val[0] = (rgb.val[0]<<8) + ptr[1];
-                    rgb.val[1] = (rgb.val[1]<<8) + ptr[3];
-                    rgb.val[2] = (rgb.val[2]<<8) + ptr[5];
-                    alpha = (alpha<<8) +  ptr[7];
-                }
-
-                ycbcr = iftRGBtoYCbCr(rgb, depth==8?255:65535);
-
-                img->val[p] = ycbcr.val[0];
-                img->Cb[p] = ycbcr.val[1];
-                img->Cr[p] = ycbcr.val[2];
-                img->alpha[p] = alpha;
-
-                p++;
-            }
-        }
-    }
+    _iftSetPNGChannels(img, png_get_color_type(png_ptr, info_ptr));
+    for (y=0; y<height; y++)
+        _iftPNGRowToImage(png_ptr, info_ptr, row_pointers[y], 0, width, img, img->tby[y]);
 
     for (y = 0; y < height; ++y) {
         iftFree(row_pointers[y]);
@@ -2240,6 +2393,7 @@ iftImage *iftCreateImageFromBuffer(int xsize, int ysize, int zsize, int *val)
     img->tby   = iftAllocIntArray(ysize);
     img->tbz   = iftAllocIntArray(zsize);
     img->n     = xsize * ysize * zsize;
+    img->mapped_size = 0;
 
     if (img->val == NULL || img->tbz == NULL || img->tby == NULL) {
         iftError(MSG_MEMORY_ALLOC_ERROR, "iftCreateImage");
@@ -3182,6 +3336,68 @@ iftMImage * iftCreateMImage(int xsize,int ysize,int zsize, int nbands)
   img->tby     = iftAllocIntArray(ysize);
   img->tbz     = iftAllocIntArray(zsize);
 
+  img->tby[0]=0;
+  for (y=1; y < ysize; y++)
+    img->tby[y]=img->tby[y-1] + xsize;
+
+  img->tbz[0]=0; xysize = xsize*ysize;
+  for (z=1; z < zsize; z++)
+    img->tbz[z]=img->tbz[z-1] + xysize;
+  img->mapped_size = 0;
+
+  return(img);
+}
+
+iftMImage *iftCreateMappedMImage(int xsize,int ysize,int zsize, int nbands,
+                                 const char *scratch_dir)
+{
+  iftMImage *img=NULL;
+  char      *mapped=NULL;
+  size_t     val_size, tbrow_size;
+  int        y,z,xysize;
+
+  // Spels are indexed by int along the library
+  if ((long) xsize * ysize * zsize > INT_MAX)
+      iftError("Volume of %dx%dx%d voxels exceeds %d voxels", "iftCreateMappedMImage",
+               xsize, ysize, zsize, INT_MAX);
+
+  img = (iftMImage *) iftAlloc(1,sizeof(iftMImage));
+  if (img == NULL){
+      iftError(MSG_MEMORY_ALLOC_ERROR, "iftCreateMappedMImage");
+  }
+
+  img->n       = xsize*ysize*zsize;
+  img->m       = nbands;
+
+  // Row pointers, row offsets and features, in this order, share one mapping
+  val_size         = (size_t) img->n * sizeof(float *);
+  tbrow_size       = (size_t) img->n * sizeof(long);
+  img->mapped_size = val_size + tbrow_size + 
+                     (size_t) img->n * img->m * sizeof(float);
+  mapped           = iftMapScratchFile(scratch_dir, img->mapped_size);
+
+  img->data            = (iftMatrix *) iftAlloc(1, sizeof(iftMatrix));
+  img->data->ncols     = img->m;
+  img->data->nrows     = img->n;
+  img->data->n         = (long) img->m * (long) img->n;
+  img->data->allocated = false;
+  img->data->tbrow     = (long *) (mapped + val_size);
+  img->data->val       = (float *) (mapped + val_size + tbrow_size);
+  img->val             = (float **) mapped;
+  for (long r = 0; r < (long) img->n; r++) {
+      img->data->tbrow[r] = r * img->m;
+      img->val[r]         = iftMatrixRowPointer(img->data, r);
+  }
+
+  img->xsize   = xsize;
+  img->ysize   = ysize;
+  img->zsize   = zsize;
+  img->dx      = 1.0;
+  img->dy      = 1.0;
+  img->dz      = 1.0;
+  img->tby     = iftAllocIntArray(ysize);
+  img->tbz     = iftAllocIntArray(zsize);
+
   img->tby[0]=0;
   for (y=1; y < ysize; y++)
     img->tby[y]=img->tby[y-1] + xsize;
@@ -3199,6 +3415,12 @@ void iftDestroyMImage(iftMImage **img)
 
     aux = *img;
     if (aux != NULL) {
+        if (aux->mapped_size > 0) { // val and data's arrays are in the mapping
+            iftUnmapScratchFile(aux->val, aux->mapped_size);
+            iftFree(aux->data);
+            aux->val  = NULL;
+            aux->data = NULL;
+        }
         if (aux->val != NULL)
             iftFree(aux->val);
         if (aux->data != NULL)
@@ -3212,6 +3434,28 @@ void iftDestroyMImage(iftMImage **img)
     }
 }
 
+float *iftMImageToAlignedArray(const iftMImage *img, int lanes)
+{
+  float *feats=NULL;
+
+  if (lanes < img->m)
+    iftError("The number of lanes must be at least the number of bands",
+             "iftMImageToAlignedArray");
+
+  // Every spel is 16-byte aligned whenever lanes is a multiple of 4
+  if (posix_memalign((void **)&feats, 16, (size_t)img->n*lanes*sizeof(float)) != 0)
+    iftError(MSG_MEMORY_ALLOC_ERROR, "iftMImageToAlignedArray");
+
+  for (int p = 0; p < img->n; p++) {
+    for (int b = 0; b < img->m; b++)
+      feats[p*lanes + b] = img->val[p][b];
+    for (int b = img->m; b < lanes; b++)
+      feats[p*lanes + b] = 0.0; // Padding does not affect the distances
+  }
+
+  return(feats);
+}
+
 iftMImage * iftImageToMImage(const iftImage *img1, char color_space)
 {
   iftMImage *img2=NULL;
@@ -4094,6 +4338,45 @@ char *iftGetLine(FILE *stream) {
     
     return line;
 }
+
+#include <sys/mman.h>
+
+void *iftMapScratchFile(const char *dir, size_t size)
+{
+    char *path = NULL;
+    void *ptr  = NULL;
+    int   fd;
+
+    if (size == 0)
+        size = 1; // Empty mappings are invalid
+
+    path = iftJoinPathnames(2, dir, "iftscratch_XXXXXX");
+    fd   = mkstemp(path);
+    if (fd == -1)
+        iftError("Cannot create a scratch file within %s", "iftMapScratchFile", dir);
+    unlink(path); // Released as soon as it is unmapped
+    iftFree(path);
+
+    if (ftruncate(fd, (off_t) size) != 0) {
+        close(fd);
+        iftError("Cannot reserve %lu bytes for a scratch file", "iftMapScratchFile", 
+                 (unsigned long) size);
+    }
+
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file alive
+    if (ptr == MAP_FAILED)
+        iftError("Cannot map a scratch file of %lu bytes", "iftMapScratchFile",
+                 (unsigned long) size);
+
+    return ptr;
+}
+
+void iftUnmapScratchFile(void *ptr, size_t size)
+{
+    if (ptr != NULL)
+        munmap(ptr, (size == 0) ? 1 : size);
+}
 // ---------- iftStream.c end
 // ---------- iftString.c start 
 
@@ -4974,6 +5257,310 @@ iftImage* iftReadImageFolderAsVolume(const char* folder_name)
     return volume;
 }
 
+iftMImage *iftReadImageFolderAsMappedMImage(const char *folder_name,
+                                            char color_space,
+                                            const char *scratch_dir)
+{
+    int z, normalization_value = 0;
+    bool is_color, use_lab;
+    iftMImage *volume = NULL;
+    iftFileSet *files = NULL;
+    iftImage *slice = NULL;
+
+    if (color_space != LAB_CSPACE && color_space != GRAY_CSPACE)
+        iftError("Only the LAB_CSPACE and GRAY_CSPACE color spaces are supported",
+                 "iftReadImageFolderAsMappedMImage");
+
+    files = iftLoadFileSetFromDirOrCSV(folder_name, 0, true);
+
+    for(z = 0; z < files->n; z++)
+    {
+        const char *path = files->files[z]->path;
+        if(!iftIsImageFile(path) || iftCompareStrings(iftFileExt(path),".scn")) {
+            iftError("File %s cannot be read as an image for constructing a 3D volume!", 
+                     "iftReadImageFolderAsMappedMImage", path);
+        }
+    }
+
+    // The first slice defines the volume's domain and type
+    slice    = iftReadImageByExt(files->files[0]->path);
+    is_color = iftIsColorImage(slice);
+    use_lab  = is_color && color_space == LAB_CSPACE;
+    volume   = iftCreateMappedMImage(slice->xsize, slice->ysize, files->n,
+                                     (use_lab) ? 3 : 1, scratch_dir);
+    iftDestroyImage(&slice);
+
+    if (use_lab) { // Normalized by the volume's maximum, as in iftImageToMImage
+        int max_val = 0;
+
+        for(z = 0; z < files->n; z++) {
+            slice   = iftReadImageByExt(files->files[z]->path);
+            max_val = iftMax(max_val, iftMaximumValue(slice));
+            iftDestroyImage(&slice);
+        }
+        normalization_value = iftNormalizationValue(max_val);
+    }
+
+    for(z = 0; z < files->n; z++)
+    {
+        const char *path = files->files[z]->path;
+        float **val;
+
+        slice = iftReadImageByExt(path);
+
+        if(slice->xsize != volume->xsize || slice->ysize != volume->ysize)
+            iftError("The XY dimensions of the current image being loaded (%s) differs from the first image selected" \
+            "for initializing the volume! First image: %d %d %d, current image: %d %d %d\n",
+                     "iftReadImageFolderAsMappedMImage",
+                     path, volume->xsize, volume->ysize, volume->zsize,
+                     slice->xsize, slice->ysize, slice->zsize);
+
+        if(iftIsColorImage(slice) != is_color) {
+            iftError(
+                    "Both the current slice (%s) image being loaded and the first one must either be colored or grayscaled!",
+                    "iftReadImageFolderAsMappedMImage", path);
+        }
+
+        val = &(volume->val[volume->tbz[z]]); // Slab of the slice
+#if IFT_OMP
+#pragma omp parallel for shared(slice, val, normalization_value)
+#endif
+        for (int p=0; p < slice->n; p++) {
+            if (use_lab) {
+                iftColor  YCbCr,RGB;
+                iftFColor Lab;
+                YCbCr.val[0] = slice->val[p];
+                YCbCr.val[1] = slice->Cb[p];
+                YCbCr.val[2] = slice->Cr[p];
+                RGB = iftYCbCrtoRGB(YCbCr,normalization_value);
+                Lab = iftRGBtoLab(RGB,normalization_value);
+                val[p][0]=Lab.val[0];
+                val[p][1]=Lab.val[1];
+                val[p][2]=Lab.val[2];
+            }
+            else
+                val[p][0]=((float)slice->val[p]);
+        }
+
+        iftDestroyImage(&slice);
+    }
+    iftDestroyFileSet(&files);
+
+    return volume;
+}
+
+/*
+ * Parses the header of a binary PNM file (P5/P6), leaving the stream at the
+ * first pixel. Returns false if the file is of another type.
+ */
+bool _iftReadPNMHeader(FILE *fp, char *type, int *xsize, int *ysize, int *maxval)
+{
+    if (fscanf(fp, "%9s\n", type) != 1)
+        return false;
+    if (!iftCompareStrings(type, "P5") && !iftCompareStrings(type, "P6"))
+        return false;
+
+    iftSkipComments(fp);
+    if (fscanf(fp, "%d %d\n", xsize, ysize) != 2)
+        return false;
+    if (fscanf(fp, "%d", maxval) != 1)
+        return false;
+    while (fgetc(fp) != '\n');
+
+    return true;
+}
+
+/*
+ * Checks whether a file is a PNG one by its extension.
+ */
+bool _iftIsPNGFile(const char *filename)
+{
+    char *ext = iftLowerString(iftFileExt(filename));
+    bool is_png = iftCompareStrings(ext, ".png");
+
+    iftFree(ext);
+    return is_png;
+}
+
+iftImageDomain iftReadImageDomain(const char *filename)
+{
+    char type[10];
+    int maxval;
+    FILE *fp = NULL;
+    iftImageDomain dom;
+
+    dom.zsize = 1;
+    if (_iftIsPNGFile(filename)) {
+        #if IFT_LIBPNG
+        png_structp png_ptr;
+        png_infop info_ptr;
+
+        fp = _iftOpenPNG(filename, &png_ptr, &info_ptr);
+        if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE)
+            iftError("Interlaced PNG %s cannot be read by regions", "iftReadImageDomain",
+                     filename);
+        dom.xsize = png_get_image_width(png_ptr, info_ptr);
+        dom.ysize = png_get_image_height(png_ptr, info_ptr);
+        png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        fclose(fp);
+        #else
+        iftError("LibPNG support was not enabled!", "iftReadImageDomain");
+        #endif
+
+        return dom;
+    }
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL)
+        iftError(MSG_FILE_OPEN_ERROR, "iftReadImageDomain", filename);
+    if (!_iftReadPNMHeader(fp, type, &dom.xsize, &dom.ysize, &maxval))
+        iftError("Image %s cannot be read by regions. Try binary .pgm/.ppm or .png",
+                 "iftReadImageDomain", filename);
+    fclose(fp);
+
+    return dom;
+}
+
+/*
+ * Clips a bounding box to a 2D image's domain.
+ */
+void _iftClipRegion(iftBoundingBox *bb, int xsize, int ysize)
+{
+    bb->begin.x = iftMax(bb->begin.x, 0); bb->end.x = iftMin(bb->end.x, xsize - 1);
+    bb->begin.y = iftMax(bb->begin.y, 0); bb->end.y = iftMin(bb->end.y, ysize - 1);
+    if (bb->begin.x > bb->end.x || bb->begin.y > bb->end.y)
+        iftError("The region is outside the image's domain", "iftReadImageRegion");
+}
+
+#if IFT_LIBPNG
+/*
+ * Reads the region of a PNG file by decoding its rows up to the region's last
+ * one, so only a single row and the region are kept in memory.
+ */
+iftImage *_iftReadPNGRegion(const char *filename, iftBoundingBox bb)
+{
+    png_structp png_ptr;
+    png_infop info_ptr;
+    png_bytep row;
+    iftImage *region = NULL;
+    FILE *fp = NULL;
+
+    fp = _iftOpenPNG(filename, &png_ptr, &info_ptr);
+    if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE)
+        iftError("Interlaced PNG %s cannot be read by regions", "iftReadImageRegion",
+                 filename);
+    _iftClipRegion(&bb, png_get_image_width(png_ptr, info_ptr), 
+                   png_get_image_height(png_ptr, info_ptr));
+
+    region = iftCreateImage(bb.end.x - bb.begin.x + 1, bb.end.y - bb.begin.y + 1, 1);
+    region->dz = 0.0;
+    _iftSetPNGChannels(region, png_get_color_type(png_ptr, info_ptr));
+
+    if (setjmp(png_jmpbuf(png_ptr)))
+        iftError("Internal error: Error during read_row", "iftReadImageRegion");
+
+    row = (png_bytep) iftAlloc(png_get_rowbytes(png_ptr, info_ptr), 1);
+    for (int y = 0; y <= bb.end.y; y++) {
+        png_read_row(png_ptr, row, NULL);
+        if (y >= bb.begin.y)
+            _iftPNGRowToImage(png_ptr, info_ptr, row, bb.begin.x, region->xsize,
+                              region, region->tby[y - bb.begin.y]);
+    }
+    iftFree(row);
+
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    fclose(fp);
+
+    return region;
+}
+#endif
+
+iftImage *iftReadImageRegion(const char *filename, iftBoundingBox bb)
+{
+    char type[10];
+    int xsize, ysize, maxval, nchannels, nbytes, rgbBitDepth, ycbcrBitDepth;
+    long data_start;
+    FILE *fp = NULL;
+    iftImage *region = NULL;
+
+    if (_iftIsPNGFile(filename)) {
+        #if IFT_LIBPNG
+        return _iftReadPNGRegion(filename, bb);
+        #else
+        iftError("LibPNG support was not enabled!", "iftReadImageRegion");
+        #endif
+    }
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL)
+        iftError(MSG_FILE_OPEN_ERROR, "iftReadImageRegion", filename);
+    if (!_iftReadPNMHeader(fp, type, &xsize, &ysize, &maxval))
+        iftError("Image %s cannot be read by regions. Try binary .pgm/.ppm or .png",
+                 "iftReadImageRegion", filename);
+    if (maxval <= 0 || maxval > 65535)
+        iftError("Invalid maximum value", "iftReadImageRegion");
+
+    _iftClipRegion(&bb, xsize, ysize);
+
+    nchannels = iftCompareStrings(type, "P6") ? 3 : 1;
+    nbytes = (maxval > 255) ? 2 : 1; // 16-bit samples are big endian
+    data_start = ftell(fp);
+
+    // Same conversion of 16-bit colors as iftReadImageP6
+    rgbBitDepth = ceil(iftLog(maxval, 2));
+    if (rgbBitDepth < 10) ycbcrBitDepth = 10;
+    else if (rgbBitDepth < 12) ycbcrBitDepth = 12;
+    else if (rgbBitDepth < 16) ycbcrBitDepth = 16;
+    else ycbcrBitDepth = rgbBitDepth;
+
+    region = iftCreateImage(bb.end.x - bb.begin.x + 1, bb.end.y - bb.begin.y + 1, 1);
+    region->dz = 0.0;
+    if (nchannels == 3) {
+        region->Cb = iftAllocUShortArray(region->n);
+        region->Cr = iftAllocUShortArray(region->n);
+    }
+
+    uchar *row = iftAllocUCharArray(region->xsize * nchannels * nbytes);
+    for (int y = bb.begin.y; y <= bb.end.y; y++) {
+        long offset = data_start + ((long) y * xsize + bb.begin.x) * nchannels * nbytes;
+
+        if (fseek(fp, offset, SEEK_SET) != 0 ||
+            fread(row, nchannels * nbytes, region->xsize, fp) != (size_t) region->xsize)
+            iftError("Reading error", "iftReadImageRegion");
+
+        for (int x = 0; x < region->xsize; x++) {
+            int q = x + region->tby[y - bb.begin.y];
+            int sample[3];
+
+            for (int c = 0; c < nchannels; c++) {
+                uchar *ptr = &(row[(x * nchannels + c) * nbytes]);
+
+                sample[c] = (nbytes == 2) ? ((ptr[0] << 8) + ptr[1]) : ptr[0];
+            }
+
+            if (nchannels == 3) {
+                iftColor RGB, YCbCr;
+
+                RGB.val[0] = sample[0];
+                RGB.val[1] = sample[1];
+                RGB.val[2] = sample[2];
+                if (nbytes == 1)
+                    YCbCr = iftRGBtoYCbCr(RGB, 255);
+                else
+                    YCbCr = iftRGBtoYCbCrBT2020(RGB, rgbBitDepth, ycbcrBitDepth);
+                region->val[q] = YCbCr.val[0];
+                region->Cb[q] = (ushort) YCbCr.val[1];
+                region->Cr[q] = (ushort) YCbCr.val[2];
+            }
+            else region->val[q] = sample[0];
+        }
+    }
+    iftFree(row);
+    fclose(fp);
+
+    return region;
+}
+
 
 void iftWriteVolumeAsVideoFolder(iftImage *video, const char *folder_name, char *frame_name)
 {
@@ -8,6 +8,21 @@
 \*****************************************************************************/
 #include "iftMetrics.h"
 
+//############################################################################|
+// 
+//  STRUCTS, ENUMS, UNIONS & TYPEDEFS
+//
+//############################################################################|
+// Sparse contingency table of superspels and ground-truth objects, whose 
+// intersections are grouped by superspel and ordered by object (CSR)
+typedef struct _iftmetrics_contab
+{
+  int num_labels; // Number of superspels (i.e., of the label range)
+  int *first; // Superspel's first intersection within gt and size
+  int *gt; // Intersection's ground-truth object (i.e., its value)
+  int *size; // Intersection's size
+} iftMetrics_ConTab;
+
 //############################################################################|
 // 
 //  PRIVATE METHODS
@@ -16,47 +31,149 @@
 //===========================================================================//
 // General & Auxiliary
 //===========================================================================//
+// Orders integers increasingly
+int iftMetrics_CmpInts
+(const void *a, const void *b)
+{
+  int ia, ib;
+
+  ia = *(const int*)a; ib = *(const int*)b;
+  return (ia > ib) - (ia < ib);
+}
+
 /*
- * Gets the size of the intersections between ground-truth objects and 
- * superspels. 
+ * Creates the sparse contingency table of the intersections between 
+ * superspels and ground-truth objects. Its memory depends on the number of
+ * actual intersections, rather than on the label and ground-truth ranges. The
+ * spels' objects are bucketed by superspel, and each bucket is sorted and 
+ * counted in parallel.
  *
  * PARAMETERS:
  *  label_img[in] - REQUIRED: Superspel segmentation
  *  gt_img[in] - REQUIRED: Ground-truth
  *
- * RETURNS: Matrix Superspel x GT Object, whose value is the intersection size
+ * RETURNS: Contingency table, whose superspels are shifted by the minimum 
+ *          label
  */
-int **iftMetrics_CalcLabelGTIntersec
+iftMetrics_ConTab *iftMetrics_CreateConTab
 (iftImage *label_img, iftImage *gt_img)
 {
-  int min_label, max_label, num_labels, min_gt, max_gt, num_gt;
-  int **inter;
+  int min_label, max_label, num_labels;
+  int *start, *pos, *bucket;
+  iftMetrics_ConTab *tab;
 
   iftMinMaxValues(label_img, &min_label, &max_label);
   num_labels = max_label - min_label + 1;
-  iftMinMaxValues(gt_img, &min_gt, &max_gt);
-  num_gt = max_gt - min_gt + 1;
 
-  inter = calloc(num_labels, sizeof(int*));
-  assert(inter != NULL);
+  start = calloc(num_labels + 1, sizeof(int));
+  assert(start != NULL);
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+  #pragma omp parallel for reduction(+:start[:num_labels + 1])
+  #endif //-------------------------------------------------------------------|
+  for(int p = 0; p < label_img->n; ++p)
+  { start[label_img->val[p] - min_label + 1]++; }
+  for(int i = 0; i < num_labels; ++i) { start[i + 1] += start[i]; }
+
+  // Objects of the spels, grouped by superspel
+  bucket = malloc(label_img->n * sizeof(int));
+  assert(bucket != NULL);
+  pos = malloc(num_labels * sizeof(int));
+  assert(pos != NULL);
+  memcpy(pos, start, num_labels * sizeof(int));
+  for(int p = 0; p < label_img->n; ++p)
+  { bucket[pos[label_img->val[p] - min_label]++] = gt_img->val[p]; }
+
+  tab = malloc(sizeof(iftMetrics_ConTab));
+  assert(tab != NULL);
+  tab->num_labels = num_labels;
+  tab->first = calloc(num_labels + 1, sizeof(int));
+  assert(tab->first != NULL);
 
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+  #pragma omp parallel for schedule(dynamic, 64)
+  #endif //-------------------------------------------------------------------|
   for(int i = 0; i < num_labels; ++i)
   {
-    inter[i] = calloc(num_gt, sizeof(int));
-    assert(inter[i] != NULL);
+    int num_inter;
+
+    qsort(bucket + start[i], start[i + 1] - start[i], sizeof(int), 
+          iftMetrics_CmpInts);
+    num_inter = 0;
+    for(int k = start[i]; k < start[i + 1]; ++k)
+    { if(k == start[i] || bucket[k] != bucket[k - 1]) { num_inter++; } }
+    tab->first[i + 1] = num_inter;
   }
+  for(int i = 0; i < num_labels; ++i) { tab->first[i + 1] += tab->first[i]; }
 
-  for(int p = 0; p < label_img->n; ++p)
+  tab->gt = malloc((tab->first[num_labels] + 1) * sizeof(int));
+  assert(tab->gt != NULL);
+  tab->size = malloc((tab->first[num_labels] + 1) * sizeof(int));
+  assert(tab->size != NULL);
+
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+  #pragma omp parallel for schedule(dynamic, 64)
+  #endif //-------------------------------------------------------------------|
+  for(int i = 0; i < num_labels; ++i)
   {
-    int label, gt;
+    int idx;
+
+    idx = tab->first[i] - 1;
+    for(int k = start[i]; k < start[i + 1]; ++k)
+    {
+      if(k == start[i] || bucket[k] != bucket[k - 1]) 
+      { ++idx; tab->gt[idx] = bucket[k]; tab->size[idx] = 0; }
+      tab->size[idx]++;
+    }
+  }
 
-    label = label_img->val[p] - min_label;
-    gt = gt_img->val[p] - min_gt;
+  free(start); free(pos); free(bucket);
+  return tab;
+}
 
-    inter[label][gt]++;
+/*
+ * Deallocates the contingency table's memory
+ *
+ * PARAMETERS:
+ *  tab[in/out] - REQUIRED: Pointer to the contingency table to be free'd
+ */
+void iftMetrics_DestroyConTab
+(iftMetrics_ConTab **tab)
+{
+  if((*tab) != NULL)
+  {
+    free((*tab)->first); free((*tab)->gt); free((*tab)->size);
+    free(*tab);
+    (*tab) = NULL;
   }
+}
+
+/*
+ * Gets the size of the intersection between a superspel and a ground-truth
+ * object within the contingency table
+ *
+ * PARAMETERS:
+ *  tab[in] - REQUIRED: Contingency table
+ *  i[in] - REQUIRED: Superspel's index within the table
+ *  gt[in] - REQUIRED: Ground-truth object
+ *
+ * RETURNS: Intersection size, or 0 if they do not intersect
+ */
+int iftMetrics_GetConTabSize
+(const iftMetrics_ConTab *tab, int i, int gt)
+{
+  int lo, hi;
 
-  return inter;
+  lo = tab->first[i]; hi = tab->first[i + 1] - 1;
+  while(lo <= hi) // Ordered by object
+  {
+    int mid;
+
+    mid = (lo + hi) / 2;
+    if(tab->gt[mid] == gt) { return tab->size[mid]; }
+    else if(tab->gt[mid] < gt) { lo = mid + 1; }
+    else { hi = mid - 1; }
+  }
+  return 0;
 }
 
 //############################################################################|
@@ -422,35 +539,27 @@ float iftEvalASA
   assert(gt_img != NULL);
   iftVerifyImageDomains(label_img, gt_img, __func__);
   #endif //-------------------------------------------------------------------|
-  int min_label, max_label, num_labels, min_gt, max_gt, num_gt;
   float achi_segm;
-  int **inter;
+  iftMetrics_ConTab *tab;
 
-  iftMinMaxValues(label_img, &min_label, &max_label);
-  num_labels = max_label - min_label + 1;
-  iftMinMaxValues(gt_img, &min_gt, &max_gt);
-  num_gt = max_gt - min_gt + 1;
-
-  inter = iftMetrics_CalcLabelGTIntersec(label_img, gt_img);
+  tab = iftMetrics_CreateConTab(label_img, gt_img);
 
   achi_segm = 0.0;
   #ifdef IFT_OMP //-----------------------------------------------------------|
   #pragma omp parallel for reduction(+:achi_segm)
   #endif //-------------------------------------------------------------------|
-  for(int i = 0; i < num_labels; ++i)
+  for(int i = 0; i < tab->num_labels; ++i)
   {
     int max_inter;
 
     max_inter = 0;
-    for(int j = 0; j < num_gt; ++j)
+    for(int k = tab->first[i]; k < tab->first[i + 1]; ++k)
     { 
-      if(inter[i][j] > max_inter) { max_inter = inter[i][j]; }
+      if(tab->size[k] > max_inter) { max_inter = tab->size[k]; }
     }
     achi_segm += max_inter;
   }
-  for(int i = 0; i < num_labels; ++i) 
-  { free(inter[i]); }
-  free(inter);
+  iftMetrics_DestroyConTab(&tab);
 
   achi_segm /= (float)label_img->n;
 
@@ -529,35 +638,32 @@ float iftEvalDICE
   assert(gt_img != NULL);
   iftVerifyImageDomains(label_img, gt_img, __func__);
   #endif //-------------------------------------------------------------------|
-  int min_label, max_label, num_labels, min_gt, max_gt, num_gt, max_inter_label;
+  int max_inter_label, max_inter, obj_size;
   float dice, div;
-  int **inter;
+  iftMetrics_ConTab *tab;
 
-  iftMinMaxValues(label_img, &min_label, &max_label);
-  num_labels = max_label - min_label + 1;
-  iftMinMaxValues(gt_img, &min_gt, &max_gt);
-  num_gt = max_gt - min_gt + 1;
+  tab = iftMetrics_CreateConTab(label_img, gt_img);
+
+  max_inter_label = 0; max_inter = 0; obj_size = 0;
+  for(int i = 0; i < tab->num_labels; ++i)
+  {
+    int inter;
 
+    inter = iftMetrics_GetConTabSize(tab, i, obj_label);
+    if(inter > max_inter) { max_inter_label = i; max_inter = inter; }
+    obj_size += inter;
+  }
   #ifdef IFT_DEBUG //---------------------------------------------------------|
-  assert(obj_label >= min_gt && obj_label <= max_gt);
+  assert(obj_size > 0);
   #endif //-------------------------------------------------------------------|
 
-  inter = iftMetrics_CalcLabelGTIntersec(label_img, gt_img);
-
-  max_inter_label = 0;
-  for(int i = 1; i < num_labels; ++i)
-  {
-    if(inter[i][obj_label] > inter[max_inter_label][obj_label]) 
-    { max_inter_label = i; }
-  }
-  div = 0.0;
-  for(int j = 0; j < num_gt; ++j) { div += inter[max_inter_label][j]; }
-  for(int i = 0; i < num_labels; ++i) { div += inter[i][obj_label]; }
+  div = obj_size;
+  for(int k = tab->first[max_inter_label]; 
+      k < tab->first[max_inter_label + 1]; ++k)
+  { div += tab->size[k]; }
 
-  dice = (2.0 * inter[max_inter_label][obj_label])/div;
-  for(int i = 0; i < num_labels; ++i) 
-  { free(inter[i]); }
-  free(inter);
+  dice = (2.0 * max_inter)/div;
+  iftMetrics_DestroyConTab(&tab);
 
   return dice;
 }
@@ -570,41 +676,288 @@ float iftEvalUE
   assert(gt_img != NULL);
   iftVerifyImageDomains(label_img, gt_img, __func__);
   #endif //-------------------------------------------------------------------|
-  int min_label, max_label, num_labels, min_gt, max_gt, num_gt;
   float under_segm;
-  int **inter;
-
-  iftMinMaxValues(label_img, &min_label, &max_label);
-  num_labels = max_label - min_label + 1;
-  iftMinMaxValues(gt_img, &min_gt, &max_gt);
-  num_gt = max_gt - min_gt + 1;
+  iftMetrics_ConTab *tab;
 
-  inter = iftMetrics_CalcLabelGTIntersec(label_img, gt_img);
+  tab = iftMetrics_CreateConTab(label_img, gt_img);
 
   under_segm = 0.0;
   #ifdef IFT_OMP //-----------------------------------------------------------|
   #pragma omp parallel for reduction(+:under_segm)
   #endif //-------------------------------------------------------------------|
-  for(int i = 0; i < num_labels; ++i)
+  for(int i = 0; i < tab->num_labels; ++i)
   {
     int error, size;
 
     size = 0;
-    for(int j = 0; j < num_gt; ++j) { size += inter[i][j]; }
+    for(int k = tab->first[i]; k < tab->first[i + 1]; ++k) 
+    { size += tab->size[k]; }
 
     error = 0;
-    for(int j = 0; j < num_gt; ++j)
-    {
-      if(inter[i][j] > 0) 
-      // sum(min{|S_i ^ G_j|, |S_i - G_j|})
-      { error += iftMin(inter[i][j], size - inter[i][j]); } 
-    }
+    for(int k = tab->first[i]; k < tab->first[i + 1]; ++k)
+    // sum(min{|S_i ^ G_j|, |S_i - G_j|})
+    { error += iftMin(tab->size[k], size - tab->size[k]); } 
     under_segm += error;
   }
-  for(int i = 0; i < num_labels; ++i) { free(inter[i]); }
-  free(inter);
+  iftMetrics_DestroyConTab(&tab);
 
   under_segm /= (float)label_img->n;
 
   return under_segm;
 }
+
+//===========================================================================//
+// Fused
+//===========================================================================//
+iftSuperspelMetrics iftEvalSuperspelMetrics
+(iftImage *label_img, iftImage *orig_img, iftImage *gt_img, int metrics,
+ int obj_label)
+{
+  #ifdef IFT_DEBUG //---------------------------------------------------------|
+  assert(label_img != NULL);
+  if(orig_img != NULL) 
+  { iftVerifyImageDomains(orig_img, label_img, __func__); }
+  if(gt_img != NULL) { iftVerifyImageDomains(label_img, gt_img, __func__); }
+  #endif //-------------------------------------------------------------------|
+  bool need_border, need_br, need_ev, need_tex, need_tab, is_color;
+  int min_label, max_label, num_labels, num_border, num_ev, num_tex;
+  int count_borders, tp, fn;
+  double sum_feat, sum_feat_sq;
+  int *area, *perim, *min_frame, *max_frame;
+  double *sup_feat;
+  iftAdjRel *A, *B;
+  iftSuperspelMetrics res;
+
+  need_border = (metrics & (IFT_METRICS_CD | IFT_METRICS_CO)) != 0;
+  need_br = (metrics & IFT_METRICS_BR) != 0;
+  need_ev = (metrics & IFT_METRICS_EV) != 0;
+  need_tex = (metrics & IFT_METRICS_TEX) != 0;
+  need_tab = (metrics & (IFT_METRICS_ASA|IFT_METRICS_UE|IFT_METRICS_DICE)) != 0;
+  if((need_br || need_tab) && gt_img == NULL)
+  { iftError("The requested metrics need a ground-truth", __func__); }
+  if(need_ev && orig_img == NULL)
+  { iftError("The requested metrics need the original image", __func__); }
+
+  res.asa = res.br = res.cd = res.co = res.ev = res.tex = res.ue = NAN;
+  res.dice = NAN;
+
+  iftMinMaxValues(label_img, &min_label, &max_label);
+  num_labels = max_label - min_label + 1;
+  res.num_labels = num_labels;
+
+  // Unrequested per-superspel arrays are kept with a single dummy element
+  num_border = need_border ? num_labels : 1;
+  num_ev = need_ev ? num_labels : 1;
+  num_tex = need_tex ? num_labels : 1;
+  is_color = need_ev && iftIsColorImage(orig_img);
+
+  area = calloc(num_labels, sizeof(int));
+  assert(area != NULL);
+  perim = calloc(num_border, sizeof(int));
+  assert(perim != NULL);
+  sup_feat = calloc(num_ev, sizeof(double));
+  assert(sup_feat != NULL);
+  min_frame = malloc(num_tex * sizeof(int));
+  assert(min_frame != NULL);
+  max_frame = malloc(num_tex * sizeof(int));
+  assert(max_frame != NULL);
+  for(int i = 0; i < num_tex; ++i) 
+  { min_frame[i] = label_img->zsize - 1; max_frame[i] = 0; }
+
+  if(iftIs3DImage(label_img) == true) { A = iftSpheric(sqrtf(3.0)); }
+  else { A = iftCircular(sqrtf(2.0)); }
+  B = NULL;
+  if(need_br)
+  {
+    float r;
+
+    r = ceil(0.0025 * iftDiagonalSize(label_img)); // Stutz et al.
+    if(iftIs3DImage(label_img) == true) { B = iftSpheric(r * sqrtf(3.0)); }
+    else { B = iftCircular(r * sqrtf(2.0)); }
+  }
+
+  count_borders = tp = fn = 0;
+  sum_feat = sum_feat_sq = 0.0;
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+  #pragma omp parallel for reduction(+:count_borders, tp, fn, sum_feat, \
+    sum_feat_sq, area[:num_labels], perim[:num_border], sup_feat[:num_ev]) \
+    reduction(min:min_frame[:num_tex]) reduction(max:max_frame[:num_tex])
+  #endif //-------------------------------------------------------------------|
+  for(int p = 0; p < label_img->n; ++p)
+  {
+    int p_label;
+    iftVoxel p_vxl;
+
+    p_vxl = iftGetVoxelCoord(label_img, p);
+    p_label = label_img->val[p] - min_label;
+    area[p_label]++;
+
+    if(need_border) // CD and CO
+    {
+      bool is_border;
+
+      is_border = false;
+      for(int i = 1; i < A->n && !is_border; ++i)
+      {
+        iftVoxel adj_vxl;
+
+        adj_vxl = iftGetAdjacentVoxel(A, p_vxl, i);
+        if(iftValidVoxel(label_img, adj_vxl) == false) { is_border = true; }
+        else 
+        { 
+          is_border = label_img->val[p] != 
+                      label_img->val[iftGetVoxelIndex(label_img, adj_vxl)];
+        }
+      }
+      if(is_border) { count_borders++; perim[p_label]++; }
+    }
+
+    if(need_br)
+    {
+      bool is_label_border, is_gt_border;
+
+      is_gt_border = is_label_border = false;
+      for(int i = 1; i < B->n && !(is_gt_border && is_label_border); ++i)
+      {
+        iftVoxel adj_vxl;
+
+        adj_vxl = iftGetAdjacentVoxel(B, p_vxl, i);
+        if(iftValidVoxel(label_img, adj_vxl) == true) 
+        {
+          int adj_idx;
+
+          adj_idx = iftGetVoxelIndex(label_img, adj_vxl);
+          if(gt_img->val[p] != gt_img->val[adj_idx]) { is_gt_border = true; }
+          if(label_img->val[p] != label_img->val[adj_idx])
+          { is_label_border = true; }
+        }
+        else { is_gt_border = is_label_border = true; } // Limits of the image
+      }
+      if(is_gt_border == true)
+      {
+        if(is_label_border == true) { tp++; }
+        else { fn++; }
+      }
+    }
+
+    if(need_ev) // Sum of the channels, as in iftEvalEV
+    {
+      double feat;
+
+      feat = orig_img->val[p];
+      if(is_color) { feat += orig_img->Cb[p] + orig_img->Cr[p]; }
+      sup_feat[p_label] += feat;
+      sum_feat += feat; sum_feat_sq += feat * feat;
+    }
+
+    if(need_tex)
+    {
+      min_frame[p_label] = iftMin(min_frame[p_label], p_vxl.z);
+      max_frame[p_label] = iftMax(max_frame[p_label], p_vxl.z);
+    }
+  }
+  iftDestroyAdjRel(&A);
+  if(B != NULL) { iftDestroyAdjRel(&B); }
+
+  if(metrics & IFT_METRICS_CD) { res.cd = count_borders/(float)label_img->n; }
+  if(metrics & IFT_METRICS_BR) { res.br = tp/(float)(tp + fn); }
+  if(metrics & IFT_METRICS_CO)
+  {
+    float compac;
+
+    compac = 0.0;
+    #ifdef IFT_OMP //---------------------------------------------------------|
+    #pragma omp parallel for reduction(+:compac)
+    #endif //-----------------------------------------------------------------|
+    for(int i = 0; i < num_labels; ++i)
+    {
+      float ratio;
+
+      // Normalize to [0,1]
+      if(iftIs3DImage(label_img) == false)
+      { ratio = (4.0 * IFT_PI * area[i])/(perim[i]*perim[i]); }
+      else
+      { ratio = (6.0 * sqrtf(IFT_PI) * area[i])/(pow(perim[i],1.5)); }
+      compac += ratio * area[i]/(float)label_img->n;
+    }
+    res.co = compac;
+  }
+  if(need_ev)
+  {
+    double mean_feat, img_diff, expl_var;
+
+    // sum((spel - mean(I))^2), from the moments of the channels' sum
+    mean_feat = sum_feat / label_img->n;
+    img_diff = sum_feat_sq - label_img->n * mean_feat * mean_feat;
+
+    expl_var = 0.0;
+    #ifdef IFT_OMP //---------------------------------------------------------|
+    #pragma omp parallel for reduction(+:expl_var)
+    #endif //-----------------------------------------------------------------|
+    for(int i = 0; i < num_labels; ++i)
+    {
+      double dist;
+
+      dist = sup_feat[i] / area[i] - mean_feat;
+      expl_var += (area[i] * (dist * dist))/img_diff;
+    }
+    res.ev = expl_var;
+  }
+  if(need_tex)
+  {
+    float tex;
+
+    tex = 0;
+    for(int i = 0; i < num_labels; ++i)
+    { tex += max_frame[i] - min_frame[i] + 1;}
+    res.tex = tex / (float)(label_img->zsize * num_labels);
+  }
+  free(perim); free(sup_feat); free(min_frame); free(max_frame);
+
+  if(need_tab) // ASA, UE and DICE
+  {
+    int max_inter_label, max_inter, obj_size;
+    float achi_segm, under_segm;
+    iftMetrics_ConTab *tab;
+
+    tab = iftMetrics_CreateConTab(label_img, gt_img);
+
+    achi_segm = under_segm = 0.0;
+    #ifdef IFT_OMP //---------------------------------------------------------|
+    #pragma omp parallel for reduction(+:achi_segm, under_segm)
+    #endif //-----------------------------------------------------------------|
+    for(int i = 0; i < num_labels; ++i)
+    {
+      int max_size, error;
+
+      max_size = error = 0;
+      for(int k = tab->first[i]; k < tab->first[i + 1]; ++k)
+      {
+        if(tab->size[k] > max_size) { max_size = tab->size[k]; }
+        // sum(min{|S_i ^ G_j|, |S_i - G_j|})
+        error += iftMin(tab->size[k], area[i] - tab->size[k]);
+      }
+      achi_segm += max_size; under_segm += error;
+    }
+    if(metrics & IFT_METRICS_ASA) { res.asa = achi_segm/(float)label_img->n; }
+    if(metrics & IFT_METRICS_UE) { res.ue = under_segm/(float)label_img->n; }
+
+    if(metrics & IFT_METRICS_DICE)
+    {
+      max_inter_label = 0; max_inter = 0; obj_size = 0;
+      for(int i = 0; i < num_labels; ++i)
+      {
+        int inter;
+
+        inter = iftMetrics_GetConTabSize(tab, i, obj_label);
+        if(inter > max_inter) { max_inter_label = i; max_inter = inter; }
+        obj_size += inter;
+      }
+      res.dice = (2.0 * max_inter)/(float)(obj_size + area[max_inter_label]);
+    }
+    iftMetrics_DestroyConTab(&tab);
+  }
+  free(area);
+
+  return res;
+}
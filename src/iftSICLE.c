@@ -8,21 +8,45 @@
 \*****************************************************************************/
 #include "iftSICLE.h"
 
+#include <pthread.h>
+
+#ifdef IFT_OMP //-------------------------------------------------------------|
+#include <omp.h>
+#endif //---------------------------------------------------------------------|
+
 //############################################################################|
 // 
 //	MACROS
 //
 //############################################################################|
 #define IFTSICLE_NIL IFT_INFINITY_INT_NEG // Temporary nil predecessor
+
+#ifdef IFT_COMPACT //---------------------------------------------------------|
+#define IFTSICLE_BKGCOST IFT_INFINITY_FLT_NEG // Impede conquering
+#define IFTSICLE_TMPCOST IFT_INFINITY_FLT // Temporary cost
+#define IFTSICLE_WHITE_POS -1 // Spel was never inserted in the queue
+#define IFTSICLE_BLACK_POS -2 // Spel was removed from the queue
+
+// Spel's fields within its interleaved record
+#define iftSICLE_RootOf(data,v_index) ((data)->node[(v_index)].root)
+#define iftSICLE_PredOf(data,v_index) ((data)->node[(v_index)].pred)
+#define iftSICLE_CostOf(data,v_index) ((data)->node[(v_index)].cost)
+#else //----------------------------------------------------------------------|
 #define IFTSICLE_BKGCOST IFT_INFINITY_DBL_NEG // Impede conquering
 #define IFTSICLE_TMPCOST IFT_INFINITY_DBL // Temporary cost
 
+// Spel's fields within the separate maps
+#define iftSICLE_RootOf(data,v_index) ((data)->root_map[(v_index)])
+#define iftSICLE_PredOf(data,v_index) ((data)->pred_map[(v_index)])
+#define iftSICLE_CostOf(data,v_index) ((data)->cost_map[(v_index)])
+#endif //---------------------------------------------------------------------|
+
 // Encapsulate for readability
 #define iftSICLE_InROI(sicle,v_index) \
 	((sicle)->roi == NULL || iftBMapValue((sicle)->roi, (v_index)))
 // Exploit the unused seed's predecessor for storing its label (2's complement)
 #define iftSICLE_GetRootLabel(data,v_index) \
-	(-(((data)->pred_map[(data)->root_map[(v_index)]]) + 1))
+	(-(iftSICLE_PredOf((data), iftSICLE_RootOf((data), (v_index))) + 1))
 
 //############################################################################|
 // 
@@ -32,20 +56,102 @@
 struct ift_sicle_alg
 {
 	float *sal; // Spel saliency 
+	float *feats; // Spel features padded to 4 lanes for SIMD (NULL if unused)
 	iftMImage *mimg; // Spel features
 	iftBMap *roi; // Bit-map region of interest (ROI)
+	struct _iftsicle_iftdata *ws; // IFT workspace reused across the executions
+	char *scratch_dir; // Directory of the scratch files (NULL if in-memory)
+	iftIntArray *carried_seeds; // Candidates for the next sampling. May be NULL
+	iftBMap *pinned; // Spels whose seeds are never removed. May be NULL
 };
 
+typedef struct _iftsicle_tsums
+{
+  bool valid; // Whether the sums correspond to the current forest
+  bool is_mapped; // Whether the spel-wise arrays are within scratch files
+  int num_vtx; // Number of vertices
+  int num_slots; // Number of trees tracked (i.e., the seeds at clearing)
+  int max_slots; // Number of slots allocated
+  int num_feats; // Number of features
+  int *slot; // Tree's slot indexed by its root spel. IFT_NIL for non-roots
+  int *root; // Slot's root spel
+  int *size; // Tree's size
+  double *sal; // Tree's saliency sum. NULL if there is no saliency
+  double *feats; // Tree's feature sums (num_feats per slot)
+  long *centr; // Tree's coordinate sums (3 per slot)
+  int edge_cap; // Capacity of the adjacent trees' hash table
+  int num_keys; // Occupied entries of the hash table
+  long *edge_key; // Adjacent slots (a < b) hashed as a*num_slots+b. -1 if empty
+  int *edge_count; // Number of adjacent spel pairs between the slots
+  int num_changed; // Number of spels whose roots may have changed
+  int *changed; // Spels whose roots may have changed since the last update
+  int *old_root; // Spel's root at the last update. Valid within changed
+  iftBMap *touched; // Whether the spel is within changed. NULL if untracked
+} iftSICLE_TSums;
+
+#ifdef IFT_COMPACT //---------------------------------------------------------|
+typedef float iftSICLE_Cost; // Path-cost type
+
+typedef struct _iftsicle_node
+{
+	float cost; // Path-cost
+	int root; // Root
+	int pred; // "Predecessor and label" for memory efficiency
+	int pos; // Position within the queue's heap, or its WHITE/BLACK status
+} iftSICLE_Node;
+
+typedef struct _iftsicle_pqueue
+{
+	iftSICLE_Node *node; // Spels' records, which hold their heap positions
+	int *heap; // Binary min-heap of spels over their records' path-costs
+	int last; // Heap's last position (-1 if empty)
+	int n; // Heap's capacity
+	bool is_mapped; // Whether the heap is within a scratch file
+} iftSICLE_PQueue;
+#else //----------------------------------------------------------------------|
+typedef double iftSICLE_Cost; // Path-cost type
+
+typedef struct _iftsicle_pqueue
+{
+	iftDHeap *heap; // Binary heap. NULL if the bucket queue is used
+	iftBQueue *bqueue; // Bucket queue. NULL if the binary heap is used
+	char *color; // Spel's queue status. Shared with the queue in use
+	bool is_mapped; // Whether the heap's arrays are within scratch files
+} iftSICLE_PQueue;
+#endif //---------------------------------------------------------------------|
+
 typedef struct _iftsicle_iftdata
 {
 	int num_vtx; // Number of vertices
+	bool is_mapped; // Whether the spel-wise maps are within scratch files
+	#ifdef IFT_COMPACT //-------------------------------------------------------|
+	iftSICLE_Node *node; // Interleaved spels' records
+	#else //--------------------------------------------------------------------|
 	int *root_map; // Root map
 	int *pred_map; // "Predecessor and label" map for memory efficiency.
 	double *cost_map; // Cost map
+	#endif //-------------------------------------------------------------------|
 	iftIntArray *seeds; // Seeds at current iteration 
 	iftAdjRel *A; // Adjacency relation
+	int adj_rad; // Adjacency's radius along each axis
+	int *adj_off; // Adjacents' linear index displacements
+	float *adj_dist; // Adjacents' euclidean distances
+	iftBMap *border; // Spels whose adjacents may fall outside the domain
+	iftSICLE_TSums *tsums; // Tree sums, valid across DIFT iterations. May be NULL
+	iftSICLE_PQueue *queue; // Priority queue reused by every IFT execution
+	int *remove_stack; // Reusable stack of spels being removed. DIFT only
+	int *front_stack; // Reusable stack of frontier spels. DIFT only
+	int *visit; // Epoch in which the spel was last visited. DIFT only
+	int epoch; // Current visiting epoch
 } iftSICLE_IFTData;
 
+typedef struct _iftsicle_match
+{
+  int count; // Number of overlapping spels
+  int label; // Label within the current window
+  int glob; // Global label within the previous window
+} iftSICLE_Match;
+
 typedef struct _iftsicle_tstats
 {
   int num_trees; // Number of trees/superspels
@@ -55,9 +161,31 @@ typedef struct _iftsicle_tstats
   float *sal; // Tree's/superspel's mean saliency
   float **feats; // Tree's/superspel's mean features
   float **centr; // Tree's/superspel's centroid
-  iftBMap **adj; // Tree's/superspel's adjacents
+  int *adj_first; // Tree's/superspel's first adjacent within adj (CSR)
+  int *adj; // Tree's/superspel's adjacents, grouped by tree (CSR)
 } iftSICLE_TStats;
 
+typedef struct _iftsicle_scalesink
+{
+  iftSICLEScaleFunc emit; // Receiver of the finalized scales
+  void *user_data; // Receiver's data
+  bool in_parallel; // Whether a writer thread calls the receiver
+  bool is_done; // Whether no more scales will be handed. Writer only
+  bool is_busy; // Whether the writer holds a scale. Writer only
+  int scale; // Index of the handed scale. Writer only
+  iftImage *label_img; // Handed scale, if any. Writer only
+  pthread_t writer; // Writer thread
+  pthread_mutex_t lock; // Guards the handed scale and the flags
+  pthread_cond_t cond; // Signals handed, taken and emitted scales
+} iftSICLE_ScaleSink;
+
+typedef struct _iftsicle_targets
+{
+  long num_targets; // Number of Nf targets
+  int *scale; // Target's scale, whose Ni is the nearest one not above it
+  iftImage **segm; // Target's segmentation
+} iftSICLE_Targets;
+
 //############################################################################|
 // 
 //	PRIVATE METHODS
@@ -69,7 +197,7 @@ typedef struct _iftsicle_tstats
 /*
  * Creates the array containing the values of Ni at each iteration of SICLE.
  * If the user provides such values, then the array will contain N0, Nf and 
- * the user-defined quantities.
+ * the user-defined quantities. The Nf targets, if any, are spliced into it.
  *
  * PARAMETERS:
  *  args[in] - REQUIRED: SICLE arguments
@@ -107,6 +235,37 @@ iftIntArray *iftSICLE_CreateNiArray
 		else
 		{ ni->val[i] = args->user_ni->val[i - 1]; }
 	}
+
+	if(args->nf_targets != NULL) // Both are strictly decreasing
+	{
+		long i, j, num_spliced;
+		int *spliced;
+
+		spliced = malloc((ni->n + args->nf_targets->n) * sizeof(int));
+		assert(spliced != NULL);
+
+		i = j = num_spliced = 0;
+		while(i < ni->n)
+		{
+			if(j < args->nf_targets->n && args->nf_targets->val[j] >= real_n0)
+			{ ++j; } // Unreachable. The first scale is the nearest
+			else if(j < args->nf_targets->n && 
+							args->nf_targets->val[j] > ni->val[i])
+			{ spliced[num_spliced++] = args->nf_targets->val[j++]; }
+			else
+			{
+				if(j < args->nf_targets->n && 
+					 args->nf_targets->val[j] == ni->val[i]) { ++j; }
+				spliced[num_spliced++] = ni->val[i++];
+			}
+		}
+
+		iftDestroyIntArray(&ni);
+		ni = iftCreateIntArray(num_spliced);
+		memcpy(ni->val, spliced, num_spliced * sizeof(int));
+		free(spliced);
+		num_iters = ni->n;
+	}
 	#ifdef IFT_DEBUG //---------------------------------------------------------|
 	fprintf(stderr, "DEBUG (%s): Num Iters = %d\n", __func__, num_iters);
 	#endif //-------------------------------------------------------------------|
@@ -114,9 +273,169 @@ iftIntArray *iftSICLE_CreateNiArray
 	return ni;
 }
 
+/*
+ * Allocates a zeroed spel-wise buffer, which is mapped from a scratch file
+ * if the prototype is out-of-core
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  size[in] - REQUIRED: Size of the buffer (in bytes)
+ *
+ * RETURNS: Zeroed buffer
+ */
+void *iftSICLE_AllocMap
+(iftSICLE *sicle, size_t size)
+{
+	void *map;
+
+	if(sicle->scratch_dir != NULL)
+	{ map = iftMapScratchFile(sicle->scratch_dir, size); }
+	else { map = calloc(size, 1); assert(map != NULL); }
+
+	return map;
+}
+
+/*
+ * Deallocates a spel-wise buffer allocated by iftSICLE_AllocMap
+ *
+ * PARAMETERS:
+ *  is_mapped[in] - REQUIRED: Whether the buffer is within a scratch file
+ *  map[in/out] - REQUIRED: Buffer to be free'd
+ *  size[in] - REQUIRED: Size of the buffer (in bytes)
+ */
+void iftSICLE_FreeMap
+(bool is_mapped, void *map, size_t size)
+{
+	if(is_mapped == true) { iftUnmapScratchFile(map, size); }
+	else { free(map); }
+}
+
+/*
+ * Sets the prototype's saliency and region of interest from the maps 
+ * provided. The buffers already allocated are reused.
+ *
+ * PARAMETERS:
+ *  sicle[in/out] - REQUIRED: SICLE auxiliary data
+ *	objsm[in] - OPTIONAL: Grayscale object saliency map
+ *	mask[in] - OPTIONAL: Binary mask indication the region of interest
+ */
+void iftSICLE_SetMaps
+(iftSICLE *sicle, iftImage *objsm, iftImage *mask)
+{
+	if(mask != NULL)
+	{
+		if(sicle->roi != NULL) // Reuse
+		{
+			for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+			{
+				if(mask->val[v_index] != 0) { iftBMapSet1(sicle->roi, v_index); }
+				else { iftBMapSet0(sicle->roi, v_index); }
+			}
+		}
+		else { sicle->roi = iftBinImageToBMap(mask); }
+	}
+	else if(sicle->roi != NULL) { iftDestroyBMap(&(sicle->roi)); }
+
+	if(objsm != NULL)
+	{
+		int max_sal;
+
+		if(sicle->sal == NULL)
+		{ sicle->sal = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(float)); }
+
+		max_sal = 0;
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for reduction(+:max_sal)
+		#endif //-----------------------------------------------------------------|
+		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+		{ max_sal = iftMax(max_sal, objsm->val[v_index]); }
+
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for
+		#endif //-----------------------------------------------------------------|
+		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+		{ sicle->sal[v_index] = (float)objsm->val[v_index]/max_sal; } // Norm [0,1]
+	}
+	else if(sicle->sal != NULL) 
+	{ 
+		iftSICLE_FreeMap(sicle->scratch_dir != NULL, sicle->sal, 
+										 sicle->mimg->n * sizeof(float)); 
+		sicle->sal = NULL; 
+	}
+}
+
+/*
+ * Sets the prototype's spel features, saliency and region of interest from the
+ * input images provided. The buffers already allocated are reused whenever 
+ * their sizes remain the same.
+ *
+ * PARAMETERS:
+ *  sicle[in/out] - REQUIRED: SICLE auxiliary data
+ *	img[in] - REQUIRED: Original image to be segmented
+ *	objsm[in] - OPTIONAL: Grayscale object saliency map
+ *	mask[in] - OPTIONAL: Binary mask indication the region of interest
+ */
+void iftSICLE_SetInputs
+(iftSICLE *sicle, iftImage *img, iftImage *objsm, iftImage *mask)
+{
+	int old_num_feats;
+
+	old_num_feats = (sicle->mimg != NULL) ? sicle->mimg->m : 0;
+	if(sicle->mimg != NULL) { iftDestroyMImage(&(sicle->mimg)); }
+
+	if(iftIsColorImage(img)) 
+	{ sicle->mimg = iftImageToMImage(img, LAB_CSPACE); }
+	else { sicle->mimg = iftImageToMImage(img, GRAY_CSPACE); }
+
+	#if defined(IFT_SIMD) && defined(__SSE2__) //-------------------------------|
+	if(sicle->feats != NULL && sicle->mimg->m == old_num_feats) // Refill?
+	{
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for
+		#endif //-----------------------------------------------------------------|
+		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+		{
+			for(int b = 0; b < sicle->mimg->m; ++b)
+			{ sicle->feats[v_index * 4 + b] = sicle->mimg->val[v_index][b]; }
+		}
+	}
+	else
+	{
+		if(sicle->feats != NULL) { free(sicle->feats); sicle->feats = NULL; }
+		if(sicle->mimg->m <= 4) // Fits within one SSE register?
+		{ sicle->feats = iftMImageToAlignedArray(sicle->mimg, 4); }
+	}
+	#else //--------------------------------------------------------------------|
+	(void)old_num_feats;
+	#endif //-------------------------------------------------------------------|
+	
+	iftSICLE_SetMaps(sicle, objsm, mask);
+}
+
 //============================================================================|
 // Output
 //============================================================================|
+/* 
+ * Creates an empty image of the prototype's domain, which is mapped from a 
+ * scratch file if the prototype is out-of-core
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *
+ * RETURNS: Zeroed grayscale image
+ */
+iftImage *iftSICLE_CreateImage
+(iftSICLE *sicle)
+{
+	if(sicle->scratch_dir != NULL)
+	{
+		return iftCreateMappedImage(sicle->mimg->xsize, sicle->mimg->ysize, 
+																sicle->mimg->zsize, sicle->scratch_dir);
+	}
+	return iftCreateImage(sicle->mimg->xsize, sicle->mimg->ysize, 
+												sicle->mimg->zsize);
+}
+
 /* 
  * Creates a label image from the IFT root map whose labels are within [1,N],
  * if no mask was provided; or [0,N] otherwise, being 0 for the background
@@ -132,8 +451,7 @@ iftImage *iftSICLE_CreateLabelImage
 {
 	iftImage *label_img;
 
-	label_img = iftCreateImage(sicle->mimg->xsize, sicle->mimg->ysize, 
-															sicle->mimg->zsize);
+	label_img = iftSICLE_CreateImage(sicle);
 	#ifdef IFT_OMP //-----------------------------------------------------------|
 	#pragma omp parallel for
 	#endif //-------------------------------------------------------------------|
@@ -161,8 +479,7 @@ iftImage *iftSICLE_CreateSeedImage
 {
 	iftImage *seed_img;
 
-	seed_img = iftCreateImage(sicle->mimg->xsize, sicle->mimg->ysize, 
-														sicle->mimg->zsize);
+	seed_img = iftSICLE_CreateImage(sicle);
 
 	#ifdef IFT_OMP //-----------------------------------------------------------|
 	#pragma omp parallel for
@@ -288,286 +605,226 @@ iftIntArray *iftSICLE_RndOversampl
 }
 
 //============================================================================|
-// iftSICLE_IFTData
+// iftSICLE_PQueue
 //============================================================================|
 /*
- * Creates and allocates memory for an IFT data instance
+ * Estimates an upper bound for the Fmax path-cost, which is the diagonal of
+ * the features' bounding box, boosted by the saliency, if any.
  *
  * PARAMETERS:
  *  sicle[in] - REQUIRED: SICLE auxiliary data
  *  args[in] - REQUIRED: SICLE arguments
  *
- * RETURNS: Instance of the object
+ * RETURNS: Maximum Fmax path-cost possible
  */
-iftSICLE_IFTData *iftSICLE_CreateIFTData
+double iftSICLE_CalcMaxFmaxCost
 (iftSICLE *sicle, iftSICLEArgs *args)
 {
-	iftSICLE_IFTData *data;
-
-	data = malloc(sizeof(iftSICLE_IFTData));
-	assert(data != NULL);
+	double diag, max_cost;
 
-	data->num_vtx = sicle->mimg->n;
-	data->root_map = calloc(sicle->mimg->n, sizeof(int));
-	assert(data->root_map != NULL);
-	data->pred_map = calloc(sicle->mimg->n, sizeof(int));
-	assert(data->pred_map != NULL);
-	data->cost_map = calloc(sicle->mimg->n, sizeof(double));
-	assert(data->cost_map != NULL);
-	
-	if(args->use_diag == true) 
-	{
-		if(iftIs3DMImage(sicle->mimg) == true) 
-		{ data->A = iftSpheric(sqrtf(3.0)); }
-		else { data->A = iftCircular(sqrtf(2.0)); }
-	}
-	else
+	diag = 0.0;
+	for(int f = 0; f < sicle->mimg->m; ++f)
 	{
-		if(iftIs3DMImage(sicle->mimg) == true) { data->A = iftSpheric(1.0); }
-		else { data->A = iftCircular(1.0); }
-	}
+		float min_feat, max_feat;
 
-	if(args->samplopt == IFT_SICLE_SAMPL_RND)
-	{ data->seeds = iftSICLE_RndOversampl(sicle, args); }
-	else if(args->samplopt == IFT_SICLE_SAMPL_GRID)
-	{ data->seeds = iftSICLE_GridOversampl(sicle, args); }
-	else if(args->samplopt == IFT_SICLE_SAMPL_CUSTOM)
-	{ 
-  	/* 
-			You may write here your own seed oversampling method for testing possible
-			new functionalities for SICLE. For using that, add "--sampl-opt custom"
-			in the command-line
-		*/
-		data->seeds = iftSICLE_RndOversampl(sicle, args); 
+		min_feat = IFT_INFINITY_FLT; max_feat = IFT_INFINITY_FLT_NEG;
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for reduction(min:min_feat) reduction(max:max_feat)
+		#endif //-----------------------------------------------------------------|
+		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+		{
+			min_feat = iftMin(min_feat, sicle->mimg->val[v_index][f]);
+			max_feat = iftMax(max_feat, sicle->mimg->val[v_index][f]);
+		}
+		diag += (max_feat - min_feat) * (max_feat - min_feat);
 	}
-	else
-	{ iftError("Unknown seed sampling option", __func__); }
+	diag = sqrt(diag);
 
-	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	fprintf(stderr, "DEBUG (%s): %ld seeds sampled\n", __func__, data->seeds->n);
-	#endif //-------------------------------------------------------------------|	
+	max_cost = diag;
+	if(sicle->sal != NULL) // Saliency distance is within [0,1]
+	{ max_cost = iftMax(max_cost, pow(diag, 1.0 + args->alpha)); }
 
-	return data;
+	return iftMax(max_cost, IFT_EPSILON);
 }
 
+#ifdef IFT_COMPACT //---------------------------------------------------------|
 /*
- * Deallocates the respective object 
+ * Creates the priority queue for the IFT, which is a binary min-heap storing
+ * the spels' positions within their interleaved records. Thus, it only owns
+ * its heap array.
  *
  * PARAMETERS:
- *		args[in/out] - REQUIRED: Pointer to the object to be free'd
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *
+ * RETURNS: Instance of the object
  */
-void iftSICLE_DestroyIFTData
-(iftSICLE_IFTData **data)
+iftSICLE_PQueue *iftSICLE_CreatePQueue
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data)
 {
-	free((*data)->root_map);
-	free((*data)->pred_map);
-	free((*data)->cost_map);
-	iftDestroyIntArray(&((*data)->seeds));
-	iftDestroyAdjRel(&((*data)->A));
+	iftSICLE_PQueue *queue;
 
-	free(*data);
-	(*data) = NULL;
+	queue = malloc(sizeof(iftSICLE_PQueue));
+	assert(queue != NULL);
+
+	queue->node = data->node;
+	queue->n = data->num_vtx;
+	queue->last = -1;
+	queue->is_mapped = data->is_mapped;
+	queue->heap = iftSICLE_AllocMap(sicle, queue->n * sizeof(int));
+
+	for(int v_index = 0; v_index < data->num_vtx; ++v_index)
+	{ data->node[v_index].pos = IFTSICLE_WHITE_POS; }
+
+	return queue;
 }
 
 /*
- * Resets the IFT data to a pre-IFT state: assigns temporary costs and 
- * predecessors, and reassigns labels to seeds and background spels.
+ * Deallocates the respective object 
  *
  * PARAMETERS:
- *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *		queue[in/out] - REQUIRED: Pointer to the object to be free'd
  */
-void iftSICLE_ResetIFTData
-(iftSICLE *sicle, iftSICLE_IFTData **data)
+void iftSICLE_DestroyPQueue
+(iftSICLE_PQueue **queue)
 {
-	#ifdef IFT_OMP //-----------------------------------------------------------|
-	#pragma omp parallel for
-	#endif //-------------------------------------------------------------------|
-	for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
-	{
-		(*data)->pred_map[v_index] = IFTSICLE_NIL;
-		(*data)->root_map[v_index] = IFTSICLE_NIL;
+	iftSICLE_FreeMap((*queue)->is_mapped, (*queue)->heap, 
+									 (*queue)->n * sizeof(int));
+	free(*queue);
+	(*queue) = NULL;
+}
 
-		if(!iftSICLE_InROI(sicle,v_index)) // Won't be conquered
-		{ (*data)->cost_map[v_index] = IFTSICLE_BKGCOST; } 
-		else 
-		{ (*data)->cost_map[v_index] = IFTSICLE_TMPCOST; }
-	}
+// Moves the spel at the i-th heap position up while its parent costs more
+static inline void iftSICLE_GoUpPQueue
+(iftSICLE_PQueue *queue, int i)
+{
+	int v_index;
+	float v_cost;
 
-	#ifdef IFT_OMP //-----------------------------------------------------------|
-	#pragma omp parallel for
-	#endif //-------------------------------------------------------------------|
-	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id)
+	v_index = queue->heap[i];
+	v_cost = queue->node[v_index].cost;
+	while(i > 0 && queue->node[queue->heap[(i - 1) / 2]].cost > v_cost)
 	{
-		int s_index;
-
-		s_index = (*data)->seeds->val[s_id];
-		(*data)->root_map[s_index] = s_index;
-		(*data)->pred_map[s_index] = -(s_id + 1); // 2's complement
-		(*data)->cost_map[s_index] = 0;
+		queue->heap[i] = queue->heap[(i - 1) / 2];
+		queue->node[queue->heap[i]].pos = i;
+		i = (i - 1) / 2;
 	}
+	queue->heap[i] = v_index;
+	queue->node[v_index].pos = i;
 }
 
-/*
- * Removes the trees of the irrelevant seeds, marked to be removed, and 
- * returns the spels at the frontier to be inserted for the differential 
- * computation.
- *
- * PARAMETERS:
- *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
- *  irre_seeds[in/out] - REQUIRED: Irrelevant seeds to be removed
- *
- * RETURNS: Spels at the frontier of the removed trees
- */
-iftSet *iftSICLE_RemoveTrees
-(iftSICLE *sicle, iftSICLE_IFTData **data, iftSet **irre_seeds)
+// Moves the spel at the i-th heap position down while a child costs less
+static inline void iftSICLE_GoDownPQueue
+(iftSICLE_PQueue *queue, int i)
 {
-	iftBMap *marked;
-  iftSet *frontier, *remove;
+	int v_index;
+	float v_cost;
 
-  marked = iftCreateBMap((*data)->num_vtx);
+	v_index = queue->heap[i];
+	v_cost = queue->node[v_index].cost;
+	while(true)
+	{
+		int left, right, j;
+		float j_cost;
+
+		left = 2 * i + 1; right = left + 1;
+		j = i; j_cost = v_cost;
+		if(left <= queue->last && queue->node[queue->heap[left]].cost < j_cost)
+		{ j = left; j_cost = queue->node[queue->heap[left]].cost; }
+		if(right <= queue->last && queue->node[queue->heap[right]].cost < j_cost)
+		{ j = right; }
+		if(j == i) { break; }
+
+		queue->heap[i] = queue->heap[j];
+		queue->node[queue->heap[i]].pos = i;
+		i = j;
+	}
+	queue->heap[i] = v_index;
+	queue->node[v_index].pos = i;
+}
 
-  remove = NULL;
-  while((*irre_seeds) != NULL)
-  {
-  	int s_index;
+// Encapsulate for readability
+static inline bool iftSICLE_EmptyPQueue
+(iftSICLE_PQueue *queue)
+{ return queue->last == -1; }
 
-  	s_index = iftRemoveSet(irre_seeds);
-		(*data)->pred_map[s_index] = IFTSICLE_NIL; // Temporary predecessor		
-    (*data)->root_map[s_index] = IFTSICLE_NIL; // Temporary root
-    (*data)->cost_map[s_index] = IFTSICLE_TMPCOST; // Temporary cost
-    iftInsertSet(&remove, s_index); // Add for BFS removal
-  }
+static inline void iftSICLE_InsertPQueue
+(iftSICLE_PQueue *queue, int v_index)
+{
+	queue->heap[++(queue->last)] = v_index;
+	iftSICLE_GoUpPQueue(queue, queue->last);
+}
 
-  frontier = NULL;
-  while(remove != NULL)
-  {
-  	int vi_index;
-  	iftVoxel vi_voxel;
+static inline int iftSICLE_RemovePQueue
+(iftSICLE_PQueue *queue)
+{
+	int v_index;
 
-  	vi_index = iftRemoveSet(&remove);
-  	vi_voxel = iftMGetVoxelCoord(sicle->mimg, vi_index);
+	v_index = queue->heap[0];
+	queue->node[v_index].pos = IFTSICLE_BLACK_POS;
+	queue->heap[0] = queue->heap[(queue->last)--];
+	if(queue->last >= 0) { iftSICLE_GoDownPQueue(queue, 0); }
 
-  	for(int j = 1; j < (*data)->A->n; ++j)
-  	{
-  		iftVoxel vj_voxel;
+	return v_index;
+}
 
-  		vj_voxel = iftGetAdjacentVoxel((*data)->A, vi_voxel, j);
+static inline void iftSICLE_RemovePQueueElem
+(iftSICLE_PQueue *queue, int v_index)
+{
+	int i;
 
-  		if(iftMValidVoxel(sicle->mimg, vj_voxel))
-  		{
-  			int vj_index, vj_root;
+	i = queue->node[v_index].pos;
+	while(i > 0) // Lift it up to the root, as if it had the least cost
+	{
+		queue->heap[i] = queue->heap[(i - 1) / 2];
+		queue->node[queue->heap[i]].pos = i;
+		i = (i - 1) / 2;
+	}
+	queue->heap[0] = v_index;
+	iftSICLE_RemovePQueue(queue);
+	queue->node[v_index].pos = IFTSICLE_WHITE_POS;
+}
 
-  			vj_index = iftMGetVoxelIndex(sicle->mimg, vj_voxel);
-  			vj_root = (*data)->root_map[vj_index];
+// Whether the spel is within the queue
+static inline bool iftSICLE_InPQueue
+(iftSICLE_PQueue *queue, int v_index)
+{ return queue->node[v_index].pos >= 0; }
 
-  			if((*data)->cost_map[vj_index] != IFTSICLE_BKGCOST) // If not in bkg
-  			{
-  				// If belongs to the subtree being removed at moment
-  				if((*data)->pred_map[vj_index] == vi_index)
-  				{
-  					(*data)->pred_map[vj_index] = IFTSICLE_NIL; //Temporary predecessor
-				    (*data)->root_map[vj_index] = IFTSICLE_NIL; // Temporary root
-				    (*data)->cost_map[vj_index] = IFTSICLE_TMPCOST; // Temporary cost
-				    iftInsertSet(&remove, vj_index); // Add for BFS removal
-  				}
-  				else if(vj_root != IFTSICLE_NIL && // If it wasnt removed
-  							 	(*data)->root_map[vj_root] != IFTSICLE_NIL && // If relevant
-  							 	!iftBMapValue(marked, vj_index)) //If it wasnt yet visited
-					{ 
-						iftBMapSet1(marked, vj_index); // Visited
-						iftInsertSet(&frontier, vj_index); // Frontier of removed tree
-					}
-  			}
-  		}
-  	}
-  }
-  iftDestroyBMap(&marked);
+// Whether the spel was removed from the queue
+static inline bool iftSICLE_LeftPQueue
+(iftSICLE_PQueue *queue, int v_index)
+{ return queue->node[v_index].pos == IFTSICLE_BLACK_POS; }
 
-  return frontier;
-}
+// Marks the spel as never inserted in the queue
+static inline void iftSICLE_ClearPQueueStatus
+(iftSICLE_PQueue *queue, int v_index)
+{ queue->node[v_index].pos = IFTSICLE_WHITE_POS; }
 
 /*
- * Removes the subtree of the given vertex and updates those spels at the 
- * frontier for a new competition in the differential computation.
+ * Empties the queue and clears the status of every spel for a new IFT
+ * execution.
  *
  * PARAMETERS:
- *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  v_index[in] - REQUIRED: "Root" of the subtree to be removed
- *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
- *  heap[in/out] - REQUIRED: Priority queue of the current IFT execution to
- *													 be updated.
+ *  queue[in/out] - REQUIRED: Priority queue to be reset
  */
-void iftSICLE_RemoveSubtree
-(iftSICLE *sicle, int v_index, iftSICLE_IFTData **data, iftDHeap **heap)
+void iftSICLE_ResetPQueue
+(iftSICLE_PQueue *queue)
 {
-	iftBMap *marked;
-  iftSet *remove, *frontier;
-
-  marked = iftCreateBMap((*data)->num_vtx);
-
-  remove = frontier = NULL;
-  iftInsertSet(&remove, v_index);
-  while(remove != NULL)
-  {
-  	int vi_index;
-  	iftVoxel vi_voxel;
+	queue->last = -1;
 
-  	vi_index = iftRemoveSet(&remove);
-  	vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
-
-    (*data)->root_map[vi_index] = IFTSICLE_NIL; // Temporary root
-    (*data)->pred_map[vi_index] = IFTSICLE_NIL; // Temporary predecessor
-    (*data)->cost_map[vi_index] = IFTSICLE_TMPCOST; // Temporary cost
-
-    if((*heap)->color[vi_index] == IFT_GRAY)
-    { iftRemoveDHeapElem((*heap), vi_index); } // Remove if exists in queue
-  	else { (*heap)->color[vi_index] = IFT_WHITE; } // Clear its status
-
-  	for(int j = 1; j < (*data)->A->n; ++j)
-  	{
-  		iftVoxel vj_voxel;
-
-  		vj_voxel = iftGetAdjacentVoxel((*data)->A, vi_voxel, j);
-
-  		if(iftMValidVoxel(sicle->mimg, vj_voxel) == true)
-  		{
-  			int vj_index;
-
-  			vj_index = iftMGetVoxelIndex(sicle->mimg, vj_voxel);
-  			
-	  		if((*data)->pred_map[vj_index] == vi_index) // If belongs to subtree
-				{ iftInsertSet(&remove, vj_index); } // Add to BFS removal
-				else if((*data)->cost_map[vj_index] != IFTSICLE_BKGCOST && // Not bkg
-								(*data)->cost_map[vj_index] != IFTSICLE_TMPCOST && // Reached
-								 !iftBMapValue(marked, vj_index)) // Visited
-				{ 
-					iftBMapSet1(marked, vj_index); // Visited
-					iftInsertSet(&frontier, vj_index); // Probable frontier
-				}
-  		}
-  	}
-  }
-	iftDestroyBMap(&marked);
-
-  while(frontier != NULL)
-  {
-  	int vi_index;
-
-  	vi_index = iftRemoveSet(&frontier);
-
-  	if((*heap)->color[vi_index] == IFT_GRAY) // Already in heap?
-		{ iftRemoveDHeapElem((*heap), vi_index); } // Remove for update
-		iftInsertDHeap((*heap), vi_index); // Add/update
-  }
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int v_index = 0; v_index < queue->n; ++v_index)
+	{ queue->node[v_index].pos = IFTSICLE_WHITE_POS; }
 }
-
-//============================================================================|
-// iftSICLE_TStats
-//============================================================================|
+#else //----------------------------------------------------------------------|
 /*
- * Creates and allocates memory for an Tree statistics instance
+ * Creates the priority queue for the IFT, which is either a binary heap or,
+ * if required, a bucket queue over the quantized Fmax path-costs. The heap's
+ * spel-wise arrays are mapped from scratch files if the prototype is
+ * out-of-core.
  *
  * PARAMETERS:
  *  sicle[in] - REQUIRED: SICLE auxiliary data
@@ -576,847 +833,4441 @@ void iftSICLE_RemoveSubtree
  *
  * RETURNS: Instance of the object
  */
-iftSICLE_TStats *iftSICLE_CreateTStats
+iftSICLE_PQueue *iftSICLE_CreatePQueue
 (iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data)
 {
-	iftSICLE_TStats *tstats;
+	iftSICLE_PQueue *queue;
 
-  tstats = malloc(sizeof(iftSICLE_TStats));
-  assert(tstats != NULL);
+	queue = malloc(sizeof(iftSICLE_PQueue));
+	assert(queue != NULL);
 
-  tstats->num_trees = data->seeds->n;
-  tstats->num_feats = sicle->mimg->m;
-  tstats->num_dims = 3;
+	if(args->use_bqueue == true)
+	{
+		double max_cost;
 
-  tstats->size = calloc(data->seeds->n, sizeof(int));
-  assert(tstats->size != NULL);
+		max_cost = iftSICLE_CalcMaxFmaxCost(sicle, args);
+		queue->heap = NULL;
+		queue->bqueue = iftCreateBQueue(data->num_vtx, args->num_buckets, max_cost,
+																		data->cost_map);
+		queue->color = queue->bqueue->color;
+	}
+	else if(data->is_mapped == true)
+	{
+		queue->bqueue = NULL;
+		queue->heap = malloc(sizeof(iftDHeap));
+		assert(queue->heap != NULL);
+		queue->heap->value = data->cost_map;
+		queue->heap->n = data->num_vtx; queue->heap->last = -1;
+		queue->heap->removal_policy = MINVALUE;
+		queue->heap->color = iftSICLE_AllocMap(sicle, data->num_vtx * sizeof(char));
+		queue->heap->node = iftSICLE_AllocMap(sicle, data->num_vtx * sizeof(int));
+		queue->heap->pos = iftSICLE_AllocMap(sicle, data->num_vtx * sizeof(int));
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for
+		#endif //-----------------------------------------------------------------|
+		for(int v_index = 0; v_index < data->num_vtx; ++v_index)
+		{
+			queue->heap->color[v_index] = IFT_WHITE;
+			queue->heap->node[v_index] = queue->heap->pos[v_index] = -1;
+		}
+		queue->color = queue->heap->color;
+	}
+	else
+	{
+		queue->bqueue = NULL;
+		queue->heap = iftCreateDHeap(data->num_vtx, data->cost_map);
+		iftSetRemovalPolicyDHeap(queue->heap, MINVALUE);
+		queue->color = queue->heap->color;
+	}
+	queue->is_mapped = data->is_mapped && queue->bqueue == NULL;
 
-  tstats->adj = calloc(data->seeds->n, sizeof(iftBMap*));
-  assert(tstats->adj != NULL);
+	return queue;
+}
 
-  tstats->feats = calloc(data->seeds->n, sizeof(float*));
-  assert(tstats->feats != NULL);
+/*
+ * Deallocates the respective object 
+ *
+ * PARAMETERS:
+ *		queue[in/out] - REQUIRED: Pointer to the object to be free'd
+ */
+void iftSICLE_DestroyPQueue
+(iftSICLE_PQueue **queue)
+{
+	if((*queue)->is_mapped == true)
+	{
+		iftSICLE_FreeMap(true, (*queue)->heap->color, (*queue)->heap->n * sizeof(char));
+		iftSICLE_FreeMap(true, (*queue)->heap->node, (*queue)->heap->n * sizeof(int));
+		iftSICLE_FreeMap(true, (*queue)->heap->pos, (*queue)->heap->n * sizeof(int));
+		free((*queue)->heap);
+	}
+	else if((*queue)->heap != NULL) { iftDestroyDHeap(&((*queue)->heap)); }
+	if((*queue)->bqueue != NULL) { iftDestroyBQueue(&((*queue)->bqueue)); }
 
-  tstats->centr = calloc(data->seeds->n, sizeof(float*));
-  assert(tstats->centr != NULL);
+	free(*queue);
+	(*queue) = NULL;
+}
 
-  if(sicle->sal == NULL) { tstats->sal = NULL; }
-  else
-  {
-  	tstats->sal = calloc(data->seeds->n, sizeof(float));
-	  assert(tstats->sal != NULL);
-  }
+// Encapsulate for readability
+static inline bool iftSICLE_EmptyPQueue
+(iftSICLE_PQueue *queue)
+{
+	if(queue->bqueue != NULL) { return iftEmptyBQueue(queue->bqueue); }
+	else { return iftEmptyDHeap(queue->heap); }
+}
 
-  for(long s_id = 0; s_id < data->seeds->n; ++s_id)
-  { 
-	  tstats->adj[s_id] = iftCreateBMap(tstats->num_trees);
+static inline void iftSICLE_InsertPQueue
+(iftSICLE_PQueue *queue, int v_index)
+{
+	if(queue->bqueue != NULL) { iftInsertBQueue(queue->bqueue, v_index); }
+	else { iftInsertDHeap(queue->heap, v_index); }
+}
 
-    tstats->feats[s_id] = calloc(tstats->num_feats, sizeof(float));
-    assert(tstats->feats[s_id] != NULL);
+static inline int iftSICLE_RemovePQueue
+(iftSICLE_PQueue *queue)
+{
+	if(queue->bqueue != NULL) { return iftRemoveBQueue(queue->bqueue); }
+	else { return iftRemoveDHeap(queue->heap); }
+}
 
-    tstats->centr[s_id] = calloc(tstats->num_dims, sizeof(float));
-    assert(tstats->centr[s_id] != NULL);
-  }
+static inline void iftSICLE_RemovePQueueElem
+(iftSICLE_PQueue *queue, int v_index)
+{
+	if(queue->bqueue != NULL) { iftRemoveBQueueElem(queue->bqueue, v_index); }
+	else { iftRemoveDHeapElem(queue->heap, v_index); }
+}
 
-  return tstats;
+// Whether the spel is within the queue
+static inline bool iftSICLE_InPQueue
+(iftSICLE_PQueue *queue, int v_index)
+{ return queue->color[v_index] == IFT_GRAY; }
+
+// Whether the spel was removed from the queue
+static inline bool iftSICLE_LeftPQueue
+(iftSICLE_PQueue *queue, int v_index)
+{ return queue->color[v_index] == IFT_BLACK; }
+
+// Marks the spel as never inserted in the queue
+static inline void iftSICLE_ClearPQueueStatus
+(iftSICLE_PQueue *queue, int v_index)
+{ queue->color[v_index] = IFT_WHITE; }
+
+/*
+ * Empties the queue and clears the status of every spel for a new IFT
+ * execution. Only the status map is cleared whenever the queue was drained.
+ *
+ * PARAMETERS:
+ *  queue[in/out] - REQUIRED: Priority queue to be reset
+ */
+void iftSICLE_ResetPQueue
+(iftSICLE_PQueue *queue)
+{
+	if(queue->bqueue != NULL)
+	{
+		if(iftEmptyBQueue(queue->bqueue) == false) 
+		{ iftResetBQueue(queue->bqueue); }
+		else { memset(queue->color, IFT_WHITE, queue->bqueue->n * sizeof(char)); }
+	}
+	else
+	{
+		if(iftEmptyDHeap(queue->heap) == false) { iftResetDHeap(queue->heap); }
+		else { memset(queue->color, IFT_WHITE, queue->heap->n * sizeof(char)); }
+	}
 }
+#endif //---------------------------------------------------------------------|
 
+//============================================================================|
+// iftSICLE_TSums
+//============================================================================|
 /*
- * Deallocates the respective object 
+ * Creates and allocates memory for an instance of the tree sums, which
+ * must be cleared before its first usage (see iftSICLE_ClearTSums). If
+ * tracked, it records every spel whose root may change, permitting an
+ * incremental update.
  *
  * PARAMETERS:
- *		args[in/out] - REQUIRED: Pointer to the object to be free'd
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  track[in] - REQUIRED: Whether the root changes are recorded
+ *
+ * RETURNS: Instance of the object
  */
-void iftSICLE_DestroyTStats
-(iftSICLE_TStats **tstats)
+iftSICLE_TSums *iftSICLE_CreateTSums
+(iftSICLE *sicle, bool track)
 {
-  free((*tstats)->size);
-  if((*tstats)->sal != NULL) { free((*tstats)->sal); }
-  for(int i = 0; i < (*tstats)->num_trees; ++i)
+  iftSICLE_TSums *tsums;
+
+  tsums = malloc(sizeof(iftSICLE_TSums));
+  assert(tsums != NULL);
+
+  tsums->valid = false;
+  tsums->is_mapped = sicle->scratch_dir != NULL;
+  tsums->num_vtx = sicle->mimg->n;
+  tsums->num_slots = tsums->max_slots = 0;
+  tsums->num_feats = sicle->mimg->m;
+  tsums->root = NULL; tsums->size = NULL; tsums->feats = NULL;
+  tsums->centr = NULL; tsums->sal = NULL;
+
+  tsums->slot = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(int));
+  for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+  { tsums->slot[v_index] = IFT_NIL; }
+
+  tsums->edge_cap = 1024;
+  tsums->edge_key = malloc(tsums->edge_cap * sizeof(long));
+  assert(tsums->edge_key != NULL);
+  tsums->edge_count = calloc(tsums->edge_cap, sizeof(int));
+  assert(tsums->edge_count != NULL);
+
+  tsums->num_changed = 0;
+  if(track == false)
+  { tsums->changed = tsums->old_root = NULL; tsums->touched = NULL; }
+  else
   {
-    iftDestroyBMap(&((*tstats)->adj[i]));
-    free((*tstats)->feats[i]);
-    free((*tstats)->centr[i]);
+    tsums->changed = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(int));
+    tsums->old_root = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(int));
+    tsums->touched = iftCreateBMap(sicle->mimg->n);
   }
-  free((*tstats)->adj);
-  free((*tstats)->feats);
-  free((*tstats)->centr);
 
-  free(*tstats);
-  (*tstats) = NULL;
+  return tsums;
 }
 
 /*
- * Calculates the tree statistics of the root map and seed array of the 
- * current IFT execution
+ * Clears the tree sums, whose slots will correspond to the current seeds. 
+ * The buffers are reused, and only the entries of the former slots and 
+ * records are cleared.
  *
  * PARAMETERS:
  *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  args[in] - REQUIRED: SICLE arguments
  *  data[in] - REQUIRED: IFT auxiliary data
- *
- * RETURNS: Extracted tree statistics of the current IFT execution
+ *  tsums[in/out] - REQUIRED: Tree sums to be cleared
  */
-iftSICLE_TStats *iftSICLE_CalcTStats
-(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data)
+void iftSICLE_ClearTSums
+(iftSICLE *sicle, iftSICLE_IFTData *data, iftSICLE_TSums *tsums)
 {
-  iftSICLE_TStats *tstats;
+  int edge_cap;
 
-  tstats = iftSICLE_CreateTStats(sicle, args, data);
+  for(int slot = 0; slot < tsums->num_slots; ++slot) // Former slots
+  { tsums->slot[tsums->root[slot]] = IFT_NIL; }
+  if(tsums->touched != NULL)
+  {
+    for(int i = 0; i < tsums->num_changed; ++i) // Records never applied
+    { iftBMapSet0(tsums->touched, tsums->changed[i]); }
+  }
+  tsums->num_changed = 0;
 
-  for(int vi_index = 0; vi_index < sicle->mimg->n; ++vi_index)
+  tsums->num_slots = data->seeds->n;
+  if(tsums->num_slots > tsums->max_slots) // Not enough room?
   {
-    if(data->cost_map[vi_index] != IFTSICLE_BKGCOST)
+    tsums->max_slots = tsums->num_slots;
+    tsums->root = realloc(tsums->root, tsums->max_slots * sizeof(int));
+    assert(tsums->root != NULL);
+    tsums->size = realloc(tsums->size, tsums->max_slots * sizeof(int));
+    assert(tsums->size != NULL);
+    tsums->feats = realloc(tsums->feats, tsums->max_slots * tsums->num_feats *
+                                         sizeof(double));
+    assert(tsums->feats != NULL);
+    tsums->centr = realloc(tsums->centr, tsums->max_slots * 3 * sizeof(long));
+    assert(tsums->centr != NULL);
+    if(tsums->sal != NULL)
     {
-    	int vi_label, vi_root;
-    	iftVoxel vi_voxel;
-
-    	vi_label = iftSICLE_GetRootLabel(data,vi_index);
-    	vi_root = data->root_map[vi_index];
-	  	vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
-      
-      tstats->size[vi_label]++;
-      if(sicle->sal != NULL) // Has saliency?
-      { tstats->sal[vi_label] += sicle->sal[vi_index]; }
-
-    	tstats->centr[vi_label][0] += vi_voxel.x;
-    	tstats->centr[vi_label][1] += vi_voxel.y;
-    	tstats->centr[vi_label][2] += vi_voxel.z;
-
-      for(int f = 0; f < tstats->num_feats; ++f) 
-      { tstats->feats[vi_label][f] += sicle->mimg->val[vi_index][f]; }
-
-    	for(int j = 1; j < data->A->n; ++j)
-    	{
-    		iftVoxel vj_voxel;
-
-    		vj_voxel = iftGetAdjacentVoxel(data->A, vi_voxel, j);
-
-    		if(iftMValidVoxel(sicle->mimg, vj_voxel))
-    		{
-    			int vj_index, vj_root, vj_label;
-
-    			vj_index = iftMGetVoxelIndex(sicle->mimg, vj_voxel);
-    			vj_root = data->root_map[vj_index];
-
-    			// If it is not on the bkg and has different label
-    			if(data->cost_map[vj_index] != IFTSICLE_BKGCOST && vi_root!=vj_root)
-    			{ 
-					vj_label = iftSICLE_GetRootLabel(data, vj_index);
-					iftBMapSet1(tstats->adj[vi_label], vj_label);
-    			
-				}
-    		}
-    	}
+      tsums->sal = realloc(tsums->sal, tsums->max_slots * sizeof(double));
+      assert(tsums->sal != NULL);
     }
   }
+  if(sicle->sal != NULL && tsums->sal == NULL) // Saliency was provided?
+  {
+    tsums->sal = malloc(tsums->max_slots * sizeof(double));
+    assert(tsums->sal != NULL);
+  }
+  else if(sicle->sal == NULL && tsums->sal != NULL)
+  { free(tsums->sal); tsums->sal = NULL; }
 
-  #ifdef IFT_OMP //-----------------------------------------------------------|
-	#pragma omp parallel for
-	#endif //-------------------------------------------------------------------|
-  for(int t_index = 0; t_index < tstats->num_trees; ++t_index) // Compute avg
+  for(int s_id = 0; s_id < data->seeds->n; ++s_id)
   {
-  	for(int d = 0; d < tstats->num_dims; ++d) 
-    { tstats->centr[t_index][d] /= (float)tstats->size[t_index]; }
+    tsums->root[s_id] = data->seeds->val[s_id];
+    tsums->slot[data->seeds->val[s_id]] = s_id;
+  }
+  memset(tsums->size, 0, tsums->num_slots * sizeof(int));
+  memset(tsums->feats, 0, tsums->num_slots * tsums->num_feats * sizeof(double));
+  memset(tsums->centr, 0, tsums->num_slots * 3 * sizeof(long));
+  if(tsums->sal != NULL) 
+  { memset(tsums->sal, 0, tsums->num_slots * sizeof(double)); }
+
+  edge_cap = 1;
+  while(edge_cap < tsums->num_slots * 8) { edge_cap *= 2; }
+  if(edge_cap > tsums->edge_cap) // Not enough room?
+  {
+    tsums->edge_cap = edge_cap;
+    free(tsums->edge_key); free(tsums->edge_count);
+    tsums->edge_key = malloc(tsums->edge_cap * sizeof(long));
+    assert(tsums->edge_key != NULL);
+    tsums->edge_count = calloc(tsums->edge_cap, sizeof(int));
+    assert(tsums->edge_count != NULL);
+  }
+  for(int e = 0; e < tsums->edge_cap; ++e) { tsums->edge_key[e] = -1; }
+  memset(tsums->edge_count, 0, tsums->edge_cap * sizeof(int));
+  tsums->num_keys = 0;
 
-    for(int j = 0; j < tstats->num_feats; ++j) 
-    { tstats->feats[t_index][j] /= (float)tstats->size[t_index]; }
+  tsums->valid = false; // Until accumulated
+}
 
-    if(sicle->sal != NULL) // Has saliency?
-    { tstats->sal[t_index] /= (float)tstats->size[t_index]; }
+/*
+ * Deallocates the respective object 
+ *
+ * PARAMETERS:
+ *		tsums[in/out] - REQUIRED: Pointer to the object to be free'd
+ */
+void iftSICLE_DestroyTSums
+(iftSICLE_TSums **tsums)
+{
+  iftSICLE_FreeMap((*tsums)->is_mapped, (*tsums)->slot, 
+                   (*tsums)->num_vtx * sizeof(int));
+  if((*tsums)->root != NULL) { free((*tsums)->root); }
+  if((*tsums)->size != NULL) { free((*tsums)->size); }
+  if((*tsums)->feats != NULL) { free((*tsums)->feats); }
+  if((*tsums)->centr != NULL) { free((*tsums)->centr); }
+  if((*tsums)->sal != NULL) { free((*tsums)->sal); }
+  free((*tsums)->edge_key);
+  free((*tsums)->edge_count);
+  if((*tsums)->touched != NULL)
+  {
+    iftSICLE_FreeMap((*tsums)->is_mapped, (*tsums)->changed, 
+                     (*tsums)->num_vtx * sizeof(int));
+    iftSICLE_FreeMap((*tsums)->is_mapped, (*tsums)->old_root, 
+                     (*tsums)->num_vtx * sizeof(int));
+    iftDestroyBMap(&((*tsums)->touched));
   }
 
-  return tstats;
+  free(*tsums);
+  (*tsums) = NULL;
 }
 
-//============================================================================|
-// Image Foresting Transform
-//============================================================================|
 /*
- * Computes the connectivity cost between two vertices vi and vj
+ * Records the spel's current root, if it was not recorded since the last
+ * update. It must be called before any modification of the spel's root.
  *
  * PARAMETERS:
- *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  args[in] - REQUIRED: SICLE arguments
- *  data[in] - REQUIRED: IFT auxiliary data
- *  vi_index[in] - REQUIRED: Path's terminus
- *  vj_index[in] - REQUIRED: Vertex to be conquered
+ *  tsums[in/out] - OPTIONAL: Tree sums to be modified. Ignored if NULL,
+ *                            outdated or untracked
+ *  v_index[in] - REQUIRED: Spel whose root will change
+ *  v_root[in] - REQUIRED: Spel's current root
+ */
+static inline void iftSICLE_TrackRootChange
+(iftSICLE_TSums *tsums, int v_index, int v_root)
+{
+  if(tsums != NULL && tsums->valid == true && tsums->touched != NULL && 
+     !iftBMapValue(tsums->touched, v_index)) // Not recorded yet?
+  {
+    iftBMapSet1(tsums->touched, v_index);
+    tsums->old_root[v_index] = v_root;
+    tsums->changed[tsums->num_changed++] = v_index;
+  }
+}
+
+/*
+ * Adds the value provided to the number of adjacent spel pairs between the
+ * trees in the slots given. Nothing is done if they are the same tree or if
+ * any of them is invalid.
  *
- * RETURNS: Connectivity cost between vi and vj
+ * PARAMETERS:
+ *  tsums[in/out] - REQUIRED: Tree sums to be modified
+ *  slot_a[in] - REQUIRED: First tree's slot
+ *  slot_b[in] - REQUIRED: Second tree's slot
+ *  delta[in] - REQUIRED: Value to be added
  */
-float iftSICLE_ConnFunction
-(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data, int vi_index, 
-	int vj_index)
+void iftSICLE_AddTSumsEdge
+(iftSICLE_TSums *tsums, int slot_a, int slot_b, int delta)
 {
-	int vi_root;
-	iftVoxel vi_voxel, vj_voxel;
-	float *vi_root_feats, *vj_feats;
-	double root_feat_dist, spat_dist, sal_dist, arccost, pathcost;
+  int e, mask;
+  long key;
 
-	vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
-	vi_root = data->root_map[vi_index]; 
-	vi_root_feats = sicle->mimg->val[vi_root];
-	
-	vj_voxel = iftMGetVoxelCoord(sicle->mimg,vj_index);
-	vj_feats = sicle->mimg->val[vj_index];
-	
-	root_feat_dist = iftEuclDistance(vi_root_feats, vj_feats, sicle->mimg->m);
-	spat_dist = iftVoxelDistance(vi_voxel, vj_voxel);
-	
-	if(sicle->sal != NULL) // Has saliency?
-	{ sal_dist = fabs(sicle->sal[vi_root] - sicle->sal[vj_index]); }
-	else { sal_dist = 0.0; }
+  if(slot_a == slot_b || slot_a == IFT_NIL || slot_b == IFT_NIL) { return; }
 
-	pathcost = data->cost_map[vi_index];
-	if(args->connopt == IFT_SICLE_CONN_FMAX) // fmax + wroot
-	{ 
-		arccost = pow(root_feat_dist, 1.0 + args->alpha*sal_dist);
-		pathcost = iftMax(pathcost, arccost);
-	}
-	else if(args->connopt == IFT_SICLE_CONN_FSUM) // fsum + wsum
-	{ 
-		arccost = (args->irreg + args->alpha*sal_dist) * root_feat_dist;
-		arccost = iftFastNatPow(arccost, args->adhr) + spat_dist;
-		pathcost += arccost;
-	}
-	else if(args->connopt == IFT_SICLE_CONN_CUSTOM)
-	{
-		/* 
-			You may write here your own connectivity function for testing possible
-			new functionalities for SICLE. For using that, add "--conn-opt custom"
-			in the command-line
-		*/
-		pathcost += 1;
-	}
-	else
-	{ iftError("Unknown connectivity function", __func__); }	
+  if(slot_a > slot_b) { int tmp = slot_a; slot_a = slot_b; slot_b = tmp; }
+  key = (long)slot_a * tsums->num_slots + slot_b;
 
-	return pathcost;
+  mask = tsums->edge_cap - 1; // Linear probing over a power-of-2 capacity
+  e = (int)((key * 0x9E3779B97F4A7C15UL) >> 32) & mask;
+  while(tsums->edge_key[e] != key && tsums->edge_key[e] != -1)
+  { e = (e + 1) & mask; }
+
+  if(tsums->edge_key[e] == -1) // New pair?
+  {
+    tsums->edge_key[e] = key;
+    tsums->edge_count[e] = delta;
+    tsums->num_keys++;
+
+    if(tsums->num_keys * 2 > tsums->edge_cap) // Over half full?
+    {
+      int old_cap, *old_count;
+      long *old_key;
+
+      old_cap = tsums->edge_cap; old_key = tsums->edge_key;
+      old_count = tsums->edge_count;
+
+      tsums->edge_cap *= 2; tsums->num_keys = 0;
+      tsums->edge_key = malloc(tsums->edge_cap * sizeof(long));
+      assert(tsums->edge_key != NULL);
+      tsums->edge_count = calloc(tsums->edge_cap, sizeof(int));
+      assert(tsums->edge_count != NULL);
+      for(int i = 0; i < tsums->edge_cap; ++i) { tsums->edge_key[i] = -1; }
+
+      for(int i = 0; i < old_cap; ++i)
+      {
+        if(old_count[i] > 0) // Pairs which are no longer adjacent are dropped
+        {
+          int s_a, s_b;
+
+          s_a = old_key[i] / tsums->num_slots; s_b = old_key[i] % tsums->num_slots;
+          iftSICLE_AddTSumsEdge(tsums, s_a, s_b, old_count[i]);
+        }
+      }
+      free(old_key); free(old_count);
+    }
+  }
+  else { tsums->edge_count[e] += delta; }
 }
 
+//============================================================================|
+// iftSICLE_IFTData
+//============================================================================|
 /*
- * Executes one sequential IFT with the seeds defined in the IFT data provided,
- * which is modified and updated in-place
+ * Computes the linear index displacement and distance of each adjacent with
+ * respect to the IFT data's adjacency relation, as well as the border shell
+ * of the image, which is the only region requiring domain verification.
  *
  * PARAMETERS:
  *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  args[in] - REQUIRED: SICLE arguments
  *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
  */
-void iftSICLE_RunSeedIFT
-(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data)
+void iftSICLE_CalcAdjOffsets
+(iftSICLE *sicle, iftSICLE_IFTData *data)
 {
-	iftDHeap *heap;
+	int xsize, ysize, zsize, rad;
 
-	heap = iftCreateDHeap(sicle->mimg->n, (*data)->cost_map);
-	iftSetRemovalPolicyDHeap(heap, MINVALUE);
+	xsize = sicle->mimg->xsize; ysize = sicle->mimg->ysize; 
+	zsize = sicle->mimg->zsize;
 
-	iftSICLE_ResetIFTData(sicle, data); // Prepare data for the sequential IFT
-	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id) 
-	{ iftInsertDHeap(heap, (*data)->seeds->val[s_id]); } // Add seeds
+	data->adj_off = calloc(data->A->n, sizeof(int));
+	assert(data->adj_off != NULL);
+	data->adj_dist = calloc(data->A->n, sizeof(float));
+	assert(data->adj_dist != NULL);
 
-	while(!iftEmptyDHeap(heap))
+	rad = 0;
+	for(int j = 0; j < data->A->n; ++j)
 	{
-		int vi_index, vi_root;
-		iftVoxel vi_voxel;
-
-		vi_index = iftRemoveDHeap(heap);
-		vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
-		vi_root = (*data)->root_map[vi_index]; 
+		int dx, dy, dz;
 
-		for(int j = 1; j < (*data)->A->n; ++j)
-  	{
-  		iftVoxel vj_voxel;
+		dx = data->A->dx[j]; dy = data->A->dy[j]; dz = data->A->dz[j];
+		data->adj_off[j] = dx + dy * xsize + dz * xsize * ysize;
+		data->adj_dist[j] = sqrtf(dx * dx + dy * dy + dz * dz);
+		rad = iftMax(rad, iftMax(abs(dx), iftMax(abs(dy), abs(dz))));
+	}
+	data->adj_rad = rad;
 
-  		vj_voxel = iftGetAdjacentVoxel((*data)->A, vi_voxel, j);
+	data->border = iftCreateBMap(sicle->mimg->n);
+	for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+	{
+		iftVoxel v_voxel;
 
-  		if(iftMValidVoxel(sicle->mimg, vj_voxel))
-  		{
-  			int vj_index;
+		v_voxel = iftMGetVoxelCoord(sicle->mimg, v_index);
+		if(v_voxel.x < rad || v_voxel.x >= xsize - rad || 
+			 v_voxel.y < rad || v_voxel.y >= ysize - rad ||
+			 (zsize > 1 && (v_voxel.z < rad || v_voxel.z >= zsize - rad)))
+		{ iftBMapSet1(data->border, v_index); }
+	}
+}
 
-  			vj_index = iftMGetVoxelIndex(sicle->mimg, vj_voxel);
-  			if(heap->color[vj_index] != IFT_BLACK) // Out of the heap?
-  			{
-  				double pathcost;
+/*
+ * Gets the index of the j-th adjacent of the vertex, or IFT_NIL if it falls
+ * outside the image domain. Only border vertices require such verification.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  v_index[in] - REQUIRED: Vertex index
+ *  is_border[in] - REQUIRED: Whether the vertex lies on the border shell
+ *  adj[in] - REQUIRED: Adjacent index
+ *
+ * RETURNS: Adjacent's index, or IFT_NIL if it is out of the domain
+ */
+static inline int iftSICLE_GetAdjIndex
+(iftSICLE *sicle, iftSICLE_IFTData *data, int v_index, bool is_border, int adj)
+{
+	iftVoxel v_voxel, u_voxel;
 
-  				pathcost = iftSICLE_ConnFunction(sicle, args, *data, vi_index, vj_index);
+	if(is_border == false) { return v_index + data->adj_off[adj]; }
 
-					if(pathcost < (*data)->cost_map[vj_index]) // Lesser path-cost?
-					{
-						if(heap->color[vj_index] == IFT_GRAY) // Already within the heap?
-						{ iftRemoveDHeapElem(heap, vj_index); } // Remove for update
+	v_voxel = iftMGetVoxelCoord(sicle->mimg, v_index);
+	u_voxel = iftGetAdjacentVoxel(data->A, v_voxel, adj);
 
-						(*data)->root_map[vj_index] = vi_root; // 
-						(*data)->pred_map[vj_index] = vi_index;// Mark as conquered
-						(*data)->cost_map[vj_index] = pathcost;//
-						iftInsertDHeap(heap, vj_index);
-					}
-  			}
-  		}
-  	}
-	}
-	iftDestroyDHeap(&heap);
+	if(iftMValidVoxel(sicle->mimg, u_voxel) == true)
+	{ return iftMGetVoxelIndex(sicle->mimg, u_voxel); }
+	else { return IFT_NIL; }
 }
 
 /*
- * Executes one differential IFT with the seeds defined in the IFT data 
- * provided, which is modified and updated in-place
+ * Joins the seeds carried from a previous execution to the sampled ones, such
+ * that the former are kept as candidates. Repeated, non-ROI and out-of-domain
+ * spels are ignored.
  *
  * PARAMETERS:
  *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  args[in] - REQUIRED: SICLE arguments
- *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
- *  irre_seeds[in/out] - REQUIRED: Irrelevant seeds to be removed
+ *  seeds[in/out] - REQUIRED: Sampled seeds to be replaced by the joined ones
  */
-void iftSICLE_RunSeedDIFT
-(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data, 
-	iftSet **irre_seeds)
+void iftSICLE_JoinCarriedSeeds
+(iftSICLE *sicle, iftIntArray **seeds)
 {
-	iftSet *frontier;
-	iftDHeap *heap;
-
-	frontier = iftSICLE_RemoveTrees(sicle, data, irre_seeds);//Remove irrelevants
-	heap = iftCreateDHeap(sicle->mimg->n, (*data)->cost_map);
-	iftSetRemovalPolicyDHeap(heap, MINVALUE);
-
-	#ifdef IFT_OMP //-----------------------------------------------------------|
-	#pragma omp parallel for
-	#endif //-------------------------------------------------------------------|
-	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id) // Update labels
-	{ (*data)->pred_map[(*data)->seeds->val[s_id]] = -(s_id + 1); } // 2's compl
+	int num_joined;
+	iftBMap *marked;
+	iftIntArray *joined;
 
-	while(frontier != NULL)
-	{ iftInsertDHeap(heap, iftRemoveSet(&frontier)); }
+	joined = iftCreateIntArray((*seeds)->n + sicle->carried_seeds->n);
+	marked = iftCreateBMap(sicle->mimg->n);
 
-	while(iftEmptyDHeap(heap) == false)
+	num_joined = 0;
+	for(long i = 0; i < sicle->carried_seeds->n + (*seeds)->n; ++i)
 	{
-		int vi_index, vi_root;
-		iftVoxel vi_voxel;
+		int s_index;
 
-		vi_index = iftRemoveDHeap(heap);
-		vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
-		vi_root = (*data)->root_map[vi_index]; 
+		if(i < sicle->carried_seeds->n) { s_index = sicle->carried_seeds->val[i]; }
+		else { s_index = (*seeds)->val[i - sicle->carried_seeds->n]; }
 
-		for(int j = 1; j < (*data)->A->n; ++j)
-  	{
-  		iftVoxel vj_voxel;
+		if(s_index >= 0 && s_index < sicle->mimg->n && 
+			 !iftBMapValue(marked, s_index) && iftSICLE_InROI(sicle, s_index))
+		{
+			joined->val[num_joined] = s_index;
+			iftBMapSet1(marked, s_index);
+			num_joined++;
+		}
+	}
+	joined->n = num_joined;
+	iftDestroyBMap(&marked);
 
-  		vj_voxel = iftGetAdjacentVoxel((*data)->A, vi_voxel, j);
+	iftDestroyIntArray(seeds);
+	(*seeds) = joined;
+}
 
-  		if(iftMValidVoxel(sicle->mimg, vj_voxel))
-  		{
-  			int vj_index;
+/*
+ * Oversamples the seeds according to the sampling option provided
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *
+ * RETURNS: Sampled seeds
+ */
+iftIntArray *iftSICLE_SampleSeeds
+(iftSICLE *sicle, iftSICLEArgs *args)
+{
+	iftIntArray *seeds;
 
-  			vj_index = iftMGetVoxelIndex(sicle->mimg, vj_voxel);
-  			if(heap->color[vj_index] != IFT_BLACK) // Out of the heap?
-  			{
-  				double pathcost;
-		
-  				pathcost = iftSICLE_ConnFunction(sicle, args, *data, vi_index, vj_index);
+	if(args->n0 <= 0) { seeds = iftCreateIntArray(0); } // Only carried seeds
+	else if(args->samplopt == IFT_SICLE_SAMPL_RND)
+	{ seeds = iftSICLE_RndOversampl(sicle, args); }
+	else if(args->samplopt == IFT_SICLE_SAMPL_GRID)
+	{ seeds = iftSICLE_GridOversampl(sicle, args); }
+	else if(args->samplopt == IFT_SICLE_SAMPL_CUSTOM)
+	{ 
+  	/* 
+			You may write here your own seed oversampling method for testing possible
+			new functionalities for SICLE. For using that, add "--sampl-opt custom"
+			in the command-line
+		*/
+		seeds = iftSICLE_RndOversampl(sicle, args); 
+	}
+	else
+	{ iftError("Unknown seed sampling option", __func__); return NULL; }
 
-					if(pathcost < (*data)->cost_map[vj_index]) // Lesser path-cost?
-					{
-						if(heap->color[vj_index] == IFT_GRAY) // Already within the heap?
-						{ iftRemoveDHeapElem(heap, vj_index); } // Remove for update
+	if(sicle->carried_seeds != NULL) // Consumed by this sampling
+	{ 
+		iftSICLE_JoinCarriedSeeds(sicle, &seeds); 
+		iftDestroyIntArray(&(sicle->carried_seeds));
+	}
 
-						(*data)->root_map[vj_index] = vi_root; //
-						(*data)->pred_map[vj_index] = vi_index;// Mark as conquered
-						(*data)->cost_map[vj_index] = pathcost;//
-						iftInsertDHeap(heap, vj_index);
-					}
-					else if(vi_index == (*data)->pred_map[vj_index])
-					{
-						if(pathcost > (*data)->cost_map[vj_index] || 
-							 vi_root != (*data)->root_map[vj_index])
-							//Inconsistency -> Remove and Compete again
-						{ iftSICLE_RemoveSubtree(sicle, vj_index, data, &heap);}
-					}
-  			}
-  		}
-  	}
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	fprintf(stderr, "DEBUG (%s): %ld seeds sampled\n", __func__, seeds->n);
+	#endif //-------------------------------------------------------------------|	
+
+	return seeds;
+}
+
+/*
+ * Allocates the stacks and the visiting map for removing subtrees, if the
+ * arguments require them and they were not allocated yet
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ */
+void iftSICLE_AllocRemovalStacks
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data)
+{
+	if((args->use_dift == true || args->tile_size > 0) && // Removes subtrees?
+		 data->visit == NULL)
+	{
+		data->remove_stack = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(int));
+		data->front_stack = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(int));
+		data->visit = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(int));
+		data->epoch = 0;
 	}
-	iftDestroyDHeap(&heap);
 }
 
-//============================================================================|
-// Seed Removal
-//============================================================================|
 /*
- * Calculate the priority/relevance of the seeds based on the predefined 
- * criterion and penalization. 
+ * Creates and allocates memory for an IFT data instance
  *
  * PARAMETERS:
  *  sicle[in] - REQUIRED: SICLE auxiliary data
  *  args[in] - REQUIRED: SICLE arguments
- *  data[in] - REQUIRED: IFT auxiliary data
  *
- * RETURNS: Double |S|-sized array of seeds' priority/relevance
+ * RETURNS: Instance of the object
  */
-double *iftSICLE_CalcSeedPrio
-(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data)
+iftSICLE_IFTData *iftSICLE_CreateIFTData
+(iftSICLE *sicle, iftSICLEArgs *args)
 {
-  double *prio;
-  iftSICLE_TStats *tstats;
+	iftSICLE_IFTData *data;
 
-  prio = calloc(data->seeds->n, sizeof(double));
-  tstats = iftSICLE_CalcTStats(sicle, args, data);
-	
-  #ifdef IFT_OMP //-----------------------------------------------------------|
-	#pragma omp parallel for
-	#endif //-------------------------------------------------------------------|
-  for(long ti_index = 0; ti_index < tstats->num_trees; ++ti_index)
-  {
-    double size_perc, min_color_grad, max_sal_grad, min_dist, num_adjs,
-    			 max_color_grad, dist_perc;
+	data = malloc(sizeof(iftSICLE_IFTData));
+	assert(data != NULL);
 
-    size_perc = tstats->size[ti_index]/(float)sicle->mimg->n; 
+	data->num_vtx = sicle->mimg->n;
+	data->is_mapped = sicle->scratch_dir != NULL;
+	#ifdef IFT_COMPACT //-------------------------------------------------------|
+	data->node = iftSICLE_AllocMap(sicle, data->num_vtx * sizeof(iftSICLE_Node));
+	#else //--------------------------------------------------------------------|
+	data->root_map = iftSICLE_AllocMap(sicle, data->num_vtx * sizeof(int));
+	data->pred_map = iftSICLE_AllocMap(sicle, data->num_vtx * sizeof(int));
+	data->cost_map = iftSICLE_AllocMap(sicle, data->num_vtx * sizeof(double));
+	#endif //-------------------------------------------------------------------|
+	
+	if(args->use_diag == true) 
+	{
+		if(iftIs3DMImage(sicle->mimg) == true) 
+		{ data->A = iftSpheric(sqrtf(3.0)); }
+		else { data->A = iftCircular(sqrtf(2.0)); }
+	}
+	else
+	{
+		if(iftIs3DMImage(sicle->mimg) == true) { data->A = iftSpheric(1.0); }
+		else { data->A = iftCircular(1.0); }
+	}
+	iftSICLE_CalcAdjOffsets(sicle, data);
+	data->tsums = NULL; // Created on the first seed removal
 
-    max_sal_grad = max_color_grad = 0.0;
-    min_color_grad = min_dist = IFT_INFINITY_DBL;
-    num_adjs = 0;
-  	for(long tj_index = 0; tj_index < tstats->num_trees; ++tj_index)
-    {
-    	if(iftBMapValue(tstats->adj[ti_index],tj_index))
-    	{
-    		double sal_grad, grad, dist;
-	     	
-	     	num_adjs++; 
-	      grad= iftEuclDistance(tstats->feats[ti_index], tstats->feats[tj_index],
-	                             tstats->num_feats);
-	      dist= iftEuclDistance(tstats->centr[ti_index], tstats->centr[tj_index],
-	      											 tstats->num_dims);
-
-	      if(grad < min_color_grad) { min_color_grad = grad; }
-	      if(grad > max_color_grad) { max_color_grad = grad; }
-	      if(dist < min_dist) { min_dist = dist; }
-
-	      if(sicle->sal != NULL) // Has saliency?
-	      { 
-	      	sal_grad = fabs(tstats->sal[ti_index] - tstats->sal[tj_index]); 
-	      	if(sal_grad > max_sal_grad) { max_sal_grad = sal_grad; }
-	      }
-    	}
-    }
-	dist_perc = min_dist/iftDiagonalSize(sicle->mimg);
+	data->remove_stack = data->front_stack = data->visit = NULL;
+	data->epoch = 0;
+	iftSICLE_AllocRemovalStacks(sicle, args, data);
 
-		if(args->critopt == IFT_SICLE_CRIT_SIZE)
-    { prio[ti_index] = size_perc; }
-    else if(args->critopt == IFT_SICLE_CRIT_MINSC)
-    { prio[ti_index] = size_perc * min_color_grad; }
-    else if(args->critopt == IFT_SICLE_CRIT_MAXSC)
-    { prio[ti_index] = size_perc * max_color_grad; }
-  	else if(args->critopt == IFT_SICLE_CRIT_SPREAD)
-    { prio[ti_index] = size_perc * min_dist; }
-		else if(args->critopt == IFT_SICLE_CRIT_CUSTOM)
-    {
-    	/* 
-				You may write here your own criterion function for testing possible
-				new functionalities for SICLE. For using that, add "--crit-opt custom"
-				in the command-line
-			*/
-    	prio[ti_index] = size_perc*1.0/min_dist;
-    }
-    else 
-    { iftError("Unknown seed removal criterion fuction", __func__); }
+	data->queue = iftSICLE_CreatePQueue(sicle, args, data);
+	data->seeds = iftSICLE_SampleSeeds(sicle, args);
 
-    if(args->penopt == IFT_SICLE_PEN_OBJ)
-  	{ prio[ti_index]*= iftMax(tstats->sal[ti_index], max_sal_grad); }
-  	else if(args->penopt == IFT_SICLE_PEN_BORD)
-  	{ prio[ti_index]*= max_sal_grad; }
-  	else if(args->penopt == IFT_SICLE_PEN_OSB)
-  	{
-  	  float bkg_relevance;
+	return data;
+}
 
-  	  bkg_relevance = (1.0 - tstats->sal[ti_index])*dist_perc;
-  	  prio[ti_index]*= iftMax(tstats->sal[ti_index],bkg_relevance);
-  	}
-  	else if(args->penopt == IFT_SICLE_PEN_BOBS)
-  	{
-  	  float bkg_relevance, obj_relevance;
-			
-			obj_relevance = tstats->sal[ti_index]*max_sal_grad;
-  	  bkg_relevance = (1.0 - tstats->sal[ti_index])*dist_perc;
-  	  prio[ti_index]*= iftMax(obj_relevance,bkg_relevance);
-  	}
-  	else if(args->penopt == IFT_SICLE_PEN_CUSTOM)
-  	{
-    	/* 
-				You may write here your own penalization function for testing possible
-				new functionalities for SICLE. For using that, add "--pen-opt custom"
-				in the command-line
-			*/
-  	  prio[ti_index]*= 1;
-  	}
-  	else if(args->penopt != IFT_SICLE_PEN_NONE)
-		{ iftError("Unknown seed relevance penalization", __func__); }
-  }
-  iftSICLE_DestroyTStats(&tstats);
+/*
+ * Deallocates the respective object 
+ *
+ * PARAMETERS:
+ *		args[in/out] - REQUIRED: Pointer to the object to be free'd
+ */
+void iftSICLE_DestroyIFTData
+(iftSICLE_IFTData **data)
+{
+	bool is_mapped;
+	size_t n;
+
+	is_mapped = (*data)->is_mapped;
+	n = (*data)->num_vtx;
+	#ifdef IFT_COMPACT //-------------------------------------------------------|
+	iftSICLE_FreeMap(is_mapped, (*data)->node, n * sizeof(iftSICLE_Node));
+	#else //--------------------------------------------------------------------|
+	iftSICLE_FreeMap(is_mapped, (*data)->root_map, n * sizeof(int));
+	iftSICLE_FreeMap(is_mapped, (*data)->pred_map, n * sizeof(int));
+	iftSICLE_FreeMap(is_mapped, (*data)->cost_map, n * sizeof(double));
+	#endif //-------------------------------------------------------------------|
+	iftDestroyIntArray(&((*data)->seeds));
+	iftDestroyAdjRel(&((*data)->A));
+	free((*data)->adj_off);
+	free((*data)->adj_dist);
+	iftDestroyBMap(&((*data)->border));
+	if((*data)->tsums != NULL) { iftSICLE_DestroyTSums(&((*data)->tsums)); }
+	iftSICLE_DestroyPQueue(&((*data)->queue));
+	if((*data)->visit != NULL)
+	{
+		iftSICLE_FreeMap(is_mapped, (*data)->remove_stack, n * sizeof(int));
+		iftSICLE_FreeMap(is_mapped, (*data)->front_stack, n * sizeof(int));
+		iftSICLE_FreeMap(is_mapped, (*data)->visit, n * sizeof(int));
+	}
 
-  return prio;
+	free(*data);
+	(*data) = NULL;
 }
 
 /*
- * Removes Ni irrelevant seeds for the next IFT execution
+ * Resets the IFT data to a pre-IFT state: assigns temporary costs and 
+ * predecessors, and reassigns labels to seeds and background spels.
  *
  * PARAMETERS:
  *  sicle[in] - REQUIRED: SICLE auxiliary data
- *  num_maint[in] - REQUIRED: Number of seeds to be maintained
- *  args[in] - REQUIRED: SICLE arguments
  *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
- *  irre_seeds[in/out] - REQUIRED: Irrelevant seeds selected to be removed
  */
-void iftSICLE_RemSeeds
-(iftSICLE *sicle, int num_maint, iftSICLEArgs *args, iftSICLE_IFTData **data,
- iftSet **irre_seeds)
+void iftSICLE_ResetIFTData
+(iftSICLE *sicle, iftSICLE_IFTData **data)
 {
-  double *prio;
-  iftIntArray *new_seeds;
-  iftDHeap *heap;
-
-  prio = iftSICLE_CalcSeedPrio(sicle, args, (*data));
-  heap = iftCreateDHeap((*data)->seeds->n, prio);
-  iftSetRemovalPolicyDHeap(heap, MAXVALUE);
-
-  new_seeds = iftCreateIntArray(num_maint); // Empty array
+	// The tree sums are outdated by a new forest
+	if((*data)->tsums != NULL) { (*data)->tsums->valid = false; }
 
-  for(long s_id = 0; s_id < (*data)->seeds->n; ++s_id) // Add all for ordering
-  { iftInsertDHeap(heap, s_id); } 
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+	{
+		iftSICLE_PredOf(*data, v_index) = IFTSICLE_NIL;
+		iftSICLE_RootOf(*data, v_index) = IFTSICLE_NIL;
+		#ifdef IFT_COMPACT //-----------------------------------------------------|
+		(*data)->node[v_index].pos = IFTSICLE_WHITE_POS; // For the tiles' queues
+		#endif //-----------------------------------------------------------------|
 
-  for(long i = 0; i < num_maint; ++i) // Add relevants
-  { new_seeds->val[i] = (*data)->seeds->val[iftRemoveDHeap(heap)]; }
+		if(!iftSICLE_InROI(sicle,v_index)) // Won't be conquered
+		{ iftSICLE_CostOf(*data, v_index) = IFTSICLE_BKGCOST; } 
+		else 
+		{ iftSICLE_CostOf(*data, v_index) = IFTSICLE_TMPCOST; }
+	}
 
-	(*irre_seeds) = NULL;
-  while(!iftEmptyDHeap(heap)) // Add irrelevants for removal
-  { iftInsertSet(irre_seeds, (*data)->seeds->val[iftRemoveDHeap(heap)]); }
-	iftDestroyIntArray(&((*data)->seeds));
-	(*data)->seeds = new_seeds;
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id)
+	{
+		int s_index;
 
-  free(prio);
-  iftDestroyDHeap(&heap);
+		s_index = (*data)->seeds->val[s_id];
+		iftSICLE_RootOf(*data, s_index) = s_index;
+		iftSICLE_PredOf(*data, s_index) = -(s_id + 1); // 2's complement
+		iftSICLE_CostOf(*data, s_index) = 0;
+	}
 }
 
-//############################################################################|
-// 
-//	PUBLIC METHODS
-//
-//############################################################################|
-//============================================================================|
-// iftSICLEArgs
-//============================================================================|
-iftSICLEArgs *iftCreateSICLEArgs()
+/*
+ * Gets the IFT data kept as the workspace of the SICLE prototype, with newly
+ * sampled seeds. It is (re)created only if it does not exist or if it is
+ * incompatible with the arguments provided; otherwise, its buffers are 
+ * reused, avoiding reallocations across the executions.
+ *
+ * PARAMETERS:
+ *  sicle[in/out] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *
+ * RETURNS: IFT data owned by the SICLE prototype
+ */
+iftSICLE_IFTData *iftSICLE_AcquireIFTData
+(iftSICLE *sicle, iftSICLEArgs *args)
 {
-	iftSICLEArgs *args;
+	iftSICLE_IFTData *data;
 
-	args = malloc(sizeof(iftSICLEArgs));
-	assert(args != NULL);
+	data = sicle->ws;
+	if(data != NULL)
+	{
+		bool same_adj, same_queue;
+
+		same_adj = args->use_diag == (data->A->n == 9 || data->A->n == 27);
+		#ifdef IFT_COMPACT //-----------------------------------------------------|
+		same_queue = true; // Always a binary heap
+		#else //------------------------------------------------------------------|
+		if(data->queue->bqueue != NULL)
+		{ 
+			same_queue = args->use_bqueue == true && 
+									 args->num_buckets == data->queue->bqueue->nbuckets; 
+		}
+		else { same_queue = args->use_bqueue == false; }
+		#endif //-----------------------------------------------------------------|
 
-	args->use_diag = true;
-	args->use_dift = true;
-	args->n0 = 3000;
-	args->nf = 200;
-	args->max_iters = 5;
-	args->irreg = 0.12;
-	args->adhr = 12;
-	args->alpha = 0.0;
-	args->user_ni = NULL;
-	args->samplopt = IFT_SICLE_SAMPL_RND;
-	args->connopt = IFT_SICLE_CONN_FMAX;
-	args->critopt = IFT_SICLE_CRIT_MINSC;
-	args->penopt = IFT_SICLE_PEN_NONE;
+		if(same_adj == false || same_queue == false)
+		{ iftSICLE_DestroyIFTData(&(sicle->ws)); data = NULL; }
+	}
 
-	return args;
+	if(data == NULL) { data = sicle->ws = iftSICLE_CreateIFTData(sicle, args); }
+	else
+	{
+		iftSICLE_AllocRemovalStacks(sicle, args, data);
+		#ifndef IFT_COMPACT //----------------------------------------------------|
+		if(data->queue->bqueue != NULL) // The features may have changed
+		{ 
+			data->queue->bqueue->scale = (data->queue->bqueue->nbuckets - 1) / 
+																	 iftSICLE_CalcMaxFmaxCost(sicle, args);
+		}
+		#endif //-----------------------------------------------------------------|
+		if(data->tsums != NULL) { data->tsums->valid = false; }
+
+		iftDestroyIntArray(&(data->seeds));
+		data->seeds = iftSICLE_SampleSeeds(sicle, args);
+	}
+
+	return data;
 }
 
-inline void iftDestroySICLEArgs
-(iftSICLEArgs **args)
+/*
+ * Expands the bounding box provided, if any, for including the spel given
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  v_index[in] - REQUIRED: Spel to be included
+ *  bb[in/out] - OPTIONAL: Bounding box to be expanded
+ */
+static inline void iftSICLE_ExpandBox
+(iftSICLE *sicle, int v_index, iftBoundingBox *bb)
 {
-	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	assert(args != NULL);
-	#endif //-------------------------------------------------------------------|
-	if((*args) != NULL) 
+	if(bb != NULL)
 	{
-		if((*args)->user_ni != NULL) { iftDestroyIntArray(&((*args)->user_ni)); } 
-		free(*args); 
+		iftVoxel v_voxel;
+
+		v_voxel = iftMGetVoxelCoord(sicle->mimg, v_index);
+		bb->begin.x = iftMin(bb->begin.x, v_voxel.x);
+		bb->begin.y = iftMin(bb->begin.y, v_voxel.y);
+		bb->begin.z = iftMin(bb->begin.z, v_voxel.z);
+		bb->end.x = iftMax(bb->end.x, v_voxel.x);
+		bb->end.y = iftMax(bb->end.y, v_voxel.y);
+		bb->end.z = iftMax(bb->end.z, v_voxel.z);
+	}
+}
+
+/*
+ * Starts a new visiting epoch, such that no spel is considered as visited
+ * without clearing the visiting map (unless the epochs overflow)
+ *
+ * PARAMETERS:
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ */
+static inline void iftSICLE_NewVisitEpoch
+(iftSICLE_IFTData *data)
+{
+	if(data->epoch == INT_MAX) // Overflow?
+	{ memset(data->visit, 0, data->num_vtx * sizeof(int)); data->epoch = 0; }
+	data->epoch++;
+}
+
+/*
+ * Removes the trees of the irrelevant seeds, marked to be removed, and 
+ * stacks the spels at the frontier to be inserted for the differential 
+ * computation within the IFT data's frontier stack.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  irre_seeds[in/out] - REQUIRED: Irrelevant seeds to be removed. It is free'd
+ *  bb[in/out] - OPTIONAL: Bounding box expanded by the removed spels
+ *
+ * RETURNS: Number of spels at the frontier of the removed trees
+ */
+int iftSICLE_RemoveTrees
+(iftSICLE *sicle, iftSICLE_IFTData **data, iftIntArray **irre_seeds,
+ iftBoundingBox *bb)
+{
+	int num_remove, num_front;
+
+  iftSICLE_NewVisitEpoch(*data);
+
+  num_remove = 0;
+  for(int i = 0; i < (*irre_seeds)->n; ++i)
+  {
+  	int s_index;
+
+  	s_index = (*irre_seeds)->val[i];
+		iftSICLE_TrackRootChange((*data)->tsums, s_index, iftSICLE_RootOf(*data, s_index));
+		iftSICLE_PredOf(*data, s_index) = IFTSICLE_NIL; // Temporary predecessor		
+    iftSICLE_RootOf(*data, s_index) = IFTSICLE_NIL; // Temporary root
+    iftSICLE_CostOf(*data, s_index) = IFTSICLE_TMPCOST; // Temporary cost
+    (*data)->remove_stack[num_remove++] = s_index; // Add for BFS removal
+  }
+  iftDestroyIntArray(irre_seeds);
+
+  num_front = 0;
+  while(num_remove > 0)
+  {
+  	int vi_index;
+  	bool vi_border;
+
+  	vi_index = (*data)->remove_stack[--num_remove];
+  	vi_border = iftBMapValue((*data)->border, vi_index);
+  	iftSICLE_ExpandBox(sicle, vi_index, bb);
+
+  	for(int j = 1; j < (*data)->A->n; ++j)
+  	{
+  		int vj_index;
+
+  		vj_index = iftSICLE_GetAdjIndex(sicle, *data, vi_index, vi_border, j);
+
+  		if(vj_index != IFT_NIL)
+  		{
+  			int vj_root;
+
+  			vj_root = iftSICLE_RootOf(*data, vj_index);
+
+  			if(iftSICLE_CostOf(*data, vj_index) != IFTSICLE_BKGCOST) // If not in bkg
+  			{
+  				// If belongs to the subtree being removed at moment
+  				if(iftSICLE_PredOf(*data, vj_index) == vi_index)
+  				{
+  					iftSICLE_TrackRootChange((*data)->tsums, vj_index, iftSICLE_RootOf(*data, vj_index));
+  					iftSICLE_PredOf(*data, vj_index) = IFTSICLE_NIL; //Temporary predecessor
+				    iftSICLE_RootOf(*data, vj_index) = IFTSICLE_NIL; // Temporary root
+				    iftSICLE_CostOf(*data, vj_index) = IFTSICLE_TMPCOST; // Temporary cost
+				    (*data)->remove_stack[num_remove++] = vj_index; // Add for BFS removal
+  				}
+  				else if(vj_root != IFTSICLE_NIL && // If it wasnt removed
+  							 	iftSICLE_RootOf(*data, vj_root) != IFTSICLE_NIL && // If relevant
+  							 	(*data)->visit[vj_index] != (*data)->epoch) //If not yet visited
+					{ 
+						(*data)->visit[vj_index] = (*data)->epoch; // Visited
+						(*data)->front_stack[num_front++] = vj_index; // Frontier
+					}
+  			}
+  		}
+  	}
+  }
+
+  return num_front;
+}
+
+/*
+ * Removes the subtree of the given vertex and updates those spels at the 
+ * frontier for a new competition in the differential computation.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  v_index[in] - REQUIRED: "Root" of the subtree to be removed
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  queue[in/out] - REQUIRED: Priority queue of the current IFT execution to
+ *													 be updated.
+ */
+void iftSICLE_RemoveSubtree
+(iftSICLE *sicle, int v_index, iftSICLE_IFTData **data, iftSICLE_PQueue *queue)
+{
+	int num_remove, num_front;
+
+  iftSICLE_NewVisitEpoch(*data);
+
+  num_remove = num_front = 0;
+  (*data)->remove_stack[num_remove++] = v_index;
+  while(num_remove > 0)
+  {
+  	int vi_index;
+  	bool vi_border;
+
+  	vi_index = (*data)->remove_stack[--num_remove];
+  	vi_border = iftBMapValue((*data)->border, vi_index);
+
+    iftSICLE_TrackRootChange((*data)->tsums, vi_index, iftSICLE_RootOf(*data, vi_index));
+    iftSICLE_RootOf(*data, vi_index) = IFTSICLE_NIL; // Temporary root
+    iftSICLE_PredOf(*data, vi_index) = IFTSICLE_NIL; // Temporary predecessor
+    iftSICLE_CostOf(*data, vi_index) = IFTSICLE_TMPCOST; // Temporary cost
+
+    if(iftSICLE_InPQueue(queue, vi_index))
+    { iftSICLE_RemovePQueueElem(queue, vi_index); } // Remove if exists in queue
+  	else { iftSICLE_ClearPQueueStatus(queue, vi_index); } // Clear its status
+
+  	for(int j = 1; j < (*data)->A->n; ++j)
+  	{
+  		int vj_index;
+
+  		vj_index = iftSICLE_GetAdjIndex(sicle, *data, vi_index, vi_border, j);
+
+  		if(vj_index != IFT_NIL)
+  		{
+  			
+	  		if(iftSICLE_PredOf(*data, vj_index) == vi_index) // If belongs to subtree
+				{ (*data)->remove_stack[num_remove++] = vj_index; } // Add to BFS removal
+				else if(iftSICLE_CostOf(*data, vj_index) != IFTSICLE_BKGCOST && // Not bkg
+								iftSICLE_CostOf(*data, vj_index) != IFTSICLE_TMPCOST && // Reached
+								(*data)->visit[vj_index] != (*data)->epoch) // Visited
+				{ 
+					(*data)->visit[vj_index] = (*data)->epoch; // Visited
+					(*data)->front_stack[num_front++] = vj_index; // Probable frontier
+				}
+  		}
+  	}
+  }
+
+  while(num_front > 0)
+  {
+  	int vi_index;
+
+  	vi_index = (*data)->front_stack[--num_front];
+
+  	if(iftSICLE_InPQueue(queue, vi_index)) // Already in queue?
+		{ iftSICLE_RemovePQueueElem(queue, vi_index); } // Remove for update
+		iftSICLE_InsertPQueue(queue, vi_index); // Add/update
+  }
+}
+
+//============================================================================|
+// iftSICLE_TStats
+//============================================================================|
+/*
+ * Creates and allocates memory for an Tree statistics instance
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *
+ * RETURNS: Instance of the object
+ */
+iftSICLE_TStats *iftSICLE_CreateTStats
+(iftSICLE *sicle, iftSICLE_IFTData *data)
+{
+	iftSICLE_TStats *tstats;
+
+  tstats = malloc(sizeof(iftSICLE_TStats));
+  assert(tstats != NULL);
+
+  tstats->num_trees = data->seeds->n;
+  tstats->num_feats = sicle->mimg->m;
+  tstats->num_dims = 3;
+
+  tstats->size = calloc(data->seeds->n, sizeof(int));
+  assert(tstats->size != NULL);
+
+  tstats->adj_first = calloc(data->seeds->n + 1, sizeof(int));
+  assert(tstats->adj_first != NULL);
+  tstats->adj = NULL; // Computed along with the statistics
+
+  tstats->feats = calloc(data->seeds->n, sizeof(float*));
+  assert(tstats->feats != NULL);
+
+  tstats->centr = calloc(data->seeds->n, sizeof(float*));
+  assert(tstats->centr != NULL);
+
+  if(sicle->sal == NULL) { tstats->sal = NULL; }
+  else
+  {
+  	tstats->sal = calloc(data->seeds->n, sizeof(float));
+	  assert(tstats->sal != NULL);
+  }
+
+  for(long s_id = 0; s_id < data->seeds->n; ++s_id)
+  { 
+    tstats->feats[s_id] = calloc(tstats->num_feats, sizeof(float));
+    assert(tstats->feats[s_id] != NULL);
+
+    tstats->centr[s_id] = calloc(tstats->num_dims, sizeof(float));
+    assert(tstats->centr[s_id] != NULL);
+  }
+
+  return tstats;
+}
+
+/*
+ * Deallocates the respective object 
+ *
+ * PARAMETERS:
+ *		args[in/out] - REQUIRED: Pointer to the object to be free'd
+ */
+void iftSICLE_DestroyTStats
+(iftSICLE_TStats **tstats)
+{
+  free((*tstats)->size);
+  if((*tstats)->sal != NULL) { free((*tstats)->sal); }
+  for(int i = 0; i < (*tstats)->num_trees; ++i)
+  {
+    free((*tstats)->feats[i]);
+    free((*tstats)->centr[i]);
+  }
+  free((*tstats)->adj_first);
+  if((*tstats)->adj != NULL) { free((*tstats)->adj); }
+  free((*tstats)->feats);
+  free((*tstats)->centr);
+
+  free(*tstats);
+  (*tstats) = NULL;
+}
+
+/*
+ * Accumulates the sums of every tree, and the adjacent spel pairs between
+ * them, from a full scan of the root map of the current IFT execution. Each
+ * thread scans a band of spels into its own partial sums and adjacent pair
+ * runs, which are merged afterwards in a fixed order.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  tsums[in/out] - REQUIRED: Empty tree sums to be modified
+ */
+void iftSICLE_InitTSums
+(iftSICLE *sicle, iftSICLE_IFTData *data, iftSICLE_TSums *tsums)
+{
+  int num_parts, num_slots, num_feats;
+  int **part_size, **part_edges, *part_num_edges;
+  long **part_centr;
+  double **part_sal, **part_feats;
+
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+  // A nested region (e.g., tiles segmented in parallel) has a single thread
+  num_parts = omp_in_parallel() ? 1 : omp_get_max_threads();
+  #else //--------------------------------------------------------------------|
+  num_parts = 1;
+  #endif //-------------------------------------------------------------------|
+  num_slots = tsums->num_slots; num_feats = tsums->num_feats;
+
+  part_size = calloc(num_parts, sizeof(int*));
+  assert(part_size != NULL);
+  part_sal = calloc(num_parts, sizeof(double*));
+  assert(part_sal != NULL);
+  part_feats = calloc(num_parts, sizeof(double*));
+  assert(part_feats != NULL);
+  part_centr = calloc(num_parts, sizeof(long*));
+  assert(part_centr != NULL);
+  part_edges = calloc(num_parts, sizeof(int*));
+  assert(part_edges != NULL);
+  part_num_edges = calloc(num_parts, sizeof(int));
+  assert(part_num_edges != NULL);
+
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+  #pragma omp parallel num_threads(num_parts)
+  #endif //-------------------------------------------------------------------|
+  {
+    int p_id, num_edges, max_edges, *size, *edges;
+    long *centr;
+    double *sal, *feats;
+
+    #ifdef IFT_OMP //---------------------------------------------------------|
+    // The team may be smaller than requested (e.g., dynamic adjustment)
+    #pragma omp single
+    num_parts = omp_get_num_threads();
+    p_id = omp_get_thread_num();
+    #else //------------------------------------------------------------------|
+    p_id = 0;
+    #endif //-----------------------------------------------------------------|
+
+    size = calloc(num_slots, sizeof(int));
+    assert(size != NULL);
+    feats = calloc(num_slots * num_feats, sizeof(double));
+    assert(feats != NULL);
+    centr = calloc(num_slots * 3, sizeof(long));
+    assert(centr != NULL);
+    if(tsums->sal == NULL) { sal = NULL; }
+    else { sal = calloc(num_slots, sizeof(double)); assert(sal != NULL); }
+
+    // Runs of adjacent spel pairs as (least slot, greatest slot, count)
+    num_edges = 0; max_edges = iftMax(num_slots * 8 / num_parts, 1);
+    edges = malloc(max_edges * 3 * sizeof(int));
+    assert(edges != NULL);
+
+    #ifdef IFT_OMP //---------------------------------------------------------|
+    #pragma omp for schedule(static)
+    #endif //-----------------------------------------------------------------|
+    for(int vi_index = 0; vi_index < sicle->mimg->n; ++vi_index)
+    {
+      if(iftSICLE_CostOf(data, vi_index) != IFTSICLE_BKGCOST && 
+         iftSICLE_RootOf(data, vi_index) != IFTSICLE_NIL)
+      {
+        int vi_slot;
+        bool vi_border;
+        iftVoxel vi_voxel;
+
+        vi_slot = tsums->slot[iftSICLE_RootOf(data, vi_index)];
+        vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
+        vi_border = iftBMapValue(data->border, vi_index);
+
+        size[vi_slot]++;
+        if(sal != NULL) { sal[vi_slot] += sicle->sal[vi_index]; }
+
+        centr[vi_slot*3 + 0] += vi_voxel.x;
+        centr[vi_slot*3 + 1] += vi_voxel.y;
+        centr[vi_slot*3 + 2] += vi_voxel.z;
+
+        for(int f = 0; f < num_feats; ++f) 
+        { feats[vi_slot*num_feats + f] += sicle->mimg->val[vi_index][f]; }
+
+        for(int j = 1; j < data->A->n; ++j)
+        {
+          int vj_index, vj_slot, min_slot, max_slot;
+
+          vj_index = iftSICLE_GetAdjIndex(sicle, data, vi_index, vi_border, j);
+
+          // Each pair is counted once, by its least spel
+          if(vj_index <= vi_index || iftSICLE_CostOf(data, vj_index) == IFTSICLE_BKGCOST ||
+             iftSICLE_RootOf(data, vj_index) == IFTSICLE_NIL) { continue; }
+
+          vj_slot = tsums->slot[iftSICLE_RootOf(data, vj_index)];
+          if(vj_slot == vi_slot) { continue; } // Same tree
+
+          min_slot = iftMin(vi_slot, vj_slot); max_slot = iftMax(vi_slot, vj_slot);
+          if(num_edges > 0 && edges[(num_edges - 1)*3 + 0] == min_slot &&
+             edges[(num_edges - 1)*3 + 1] == max_slot) // Continues the run?
+          { edges[(num_edges - 1)*3 + 2]++; }
+          else
+          {
+            if(num_edges == max_edges) // Full?
+            {
+              max_edges *= 2;
+              edges = realloc(edges, max_edges * 3 * sizeof(int));
+              assert(edges != NULL);
+            }
+            edges[num_edges*3 + 0] = min_slot; edges[num_edges*3 + 1] = max_slot;
+            edges[num_edges*3 + 2] = 1;
+            num_edges++;
+          }
+        }
+      }
+    }
+
+    part_size[p_id] = size; part_sal[p_id] = sal; part_feats[p_id] = feats;
+    part_centr[p_id] = centr; part_edges[p_id] = edges;
+    part_num_edges[p_id] = num_edges;
+  }
+
+  for(int p_id = 0; p_id < num_parts; ++p_id) // Merge in a fixed order
+  {
+    #ifdef IFT_OMP //---------------------------------------------------------|
+    #pragma omp parallel for
+    #endif //-----------------------------------------------------------------|
+    for(int slot = 0; slot < num_slots; ++slot)
+    {
+      tsums->size[slot] += part_size[p_id][slot];
+      if(tsums->sal != NULL) { tsums->sal[slot] += part_sal[p_id][slot]; }
+      for(int d = 0; d < 3; ++d) 
+      { tsums->centr[slot*3 + d] += part_centr[p_id][slot*3 + d]; }
+      for(int f = 0; f < num_feats; ++f)
+      { tsums->feats[slot*num_feats + f] += part_feats[p_id][slot*num_feats + f]; }
+    }
+
+    for(int e = 0; e < part_num_edges[p_id]; ++e)
+    {
+      iftSICLE_AddTSumsEdge(tsums, part_edges[p_id][e*3 + 0], 
+                            part_edges[p_id][e*3 + 1], part_edges[p_id][e*3 + 2]);
+    }
+
+    free(part_size[p_id]); free(part_feats[p_id]); free(part_centr[p_id]);
+    if(part_sal[p_id] != NULL) { free(part_sal[p_id]); }
+    free(part_edges[p_id]);
+  }
+  free(part_size); free(part_sal); free(part_feats); free(part_centr);
+  free(part_edges); free(part_num_edges);
+}
+
+/*
+ * Updates the tree sums by moving the contribution of every spel whose root
+ * changed since the last update, as well as of its adjacent spel pairs.
+ * Hence, its cost is proportional to the modified region.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  tsums[in/out] - REQUIRED: Tracked tree sums to be modified
+ */
+void iftSICLE_UpdateTSums
+(iftSICLE *sicle, iftSICLE_IFTData *data, iftSICLE_TSums *tsums)
+{
+  for(int i = 0; i < tsums->num_changed; ++i)
+  {
+    int vi_index, old_slot, new_slot;
+    bool vi_border;
+    iftVoxel vi_voxel;
+
+    vi_index = tsums->changed[i];
+    if(tsums->old_root[vi_index] == iftSICLE_RootOf(data, vi_index)) { continue; }
+
+    if(tsums->old_root[vi_index] == IFTSICLE_NIL) { old_slot = IFT_NIL; }
+    else { old_slot = tsums->slot[tsums->old_root[vi_index]]; }
+    if(iftSICLE_RootOf(data, vi_index) == IFTSICLE_NIL) { new_slot = IFT_NIL; }
+    else { new_slot = tsums->slot[iftSICLE_RootOf(data, vi_index)]; }
+
+    vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
+    vi_border = iftBMapValue(data->border, vi_index);
+
+    for(int k = 0; k < 2; ++k) // Remove from the old, and add to the new
+    {
+      int slot, sign;
+
+      slot = (k == 0) ? old_slot : new_slot; sign = (k == 0) ? -1 : 1;
+      if(slot == IFT_NIL) { continue; }
+
+      tsums->size[slot] += sign;
+      if(tsums->sal != NULL) { tsums->sal[slot] += sign * sicle->sal[vi_index]; }
+
+      tsums->centr[slot*3 + 0] += sign * vi_voxel.x;
+      tsums->centr[slot*3 + 1] += sign * vi_voxel.y;
+      tsums->centr[slot*3 + 2] += sign * vi_voxel.z;
+
+      for(int f = 0; f < tsums->num_feats; ++f) 
+      { 
+        tsums->feats[slot*tsums->num_feats + f] += 
+          sign * sicle->mimg->val[vi_index][f]; 
+      }
+    }
+
+    for(int j = 1; j < data->A->n; ++j)
+    {
+      int vj_index;
+
+      vj_index = iftSICLE_GetAdjIndex(sicle, data, vi_index, vi_border, j);
+
+      if(vj_index != IFT_NIL && iftSICLE_CostOf(data, vj_index) != IFTSICLE_BKGCOST)
+      {
+        int vj_old_root, vj_old_slot, vj_new_slot;
+        bool vj_changed;
+
+        if(iftBMapValue(tsums->touched, vj_index))
+        { vj_old_root = tsums->old_root[vj_index]; }
+        else { vj_old_root = iftSICLE_RootOf(data, vj_index); }
+        vj_changed = vj_old_root != iftSICLE_RootOf(data, vj_index);
+
+        // A pair of changed spels is updated once, by its least spel
+        if(vj_changed == false || vj_index > vi_index)
+        {
+          if(vj_old_root == IFTSICLE_NIL) { vj_old_slot = IFT_NIL; }
+          else { vj_old_slot = tsums->slot[vj_old_root]; }
+          if(iftSICLE_RootOf(data, vj_index) == IFTSICLE_NIL) { vj_new_slot = IFT_NIL; }
+          else { vj_new_slot = tsums->slot[iftSICLE_RootOf(data, vj_index)]; }
+
+          iftSICLE_AddTSumsEdge(tsums, old_slot, vj_old_slot, -1);
+          iftSICLE_AddTSumsEdge(tsums, new_slot, vj_new_slot, 1);
+        }
+      }
+    }
+  }
+
+  for(int i = 0; i < tsums->num_changed; ++i) // Clear the records
+  { iftBMapSet0(tsums->touched, tsums->changed[i]); }
+  tsums->num_changed = 0;
+}
+
+/*
+ * Groups the adjacency edges provided by their source tree, discarding the
+ * duplicates, and stores the result in the compressed sparse row (CSR) format
+ * of the tree statistics. Both steps are linear, through a counting sort and
+ * a per-tree marker. The edge arrays are consumed.
+ *
+ * PARAMETERS:
+ *  tstats[in/out] - REQUIRED: Tree statistics to be modified
+ *  edge_src[in/out] - REQUIRED: Source tree of each edge
+ *  edge_dst[in/out] - REQUIRED: Destination tree of each edge
+ *  num_edges[in] - REQUIRED: Number of edges
+ */
+void iftSICLE_CalcTreeAdj
+(iftSICLE_TStats *tstats, int **edge_src, int **edge_dst, int num_edges)
+{
+  int num_adjs, *mark;
+
+  tstats->adj = malloc(iftMax(num_edges, 1) * sizeof(int));
+  assert(tstats->adj != NULL);
+
+  for(int e = 0; e < num_edges; ++e) // Counting sort by the source tree
+  { tstats->adj_first[(*edge_src)[e] + 1]++; }
+  for(int t_index = 0; t_index < tstats->num_trees; ++t_index)
+  { tstats->adj_first[t_index + 1] += tstats->adj_first[t_index]; }
+  for(int e = 0; e < num_edges; ++e)
+  { tstats->adj[tstats->adj_first[(*edge_src)[e]]++] = (*edge_dst)[e]; }
+  for(int t_index = tstats->num_trees; t_index > 0; --t_index) // Undo shifting
+  { tstats->adj_first[t_index] = tstats->adj_first[t_index - 1]; }
+  tstats->adj_first[0] = 0;
+
+  free(*edge_src); (*edge_src) = NULL;
+  free(*edge_dst); (*edge_dst) = NULL;
+
+  mark = malloc(iftMax(tstats->num_trees, 1) * sizeof(int));
+  assert(mark != NULL);
+  for(int t_index = 0; t_index < tstats->num_trees; ++t_index)
+  { mark[t_index] = IFT_NIL; }
+
+  num_adjs = 0; // Compacts in-place, since it never overtakes the reading
+  for(int ti_index = 0; ti_index < tstats->num_trees; ++ti_index)
+  {
+    int first;
+
+    first = tstats->adj_first[ti_index];
+    tstats->adj_first[ti_index] = num_adjs;
+    for(int e = first; e < tstats->adj_first[ti_index + 1]; ++e)
+    {
+      int tj_index;
+
+      tj_index = tstats->adj[e];
+      if(mark[tj_index] != ti_index) // Not added yet?
+      { mark[tj_index] = ti_index; tstats->adj[num_adjs++] = tj_index; }
+    }
+  }
+  tstats->adj_first[tstats->num_trees] = num_adjs;
+  free(mark);
+
+  tstats->adj = realloc(tstats->adj, iftMax(num_adjs, 1) * sizeof(int));
+  assert(tstats->adj != NULL);
+}
+
+/*
+ * Calculates the tree statistics of the root map and seed array of the 
+ * current IFT execution
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *
+ * RETURNS: Extracted tree statistics of the current IFT execution
+ */
+iftSICLE_TStats *iftSICLE_CalcTStats
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data)
+{
+  int num_edges, *edge_src, *edge_dst, *label;
+  iftSICLE_TSums *tsums;
+  iftSICLE_TStats *tstats;
+
+  if(data->tsums != NULL && args->use_dift == true && 
+     data->tsums->touched == NULL) // Untracked sums are useless for the DIFT
+  { iftSICLE_DestroyTSums(&(data->tsums)); }
+  if(data->tsums == NULL) 
+  { data->tsums = iftSICLE_CreateTSums(sicle, args->use_dift); }
+  tsums = data->tsums;
+
+  if(args->use_dift == true && tsums->valid == true) // Kept across iterations?
+  { iftSICLE_UpdateTSums(sicle, data, tsums); }
+  else
+  {
+    iftSICLE_ClearTSums(sicle, data, tsums);
+    iftSICLE_InitTSums(sicle, data, tsums);
+    tsums->valid = args->use_dift; // Only the DIFT records the root changes
+  }
+
+  tstats = iftSICLE_CreateTStats(sicle, data);
+
+  label = malloc(tsums->num_slots * sizeof(int)); // Slots of removed trees: nil
+  assert(label != NULL);
+  for(int slot = 0; slot < tsums->num_slots; ++slot) { label[slot] = IFT_NIL; }
+
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+  for(int t_index = 0; t_index < tstats->num_trees; ++t_index) // Compute avg
+  {
+  	int slot;
+
+  	slot = tsums->slot[data->seeds->val[t_index]];
+  	label[slot] = t_index;
+
+  	tstats->size[t_index] = tsums->size[slot];
+  	for(int d = 0; d < tstats->num_dims; ++d) 
+    { tstats->centr[t_index][d] = tsums->centr[slot*3 + d]/(double)tsums->size[slot]; }
+
+    for(int j = 0; j < tstats->num_feats; ++j) 
+    { 
+    	tstats->feats[t_index][j] = 
+    		tsums->feats[slot*tsums->num_feats + j]/tsums->size[slot]; 
+    }
+
+    if(sicle->sal != NULL) // Has saliency?
+    { tstats->sal[t_index] = tsums->sal[slot]/tsums->size[slot]; }
+  }
+
+  num_edges = 0; // Both directions of each adjacent pair of trees
+  edge_src = malloc(iftMax(tsums->num_keys * 2, 1) * sizeof(int));
+  assert(edge_src != NULL);
+  edge_dst = malloc(iftMax(tsums->num_keys * 2, 1) * sizeof(int));
+  assert(edge_dst != NULL);
+  for(int e = 0; e < tsums->edge_cap; ++e)
+  {
+  	if(tsums->edge_count[e] > 0) // Still adjacent?
+  	{
+  		int ti_label, tj_label;
+
+  		ti_label = label[tsums->edge_key[e] / tsums->num_slots];
+  		tj_label = label[tsums->edge_key[e] % tsums->num_slots];
+  		edge_src[num_edges] = ti_label; edge_dst[num_edges++] = tj_label;
+  		edge_src[num_edges] = tj_label; edge_dst[num_edges++] = ti_label;
+  	}
+  }
+  free(label);
+
+  iftSICLE_CalcTreeAdj(tstats, &edge_src, &edge_dst, num_edges);
+
+  return tstats;
+}
+
+//============================================================================|
+// Image Foresting Transform
+//============================================================================|
+/*
+ * Computes the path-cost for conquering vj through the path ending at vi,
+ * whose root's features and saliency are provided. The connectivity function,
+ * the saliency usage and the Fsum's adherence are expected as constants, so
+ * that each instantiation of the caller is specialized by the compiler.
+ *
+ * PARAMETERS:
+ *  connopt[in] - REQUIRED: IFT connectivity function
+ *  has_sal[in] - REQUIRED: Whether the saliency boosts the arc-costs
+ *  adhr[in] - REQUIRED: Fsum's boundary adherence. If < 0, uses args->adhr
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  root_feat_dist[in] - REQUIRED: Feature distance between vi's root and vj
+ *  root_sal[in] - REQUIRED: Saliency of vi's root. Ignored if has_sal is false
+ *  vi_cost[in] - REQUIRED: Path-cost of vi
+ *  vj_index[in] - REQUIRED: Vertex to be conquered
+ *  adj[in] - REQUIRED: Index of vj within the adjacency of vi
+ *
+ * RETURNS: Path-cost of vj through vi
+ */
+static inline __attribute__((always_inline)) float iftSICLE_ConnFunction
+(const iftSICLEConn connopt, const bool has_sal, const int adhr,
+	iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data,
+	double root_feat_dist, float root_sal, double vi_cost, int vj_index,
+	int adj)
+{
+	double sal_dist, arccost, pathcost;
+
+	if(has_sal == true) { sal_dist = fabs(root_sal - sicle->sal[vj_index]); }
+	else { sal_dist = 0.0; }
+
+	pathcost = vi_cost;
+	if(connopt == IFT_SICLE_CONN_FMAX) // fmax + wroot
+	{
+		if(has_sal == true)
+		{ arccost = pow(root_feat_dist, 1.0 + args->alpha*sal_dist); }
+		else { arccost = root_feat_dist; } // Unitary exponent
+		pathcost = iftMax(pathcost, arccost);
+	}
+	else if(connopt == IFT_SICLE_CONN_FSUM) // fsum + wsum
+	{
+		if(has_sal == true)
+		{ arccost = (args->irreg + args->alpha*sal_dist) * root_feat_dist; }
+		else { arccost = args->irreg * root_feat_dist; }
+		arccost = iftFastNatPow(arccost, (adhr < 0) ? args->adhr : adhr);
+		pathcost += arccost + data->adj_dist[adj];
+	}
+	else // IFT_SICLE_CONN_CUSTOM
+	{
+		/*
+			You may write here your own connectivity function for testing possible
+			new functionalities for SICLE. For using that, add "--conn-opt custom"
+			in the command-line
+		*/
+		pathcost += 1;
+	}
+
+	return pathcost;
+}
+
+/*
+ * Offers the path ending at vi to each of its adjacents within the domain
+ * provided, conquering those with lesser path-costs. In the differential
+ * IFT, it also removes the inconsistent subtrees of vi for a new competition.
+ * The parameters preceding sicle are expected as constants, since they
+ * define the kernel's specialization (see IFTSICLE_DEF_CONQUER).
+ *
+ * PARAMETERS:
+ *  connopt[in] - REQUIRED: IFT connectivity function
+ *  has_sal[in] - REQUIRED: Whether the saliency boosts the arc-costs
+ *  adhr[in] - REQUIRED: Fsum's boundary adherence. If < 0, uses args->adhr
+ *  num_adj[in] - REQUIRED: Adjacency relation's size
+ *  is_dift[in] - REQUIRED: Whether it is a differential IFT
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  queue[in/out] - REQUIRED: Priority queue of the current IFT execution
+ *  vi_index[in] - REQUIRED: Vertex removed from the queue
+ *  vi_inner[in] - REQUIRED: Whether all adjacents of vi are within the domain
+ *  dom[in] - REQUIRED: Domain of the current IFT execution
+ */
+static inline __attribute__((always_inline)) void iftSICLE_ConquerAdjs
+(const iftSICLEConn connopt, const bool has_sal, const int adhr,
+	const int num_adj, const bool is_dift, iftSICLE *sicle, iftSICLEArgs *args,
+	iftSICLE_IFTData **data, iftSICLE_PQueue *queue, int vi_index,
+	bool vi_inner, iftBoundingBox dom)
+{
+	int vi_root;
+	float root_sal, *root_feats;
+	double vi_cost;
+	iftVoxel vi_voxel;
+	#if defined(IFT_SIMD) && defined(__SSE2__) //-------------------------------|
+	float dists[28]; // Feature distance to the j-th adjacent at j - 1
+	#endif //-------------------------------------------------------------------|
+
+	vi_root = iftSICLE_RootOf(*data, vi_index);
+	vi_cost = iftSICLE_CostOf(*data, vi_index);
+	root_feats = sicle->mimg->val[vi_root]; // Constant throughout the adjacency
+	if(has_sal == true) { root_sal = sicle->sal[vi_root]; }
+	else { root_sal = 0.0; }
+
+	if(vi_inner == false) { vi_voxel = iftMGetVoxelCoord(sicle->mimg, vi_index); }
+	else { vi_voxel.x = vi_voxel.y = vi_voxel.z = 0; } // Unused
+
+	#if defined(IFT_SIMD) && defined(__SSE2__) //-------------------------------|
+	if(vi_inner == true && sicle->feats != NULL) // Batch the whole adjacency
+	{
+		const float *feats;
+
+		feats = sicle->feats;
+		for(int j = 1; j < num_adj; j += 4)
+		{
+			int vj_index[4];
+
+			for(int k = 0; k < 4; ++k) // Out-of-range lanes repeat vi itself
+			{
+				if(j + k < num_adj) { vj_index[k] = vi_index + (*data)->adj_off[j + k]; }
+				else { vj_index[k] = vi_index; }
+			}
+
+			_mm_storeu_ps(&(dists[j - 1]),
+										iftEuclDistance4x4(&(feats[vi_root*4]),
+																			 &(feats[vj_index[0]*4]),
+																			 &(feats[vj_index[1]*4]),
+																			 &(feats[vj_index[2]*4]),
+																			 &(feats[vj_index[3]*4])));
+		}
+	}
+	#endif //-------------------------------------------------------------------|
+
+	for(int j = 1; j < num_adj; ++j)
+	{
+		int vj_index;
+
+		if(vi_inner == true) { vj_index = vi_index + (*data)->adj_off[j]; }
+		else
+		{
+			iftVoxel vj_voxel;
+
+			vj_voxel = iftGetAdjacentVoxel((*data)->A, vi_voxel, j);
+			if(vj_voxel.x >= dom.begin.x && vj_voxel.x <= dom.end.x &&
+				 vj_voxel.y >= dom.begin.y && vj_voxel.y <= dom.end.y &&
+				 vj_voxel.z >= dom.begin.z && vj_voxel.z <= dom.end.z) // In domain?
+			{ vj_index = iftMGetVoxelIndex(sicle->mimg, vj_voxel); }
+			else { vj_index = IFT_NIL; }
+		}
+
+		if(vj_index != IFT_NIL && !iftSICLE_LeftPQueue(queue, vj_index))
+		{
+			double root_feat_dist;
+			iftSICLE_Cost pathcost;
+
+			#if defined(IFT_SIMD) && defined(__SSE2__) //---------------------------|
+			if(vi_inner == true && sicle->feats != NULL)
+			{ root_feat_dist = dists[j - 1]; }
+			else
+			#endif //---------------------------------------------------------------|
+			{
+				root_feat_dist = iftEuclDistance(root_feats, sicle->mimg->val[vj_index],
+																				 sicle->mimg->m);
+			}
+
+			pathcost = iftSICLE_ConnFunction(connopt, has_sal, adhr, sicle, args,
+																			 *data, root_feat_dist, root_sal,
+																			 vi_cost, vj_index, j);
+
+			if(pathcost < iftSICLE_CostOf(*data, vj_index)) // Lesser path-cost?
+			{
+				if(iftSICLE_InPQueue(queue, vj_index)) // Already within the queue?
+				{ iftSICLE_RemovePQueueElem(queue, vj_index); } // Remove for update
+
+				if(is_dift == true) // Might change its tree
+				{ iftSICLE_TrackRootChange((*data)->tsums, vj_index, iftSICLE_RootOf(*data, vj_index)); }
+				iftSICLE_RootOf(*data, vj_index) = vi_root; //
+				iftSICLE_PredOf(*data, vj_index) = vi_index;// Mark as conquered
+				iftSICLE_CostOf(*data, vj_index) = pathcost;//
+				iftSICLE_InsertPQueue(queue, vj_index);
+			}
+			else if(is_dift == true && vi_index == iftSICLE_PredOf(*data, vj_index))
+			{
+				if(pathcost > iftSICLE_CostOf(*data, vj_index) ||
+					 vi_root != iftSICLE_RootOf(*data, vj_index))
+					//Inconsistency -> Remove and Compete again
+				{ iftSICLE_RemoveSubtree(sicle, vj_index, data, queue);}
+			}
+		}
+	}
+}
+
+typedef void (*iftSICLE_ConquerFunc)
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data,
+	iftSICLE_PQueue *queue, int vi_index, bool vi_inner, iftBoundingBox dom);
+
+// Instantiates iftSICLE_ConquerAdjs for a (connectivity, saliency usage,
+// adjacency size, differential) combination, with K naming the connectivity
+#define IFTSICLE_DEF_CONQUER(K, CONN, ADHR, SAL, NADJ, DIFT) \
+	static void iftSICLE_Conquer_##K##_##SAL##_##NADJ##_##DIFT \
+	(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data, \
+		iftSICLE_PQueue *queue, int vi_index, bool vi_inner, iftBoundingBox dom) \
+	{ \
+		iftSICLE_ConquerAdjs(CONN, SAL, ADHR, NADJ, DIFT, sicle, args, data, \
+												 queue, vi_index, vi_inner, dom); \
+	}
+#define IFTSICLE_DEF_CONQUER_DIFT(K, CONN, ADHR, SAL, NADJ) \
+	IFTSICLE_DEF_CONQUER(K, CONN, ADHR, SAL, NADJ, 0) \
+	IFTSICLE_DEF_CONQUER(K, CONN, ADHR, SAL, NADJ, 1)
+#define IFTSICLE_DEF_CONQUER_NADJ(K, CONN, ADHR, SAL) \
+	IFTSICLE_DEF_CONQUER_DIFT(K, CONN, ADHR, SAL, 5) /* 4-neighborhood */ \
+	IFTSICLE_DEF_CONQUER_DIFT(K, CONN, ADHR, SAL, 9) /* 8-neighborhood */ \
+	IFTSICLE_DEF_CONQUER_DIFT(K, CONN, ADHR, SAL, 7) /* 6-neighborhood */ \
+	IFTSICLE_DEF_CONQUER_DIFT(K, CONN, ADHR, SAL, 27) /* 26-neighborhood */
+#define IFTSICLE_DEF_CONQUER_SAL(K, CONN, ADHR) \
+	IFTSICLE_DEF_CONQUER_NADJ(K, CONN, ADHR, 0) \
+	IFTSICLE_DEF_CONQUER_NADJ(K, CONN, ADHR, 1)
+
+IFTSICLE_DEF_CONQUER_SAL(FMAX, IFT_SICLE_CONN_FMAX, -1)
+IFTSICLE_DEF_CONQUER_SAL(FSUM, IFT_SICLE_CONN_FSUM, -1)
+IFTSICLE_DEF_CONQUER_SAL(FSUM12, IFT_SICLE_CONN_FSUM, 12) // Default adherence
+IFTSICLE_DEF_CONQUER_SAL(CUSTOM, IFT_SICLE_CONN_CUSTOM, -1)
+
+#define IFTSICLE_CONQUER_ROW_NADJ(K, SAL, NADJ) \
+	{ iftSICLE_Conquer_##K##_##SAL##_##NADJ##_0, \
+		iftSICLE_Conquer_##K##_##SAL##_##NADJ##_1 }
+#define IFTSICLE_CONQUER_ROW_SAL(K, SAL) \
+	{ IFTSICLE_CONQUER_ROW_NADJ(K, SAL, 5), IFTSICLE_CONQUER_ROW_NADJ(K, SAL, 9), \
+		IFTSICLE_CONQUER_ROW_NADJ(K, SAL, 7), IFTSICLE_CONQUER_ROW_NADJ(K, SAL, 27) }
+#define IFTSICLE_CONQUER_ROW(K) \
+	{ IFTSICLE_CONQUER_ROW_SAL(K, 0), IFTSICLE_CONQUER_ROW_SAL(K, 1) }
+
+// Indexed by [connectivity][saliency usage][adjacency size][differential]
+static const iftSICLE_ConquerFunc IFTSICLE_CONQUER_FUNCS[4][2][4][2] = {
+	IFTSICLE_CONQUER_ROW(FMAX), IFTSICLE_CONQUER_ROW(FSUM),
+	IFTSICLE_CONQUER_ROW(FSUM12), IFTSICLE_CONQUER_ROW(CUSTOM)
+};
+
+/*
+ * Selects the conquering kernel specialized for the SICLE arguments and the
+ * IFT data provided, such that no option is verified during the conquest.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  is_dift[in] - REQUIRED: Whether it is a differential IFT
+ *
+ * RETURNS: Specialized conquering kernel
+ */
+iftSICLE_ConquerFunc iftSICLE_SelectConquerFunc
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data, bool is_dift)
+{
+	int conn_id, sal_id, adj_id;
+
+	if(args->connopt == IFT_SICLE_CONN_FMAX) { conn_id = 0; }
+	else if(args->connopt == IFT_SICLE_CONN_FSUM)
+	{ conn_id = (args->adhr == 12) ? 2 : 1; }
+	else if(args->connopt == IFT_SICLE_CONN_CUSTOM) { conn_id = 3; }
+	else { iftError("Unknown connectivity function", __func__); return NULL; }
+
+	// A null boosting makes the saliency irrelevant to the arc-cost
+	sal_id = (sicle->sal != NULL && args->alpha != 0.0) ? 1 : 0;
+
+	switch(data->A->n)
+	{
+		case 5: adj_id = 0; break;
+		case 9: adj_id = 1; break;
+		case 7: adj_id = 2; break;
+		case 27: adj_id = 3; break;
+		default: iftError("Unknown adjacency relation", __func__); return NULL;
+	}
+
+	return IFTSICLE_CONQUER_FUNCS[conn_id][sal_id][adj_id][is_dift ? 1 : 0];
+}
+
+/*
+ * Gets the image domain as a bounding box
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *
+ * RETURNS: Bounding box of the whole image
+ */
+static inline iftBoundingBox iftSICLE_GetImageDomain
+(iftSICLE *sicle)
+{
+	iftBoundingBox dom;
+
+	dom.begin.x = dom.begin.y = dom.begin.z = 0;
+	dom.end.x = sicle->mimg->xsize - 1;
+	dom.end.y = sicle->mimg->ysize - 1;
+	dom.end.z = sicle->mimg->zsize - 1;
+
+	return dom;
+}
+
+/*
+ * Propagates the differential IFT from the spels within the queue provided,
+ * conquering those with lesser path-costs and removing the inconsistent
+ * subtrees for a new competition. The IFT data is modified in-place.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  queue[in/out] - REQUIRED: Priority queue containing the initial spels
+ *  bb[in/out] - OPTIONAL: Bounding box expanded by the spels removed from 
+ *                         the queue (i.e., those whose trees may have changed)
+ */
+void iftSICLE_PropagateDIFT
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data,
+	iftSICLE_PQueue *queue, iftBoundingBox *bb)
+{
+	iftBoundingBox dom;
+	iftSICLE_ConquerFunc conquer;
+
+	dom = iftSICLE_GetImageDomain(sicle);
+	conquer = iftSICLE_SelectConquerFunc(sicle, args, *data, true);
+
+	while(iftSICLE_EmptyPQueue(queue) == false)
+	{
+		int vi_index;
+
+		vi_index = iftSICLE_RemovePQueue(queue);
+		iftSICLE_ExpandBox(sicle, vi_index, bb);
+		conquer(sicle, args, data, queue, vi_index,
+						!iftBMapValue((*data)->border, vi_index), dom);
+	}
+}
+
+/*
+ * Executes one sequential IFT restricted to the tile's domain, considering
+ * only the seeds within it. Since the tiles are disjoint, they may be
+ * computed in parallel over the same IFT data.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  tile[in] - REQUIRED: Tile's domain
+ *  tile_seeds[in] - REQUIRED: Seeds within the tile
+ *  num_seeds[in] - REQUIRED: Number of seeds within the tile
+ *  color[in/out] - REQUIRED: Heap status map shared among the tiles. Unused
+ *                            by the compact build
+ *  pos[in/out] - REQUIRED: Heap position map shared among the tiles. Unused
+ *                          by the compact build
+ */
+void iftSICLE_RunTileIFT
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data,
+	iftBoundingBox tile, int *tile_seeds, int num_seeds, char *color, int *pos)
+{
+	int rad, tile_n;
+	iftSICLE_PQueue queue;
+	iftSICLE_ConquerFunc conquer;
+	#ifndef IFT_COMPACT //------------------------------------------------------|
+	iftDHeap heap;
+	#endif //-------------------------------------------------------------------|
+
+	tile_n = (tile.end.x - tile.begin.x + 1) * (tile.end.y - tile.begin.y + 1) *
+					 (tile.end.z - tile.begin.z + 1);
+
+	// The tile's heap only owns its node array, since its spels are disjoint
+	#ifdef IFT_COMPACT //-------------------------------------------------------|
+	queue.node = (*data)->node;
+	queue.n = tile_n;
+	queue.last = -1;
+	queue.is_mapped = false; // At most a tile
+	queue.heap = malloc(tile_n * sizeof(int));
+	assert(queue.heap != NULL);
+	#else //--------------------------------------------------------------------|
+	heap.n = tile_n;
+	heap.value = (*data)->cost_map;
+	heap.color = color;
+	heap.pos = pos;
+	heap.node = malloc(heap.n * sizeof(int));
+	assert(heap.node != NULL);
+	heap.last = -1;
+	heap.removal_policy = MINVALUE;
+
+	queue.heap = &heap; queue.bqueue = NULL; queue.color = color;
+	#endif //-------------------------------------------------------------------|
+	conquer = iftSICLE_SelectConquerFunc(sicle, args, *data, false);
+	rad = (*data)->adj_rad;
+
+	for(int i = 0; i < num_seeds; ++i) 
+	{ iftSICLE_InsertPQueue(&queue, tile_seeds[i]); }
+
+	while(!iftSICLE_EmptyPQueue(&queue))
+	{
+		int vi_index;
+		bool vi_inner;
+		iftVoxel vi_voxel;
+
+		vi_index = iftSICLE_RemovePQueue(&queue);
+		vi_voxel = iftMGetVoxelCoord(sicle->mimg,vi_index);
+
+		// Whether all adjacents are within the tile
+		vi_inner = vi_voxel.x - rad >= tile.begin.x && vi_voxel.x + rad <= tile.end.x &&
+							 vi_voxel.y - rad >= tile.begin.y && vi_voxel.y + rad <= tile.end.y &&
+							 vi_voxel.z - rad >= tile.begin.z && vi_voxel.z + rad <= tile.end.z;
+
+		conquer(sicle, args, data, &queue, vi_index, vi_inner, tile);
+	}
+	#ifdef IFT_COMPACT //-------------------------------------------------------|
+	free(queue.heap);
+	#else //--------------------------------------------------------------------|
+	free(heap.node);
+	#endif //-------------------------------------------------------------------|
+}
+
+/*
+ * Executes one sequential IFT by partitioning the image into tiles (i.e., 
+ * cubic blocks in volumes, ordered slab by slab along the z-axis), which are
+ * conquered independently (and in parallel) from their inner seeds. Then,
+ * the spels at the tiles' borders reconcile the forests through a
+ * differential IFT, which conquers through the borders and removes every
+ * inconsistent subtree. The result is a consistent spanning forest, which is
+ * equivalent to the sequential IFT's up to the processing order of the spels.
+ * The IFT data provided is modified and updated in-place.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ */
+void iftSICLE_RunTiledSeedIFT
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data)
+{
+	int num_xtiles, num_ytiles, num_ztiles, num_tiles, tile_size;
+	int *first_seed, *tile_seeds, *tile_of_seed, *pos;
+	char *color;
+	iftSICLE_PQueue *queue;
+
+	tile_size = args->tile_size;
+	num_xtiles = ceil(sicle->mimg->xsize / (float)tile_size);
+	num_ytiles = ceil(sicle->mimg->ysize / (float)tile_size);
+	num_ztiles = ceil(sicle->mimg->zsize / (float)tile_size);
+	num_tiles = num_xtiles * num_ytiles * num_ztiles;
+
+	iftSICLE_ResetIFTData(sicle, data); // Prepare data for the sequential IFT
+
+	// Group the seeds by tile (counting sort)
+	first_seed = calloc(num_tiles + 1, sizeof(int));
+	assert(first_seed != NULL);
+	tile_seeds = calloc((*data)->seeds->n, sizeof(int));
+	assert(tile_seeds != NULL);
+	tile_of_seed = calloc((*data)->seeds->n, sizeof(int));
+	assert(tile_of_seed != NULL);
+
+	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id)
+	{
+		iftVoxel s_voxel;
+
+		s_voxel = iftMGetVoxelCoord(sicle->mimg, (*data)->seeds->val[s_id]);
+		tile_of_seed[s_id] = (s_voxel.x / tile_size) +
+												 (s_voxel.y / tile_size) * num_xtiles +
+												 (s_voxel.z / tile_size) * num_xtiles * num_ytiles;
+		first_seed[tile_of_seed[s_id] + 1]++;
+	}
+	for(int t_index = 0; t_index < num_tiles; ++t_index)
+	{ first_seed[t_index + 1] += first_seed[t_index]; }
+	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id)
+	{ tile_seeds[first_seed[tile_of_seed[s_id]]++] = (*data)->seeds->val[s_id]; }
+	for(int t_index = num_tiles; t_index > 0; --t_index) // Undo the shifting
+	{ first_seed[t_index] = first_seed[t_index - 1]; }
+	first_seed[0] = 0;
+	free(tile_of_seed);
+
+	#ifdef IFT_COMPACT //-------------------------------------------------------|
+	color = NULL; pos = NULL; // Kept within the spels' records
+	#else //--------------------------------------------------------------------|
+	color = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(char)); // WHITE
+	pos = iftSICLE_AllocMap(sicle, sicle->mimg->n * sizeof(int));
+	#endif //-------------------------------------------------------------------|
+
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for schedule(dynamic)
+	#endif //-------------------------------------------------------------------|
+	for(int t_index = 0; t_index < num_tiles; ++t_index)
+	{
+		iftBoundingBox tile;
+
+		tile.begin.x = (t_index % num_xtiles) * tile_size;
+		tile.begin.y = ((t_index / num_xtiles) % num_ytiles) * tile_size;
+		tile.begin.z = (t_index / (num_xtiles * num_ytiles)) * tile_size;
+		tile.end.x = iftMin(tile.begin.x + tile_size, sicle->mimg->xsize) - 1;
+		tile.end.y = iftMin(tile.begin.y + tile_size, sicle->mimg->ysize) - 1;
+		tile.end.z = iftMin(tile.begin.z + tile_size, sicle->mimg->zsize) - 1;
+
+		iftSICLE_RunTileIFT(sicle, args, data, tile,
+												&(tile_seeds[first_seed[t_index]]),
+												first_seed[t_index + 1] - first_seed[t_index],
+												color, pos);
+	}
+	if(color != NULL) 
+	{ 
+		iftSICLE_FreeMap((*data)->is_mapped, color, sicle->mimg->n * sizeof(char));
+		iftSICLE_FreeMap((*data)->is_mapped, pos, sicle->mimg->n * sizeof(int));
+	}
+	free(first_seed); free(tile_seeds);
+
+	// Reconcile the forests from the tiles' borders
+	queue = (*data)->queue;
+	iftSICLE_ResetPQueue(queue);
+	for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+	{
+		if(iftSICLE_CostOf(*data, v_index) != IFTSICLE_BKGCOST &&
+			 iftSICLE_CostOf(*data, v_index) != IFTSICLE_TMPCOST) // Was conquered?
+		{
+			int x_off, y_off, z_off;
+			iftVoxel v_voxel;
+
+			v_voxel = iftMGetVoxelCoord(sicle->mimg, v_index);
+			x_off = v_voxel.x % tile_size; y_off = v_voxel.y % tile_size;
+			z_off = v_voxel.z % tile_size;
+			if(x_off == 0 || x_off == tile_size - 1 ||
+				 y_off == 0 || y_off == tile_size - 1 ||
+				 (num_ztiles > 1 && 
+				 	(z_off == 0 || z_off == tile_size - 1))) // At the tile's border?
+			{ iftSICLE_InsertPQueue(queue, v_index); }
+		}
+	}
+
+	iftSICLE_PropagateDIFT(sicle, args, data, queue, NULL);
+}
+
+/*
+ * Executes one sequential IFT with the seeds defined in the IFT data provided,
+ * which is modified and updated in-place
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ */
+void iftSICLE_RunSeedIFT
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data)
+{
+	iftBoundingBox dom;
+	iftSICLE_PQueue *queue;
+	iftSICLE_ConquerFunc conquer;
+
+	if(args->tile_size > 0) // Partitioned?
+	{ iftSICLE_RunTiledSeedIFT(sicle, args, data); return; }
+
+	queue = (*data)->queue;
+	iftSICLE_ResetPQueue(queue);
+	dom = iftSICLE_GetImageDomain(sicle);
+	conquer = iftSICLE_SelectConquerFunc(sicle, args, *data, false);
+
+	iftSICLE_ResetIFTData(sicle, data); // Prepare data for the sequential IFT
+	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id) 
+	{ iftSICLE_InsertPQueue(queue, (*data)->seeds->val[s_id]); } // Add seeds
+
+	while(!iftSICLE_EmptyPQueue(queue))
+	{
+		int vi_index;
+
+		vi_index = iftSICLE_RemovePQueue(queue);
+		conquer(sicle, args, data, queue, vi_index,
+						!iftBMapValue((*data)->border, vi_index), dom);
+	}
+}
+
+/*
+ * Executes one differential IFT with the seeds defined in the IFT data 
+ * provided, which is modified and updated in-place
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  irre_seeds[in/out] - REQUIRED: Irrelevant seeds to be removed
+ */
+void iftSICLE_RunSeedDIFT
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData **data, 
+	iftIntArray **irre_seeds)
+{
+	int num_front;
+	iftSICLE_PQueue *queue;
+
+	num_front = iftSICLE_RemoveTrees(sicle, data, irre_seeds, NULL);//Remove irrelevants
+	queue = (*data)->queue;
+	iftSICLE_ResetPQueue(queue);
+
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id) // Update labels
+	{ iftSICLE_PredOf(*data, (*data)->seeds->val[s_id]) = -(s_id + 1); } // 2's compl
+
+	while(num_front > 0)
+	{ iftSICLE_InsertPQueue(queue, (*data)->front_stack[--num_front]); }
+
+	iftSICLE_PropagateDIFT(sicle, args, data, queue, NULL);
+}
+
+//============================================================================|
+// Seed Removal
+//============================================================================|
+/*
+ * Calculate the priority/relevance of the seeds based on the predefined 
+ * criterion and penalization. 
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *
+ * RETURNS: Double |S|-sized array of seeds' priority/relevance
+ */
+double *iftSICLE_CalcSeedPrio
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data)
+{
+  double *prio;
+  iftSICLE_TStats *tstats;
+
+  prio = calloc(data->seeds->n, sizeof(double));
+  tstats = iftSICLE_CalcTStats(sicle, args, data);
+	
+  #ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+  for(long ti_index = 0; ti_index < tstats->num_trees; ++ti_index)
+  {
+    double size_perc, min_color_grad, max_sal_grad, min_dist, num_adjs,
+    			 max_color_grad, dist_perc;
+
+    size_perc = tstats->size[ti_index]/(float)sicle->mimg->n; 
+
+    max_sal_grad = max_color_grad = 0.0;
+    min_color_grad = min_dist = IFT_INFINITY_DBL;
+    num_adjs = 0;
+  	for(int e = tstats->adj_first[ti_index]; 
+  			e < tstats->adj_first[ti_index + 1]; ++e)
+    {
+    	int tj_index;
+    	double sal_grad, grad, dist;
+
+    	tj_index = tstats->adj[e];
+     	num_adjs++; 
+      grad= iftEuclDistance(tstats->feats[ti_index], tstats->feats[tj_index],
+                             tstats->num_feats);
+      dist= iftEuclDistance(tstats->centr[ti_index], tstats->centr[tj_index],
+      											 tstats->num_dims);
+
+      if(grad < min_color_grad) { min_color_grad = grad; }
+      if(grad > max_color_grad) { max_color_grad = grad; }
+      if(dist < min_dist) { min_dist = dist; }
+
+      if(sicle->sal != NULL) // Has saliency?
+      { 
+      	sal_grad = fabs(tstats->sal[ti_index] - tstats->sal[tj_index]); 
+      	if(sal_grad > max_sal_grad) { max_sal_grad = sal_grad; }
+      }
+    }
+	dist_perc = min_dist/iftDiagonalSize(sicle->mimg);
+
+		if(args->critopt == IFT_SICLE_CRIT_SIZE)
+    { prio[ti_index] = size_perc; }
+    else if(args->critopt == IFT_SICLE_CRIT_MINSC)
+    { prio[ti_index] = size_perc * min_color_grad; }
+    else if(args->critopt == IFT_SICLE_CRIT_MAXSC)
+    { prio[ti_index] = size_perc * max_color_grad; }
+  	else if(args->critopt == IFT_SICLE_CRIT_SPREAD)
+    { prio[ti_index] = size_perc * min_dist; }
+		else if(args->critopt == IFT_SICLE_CRIT_CUSTOM)
+    {
+    	/* 
+				You may write here your own criterion function for testing possible
+				new functionalities for SICLE. For using that, add "--crit-opt custom"
+				in the command-line
+			*/
+    	prio[ti_index] = size_perc*1.0/min_dist;
+    }
+    else 
+    { iftError("Unknown seed removal criterion fuction", __func__); }
+
+    if(args->penopt == IFT_SICLE_PEN_OBJ)
+  	{ prio[ti_index]*= iftMax(tstats->sal[ti_index], max_sal_grad); }
+  	else if(args->penopt == IFT_SICLE_PEN_BORD)
+  	{ prio[ti_index]*= max_sal_grad; }
+  	else if(args->penopt == IFT_SICLE_PEN_OSB)
+  	{
+  	  float bkg_relevance;
+
+  	  bkg_relevance = (1.0 - tstats->sal[ti_index])*dist_perc;
+  	  prio[ti_index]*= iftMax(tstats->sal[ti_index],bkg_relevance);
+  	}
+  	else if(args->penopt == IFT_SICLE_PEN_BOBS)
+  	{
+  	  float bkg_relevance, obj_relevance;
+			
+			obj_relevance = tstats->sal[ti_index]*max_sal_grad;
+  	  bkg_relevance = (1.0 - tstats->sal[ti_index])*dist_perc;
+  	  prio[ti_index]*= iftMax(obj_relevance,bkg_relevance);
+  	}
+  	else if(args->penopt == IFT_SICLE_PEN_CUSTOM)
+  	{
+    	/* 
+				You may write here your own penalization function for testing possible
+				new functionalities for SICLE. For using that, add "--pen-opt custom"
+				in the command-line
+			*/
+  	  prio[ti_index]*= 1;
+  	}
+  	else if(args->penopt != IFT_SICLE_PEN_NONE)
+		{ iftError("Unknown seed relevance penalization", __func__); }
+  }
+  iftSICLE_DestroyTStats(&tstats);
+
+  return prio;
+}
+
+/*
+ * Checks whether the seed a precedes the seed b in relevance. Ties are broken
+ * by the seed's id, for a strict ordering.
+ *
+ * PARAMETERS:
+ *  prio[in] - REQUIRED: Seed relevance
+ *  a[in] - REQUIRED: Seed's id
+ *  b[in] - REQUIRED: Seed's id
+ *
+ * RETURNS: Whether a precedes b
+ */
+static inline bool iftSICLE_PrecedesSeed
+(const double *prio, int a, int b)
+{ return prio[a] > prio[b] || (prio[a] == prio[b] && a < b); }
+
+/*
+ * Partitions the seeds' ids provided such that the first k ones are the most
+ * relevant, in no particular order. It is a quickselect with a median-of-3
+ * pivot, whose expected time is linear.
+ *
+ * PARAMETERS:
+ *  prio[in] - REQUIRED: Seed relevance
+ *  rank[in/out] - REQUIRED: Seeds' ids to be partitioned
+ *  n[in] - REQUIRED: Number of seeds
+ *  k[in] - REQUIRED: Number of relevant seeds
+ */
+void iftSICLE_SelectSeeds
+(const double *prio, int *rank, int n, int k)
+{
+  int lo, hi;
+
+  lo = 0; hi = n - 1;
+  while(k > 0 && k < n && lo < hi)
+  {
+    int mid, pivot, store, tmp;
+
+    mid = lo + (hi - lo)/2; // Moves the median of lo, mid and hi to hi
+    if(iftSICLE_PrecedesSeed(prio, rank[mid], rank[lo]))
+    { tmp = rank[mid]; rank[mid] = rank[lo]; rank[lo] = tmp; }
+    if(iftSICLE_PrecedesSeed(prio, rank[hi], rank[lo]))
+    { tmp = rank[hi]; rank[hi] = rank[lo]; rank[lo] = tmp; }
+    if(iftSICLE_PrecedesSeed(prio, rank[mid], rank[hi]))
+    { tmp = rank[mid]; rank[mid] = rank[hi]; rank[hi] = tmp; }
+
+    pivot = rank[hi]; store = lo;
+    for(int i = lo; i < hi; ++i)
+    {
+      if(iftSICLE_PrecedesSeed(prio, rank[i], pivot))
+      { tmp = rank[i]; rank[i] = rank[store]; rank[store] = tmp; store++; }
+    }
+    rank[hi] = rank[store]; rank[store] = pivot;
+
+    if(store < k) { lo = store + 1; }
+    else if(store > k) { hi = store - 1; }
+    else { break; } // The first k precede the pivot
+  }
+}
+
+/*
+ * Removes Ni irrelevant seeds for the next IFT execution. The maintained
+ * seeds keep their relative order, and the pinned ones (if any) precede every
+ * other seed in relevance.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  num_maint[in] - REQUIRED: Number of seeds to be maintained
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  irre_seeds[out] - REQUIRED: Irrelevant seeds selected to be removed. If it
+ *                              was not consumed yet, it is free'd
+ */
+void iftSICLE_RemSeeds
+(iftSICLE *sicle, int num_maint, iftSICLEArgs *args, iftSICLE_IFTData **data,
+ iftIntArray **irre_seeds)
+{
+  int *rank, num_irre;
+  char *maint;
+  double *prio;
+  iftIntArray *new_seeds;
+
+  prio = iftSICLE_CalcSeedPrio(sicle, args, (*data));
+  if(sicle->pinned != NULL)
+  {
+    for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id)
+    { 
+      if(iftBMapValue(sicle->pinned, (*data)->seeds->val[s_id])) 
+      { prio[s_id] = IFT_INFINITY_DBL; }
+    }
+  }
+
+  rank = malloc((*data)->seeds->n * sizeof(int));
+  assert(rank != NULL);
+  for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id) { rank[s_id] = s_id; }
+  iftSICLE_SelectSeeds(prio, rank, (*data)->seeds->n, num_maint);
+
+  maint = calloc((*data)->seeds->n, sizeof(char));
+  assert(maint != NULL);
+  for(int i = 0; i < num_maint; ++i) { maint[rank[i]] = 1; }
+  free(rank); free(prio);
+
+  if((*irre_seeds) != NULL) { iftDestroyIntArray(irre_seeds); }
+  new_seeds = iftCreateIntArray(num_maint);
+  (*irre_seeds) = iftCreateIntArray((*data)->seeds->n - num_maint);
+
+  num_maint = num_irre = 0;
+  for(int s_id = 0; s_id < (*data)->seeds->n; ++s_id)
+  {
+    if(maint[s_id] == 1) // Relevant?
+    { new_seeds->val[num_maint++] = (*data)->seeds->val[s_id]; }
+    else { (*irre_seeds)->val[num_irre++] = (*data)->seeds->val[s_id]; }
+  }
+  free(maint);
+
+	iftDestroyIntArray(&((*data)->seeds));
+	(*data)->seeds = new_seeds;
+}
+
+//============================================================================|
+// Iterations
+//============================================================================|
+// Receives the forest of a finalized scale, whose index is within [0,Ni-1],
+// before the next iteration modifies it, and the caller's data
+typedef void (*iftSICLE_ScaleFunc)
+(iftSICLE *sicle, iftSICLE_IFTData *data, int scale, void *user_data);
+
+/*
+ * Runs the iterations of SICLE from the oversampled seeds within the IFT
+ * data provided, removing the irrelevant ones until Nf remain. The forest of
+ * the last iteration is kept within the IFT data.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments
+ *  data[in/out] - REQUIRED: IFT auxiliary data, with the oversampled seeds
+ *  on_scale[in] - OPTIONAL: Called at every finalized scale
+ *  user_data[in] - OPTIONAL: Caller's data given to on_scale
+ *
+ * RETURNS: Number of scales (i.e., iterations)
+ */
+int iftSICLE_RunIterations
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data, 
+ iftSICLE_ScaleFunc on_scale, void *user_data)
+{
+	int num_scales;
+	iftIntArray *irre_seeds;
+	iftIntArray *ni;
+
+	ni = iftSICLE_CreateNiArray(args, data);
+	num_scales = ni->n;
+
+	irre_seeds = NULL;
+  for(int it = 1; it < ni->n; ++it)
+  {
+  	#ifdef IFT_DEBUG //-------------------------------------------------------|
+		fprintf(stderr, "DEBUG (%s): Iteration %d\n", __func__, it);
+		#endif //-----------------------------------------------------------------|	
+		if(args->use_dift == false || it == 1) // Seq or 1st iter?
+		{ iftSICLE_RunSeedIFT(sicle, args, &data); }
+		else 
+		{ iftSICLE_RunSeedDIFT(sicle, args, &data, &irre_seeds); }
+		if(on_scale != NULL) { on_scale(sicle, data, it - 1, user_data); }
+
+		#ifdef IFT_DEBUG //-------------------------------------------------------|
+		iftImage *seed_img = iftSICLE_CreateSeedImage(sicle, data);
+		iftWriteImageByExt(seed_img, "debug/seeds_%d_%d.pgm", it, ni->val[it-1]);
+		iftDestroyImage(&seed_img);
+		iftImage *segm_img = iftSICLE_CreateLabelImage(sicle, data);
+		iftWriteImageByExt(segm_img, "debug/segm_%d_%d.pgm", it, ni->val[it-1]);
+		iftDestroyImage(&segm_img);
+		fprintf(stderr, "DEBUG (%s): Ni = %d\n", __func__, ni->val[it]);
+		#endif //-----------------------------------------------------------------|		
+		
+		iftSICLE_RemSeeds(sicle, ni->val[it], args,&data, &irre_seeds);
+  }
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	fprintf(stderr, "DEBUG (%s): Last iteration\n", __func__);
+	#endif //-------------------------------------------------------------------|	
+	// Segmentation with Nf seeds
+	if(args->use_dift == false) // Seq?
+	{ iftSICLE_RunSeedIFT(sicle, args, &data); }
+	else 
+	{ iftSICLE_RunSeedDIFT(sicle, args, &data, &irre_seeds); }
+	if(on_scale != NULL) { on_scale(sicle, data, ni->n - 1, user_data); }
+	
+  #ifdef IFT_DEBUG //---------------------------------------------------------|
+	iftImage *seed_img = iftSICLE_CreateSeedImage(sicle, data);
+	iftWriteImageByExt(seed_img, "debug/seeds_%d_%d.pgm", ni->n, args->nf);
+	iftDestroyImage(&seed_img);
+	iftImage *segm_img = iftSICLE_CreateLabelImage(sicle, data);
+	iftWriteImageByExt(segm_img, "debug/segm_%d_%d.pgm", ni->n, args->nf);
+	iftDestroyImage(&segm_img);
+	#endif //-------------------------------------------------------------------|
+
+	if(irre_seeds != NULL) { iftDestroyIntArray(&irre_seeds); } // Seq
+	iftDestroyIntArray(&ni);
+	return num_scales;
+}
+
+/*
+ * Stores the label image of the scale's forest within the caller's array of
+ * label images, at the scale's index
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data with the scale's forest
+ *  scale[in] - REQUIRED: Index of the scale
+ *  user_data[in/out] - REQUIRED: Array of label images, with Ni positions
+ */
+void iftSICLE_StoreScale
+(iftSICLE *sicle, iftSICLE_IFTData *data, int scale, void *user_data)
+{ ((iftImage**)user_data)[scale] = iftSICLE_CreateLabelImage(sicle, data); }
+
+/*
+ * Stores the label image of the scale's forest for every Nf target of that
+ * scale
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data with the scale's forest
+ *  scale[in] - REQUIRED: Index of the scale
+ *  user_data[in/out] - REQUIRED: Nf targets' segmentations
+ */
+void iftSICLE_StoreTargets
+(iftSICLE *sicle, iftSICLE_IFTData *data, int scale, void *user_data)
+{
+	iftImage *label_img;
+	iftSICLE_Targets *targets;
+
+	targets = (iftSICLE_Targets*)user_data;
+	label_img = NULL;
+	for(long i = 0; i < targets->num_targets; ++i)
+	{
+		if(targets->scale[i] == scale)
+		{
+			if(label_img == NULL) 
+			{ label_img = iftSICLE_CreateLabelImage(sicle, data); }
+			else { label_img = iftCopyImage(label_img); } // Same Ni
+			targets->segm[i] = label_img;
+		}
+	}
+}
+
+/*
+ * Randomly adds seeds within the region of interest to the IFT data's seeds
+ * until there are at least the quantity provided, such that the warm-started
+ * seeds may be reduced to Nf. The current seeds keep their order.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  min_seeds[in] - REQUIRED: Minimum quantity of seeds (< ROI's size)
+ */
+void iftSICLE_TopUpSeeds
+(iftSICLE *sicle, iftSICLE_IFTData *data, int min_seeds)
+{
+	int num_seeds;
+	iftBMap *marked;
+	iftIntArray *seeds;
+
+	if(data->seeds->n >= min_seeds) { return; }
+
+	seeds = iftCreateIntArray(min_seeds);
+	marked = iftCreateBMap(sicle->mimg->n);
+	for(num_seeds = 0; num_seeds < data->seeds->n; ++num_seeds)
+	{
+		seeds->val[num_seeds] = data->seeds->val[num_seeds];
+		iftBMapSet1(marked, seeds->val[num_seeds]);
+	}
+
+	while(num_seeds < min_seeds)
+	{
+		int s_index;
+
+		s_index = iftRandomInteger(0, sicle->mimg->n - 1);
+		if(!iftBMapValue(marked, s_index) && iftSICLE_InROI(sicle, s_index))
+		{
+			seeds->val[num_seeds++] = s_index;
+			iftBMapSet1(marked, s_index);
+		}
+	}
+	iftDestroyBMap(&marked);
+
+	iftDestroyIntArray(&(data->seeds));
+	data->seeds = seeds;
+}
+
+//============================================================================|
+// Hierarchy
+//============================================================================|
+/*
+ * Creates an empty hierarchy of the number of scales provided
+ *
+ * PARAMETERS:
+ *  num_scales[in] - REQUIRED: Number of scales
+ *
+ * RETURNS: Hierarchy without label images nor tables
+ */
+iftSICLEHierarchy *iftSICLE_CreateHierarchy
+(int num_scales)
+{
+	iftSICLEHierarchy *hier;
+
+	hier = malloc(sizeof(iftSICLEHierarchy));
+	assert(hier != NULL);
+	hier->num_scales = num_scales;
+	hier->finest = NULL;
+	hier->parent = calloc(num_scales, sizeof(iftIntArray*));
+	assert(hier->parent != NULL);
+	hier->exc_index = calloc(num_scales, sizeof(iftIntArray*));
+	assert(hier->exc_index != NULL);
+	hier->exc_label = calloc(num_scales, sizeof(iftIntArray*));
+	assert(hier->exc_label != NULL);
+
+	return hier;
+}
+
+/*
+ * Adds the scale of the forest provided to the hierarchy being built. The
+ * first scale becomes its finest label image. For each following one, every
+ * finest superspel is mapped to the label that most of its spels have (ties
+ * are broken by the first to be reached), and the spels whose labels differ
+ * from their finest superspel's are kept as exceptions, since the scales are
+ * mostly, but not always, nested.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data with the scale's forest
+ *  scale[in] - REQUIRED: Index of the scale
+ *  user_data[in/out] - REQUIRED: Hierarchy being built
+ */
+void iftSICLE_AddHierarchyScale
+(iftSICLE *sicle, iftSICLE_IFTData *data, int scale, void *user_data)
+{
+	long num_exc;
+	int *start, *order, *count;
+	iftImage *label_img;
+	iftIntArray *parent;
+	iftSICLEHierarchy *hier;
+
+	hier = (iftSICLEHierarchy*)user_data;
+	if(scale == 0) 
+	{ hier->finest = iftSICLE_CreateLabelImage(sicle, data); return; }
+
+	label_img = iftSICLE_CreateLabelImage(sicle, data);
+	parent = iftCreateIntArray(iftMaximumValue(hier->finest) + 1);
+
+	// Groups the spels by their finest superspel (i.e., a counting sort)
+	start = calloc(parent->n + 1, sizeof(int));
+	order = malloc(label_img->n * sizeof(int));
+	count = calloc(iftMaximumValue(label_img) + 1, sizeof(int));
+	assert(start != NULL); assert(order != NULL); assert(count != NULL);
+	for(int v_index = 0; v_index < label_img->n; ++v_index)
+	{ start[hier->finest->val[v_index] + 1]++; }
+	for(long i = 0; i < parent->n; ++i) { start[i + 1] += start[i]; }
+	for(int v_index = 0; v_index < label_img->n; ++v_index)
+	{ order[start[hier->finest->val[v_index]]++] = v_index; }
+	for(long i = parent->n; i > 0; --i) { start[i] = start[i - 1]; }
+	start[0] = 0;
+
+	for(long i = 0; i < parent->n; ++i)
+	{
+		int max_count;
+
+		max_count = 0;
+		for(int j = start[i]; j < start[i + 1]; ++j)
+		{
+			int label;
+
+			label = label_img->val[order[j]];
+			count[label]++;
+			if(count[label] > max_count)
+			{ max_count = count[label]; parent->val[i] = label; }
+		}
+		for(int j = start[i]; j < start[i + 1]; ++j) // Resets only those counted
+		{ count[label_img->val[order[j]]] = 0; }
+	}
+	free(start); free(order); free(count);
+
+	num_exc = 0;
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for reduction(+:num_exc)
+	#endif //-------------------------------------------------------------------|
+	for(int v_index = 0; v_index < label_img->n; ++v_index)
+	{
+		if(label_img->val[v_index] != parent->val[hier->finest->val[v_index]])
+		{ num_exc++; }
+	}
+
+	hier->exc_index[scale] = iftCreateIntArray(num_exc);
+	hier->exc_label[scale] = iftCreateIntArray(num_exc);
+	num_exc = 0;
+	for(int v_index = 0; v_index < label_img->n; ++v_index)
+	{
+		if(label_img->val[v_index] != parent->val[hier->finest->val[v_index]])
+		{
+			hier->exc_index[scale]->val[num_exc] = v_index;
+			hier->exc_label[scale]->val[num_exc] = label_img->val[v_index];
+			num_exc++;
+		}
+	}
+	hier->parent[scale] = parent;
+	iftDestroyImage(&label_img);
+}
+
+//============================================================================|
+// Scale Emission
+//============================================================================|
+/*
+ * Runs the writer thread of a scale sink, which calls its receiver for every
+ * scale handed until the sink is done, and frees them afterwards
+ *
+ * PARAMETERS:
+ *  arg[in/out] - REQUIRED: Scale sink
+ *
+ * RETURNS: NULL
+ */
+void *iftSICLE_RunScaleWriter
+(void *arg)
+{
+	iftSICLE_ScaleSink *sink;
+
+	sink = (iftSICLE_ScaleSink*)arg;
+	pthread_mutex_lock(&(sink->lock));
+	while(true)
+	{
+		int scale;
+		iftImage *label_img;
+
+		while(sink->label_img == NULL && !sink->is_done)
+		{ pthread_cond_wait(&(sink->cond), &(sink->lock)); }
+		if(sink->label_img == NULL) { break; } // Done and nothing handed
+
+		label_img = sink->label_img; scale = sink->scale;
+		sink->label_img = NULL; sink->is_busy = true;
+		pthread_mutex_unlock(&(sink->lock));
+
+		sink->emit(label_img, scale, sink->user_data);
+		iftDestroyImage(&label_img);
+
+		pthread_mutex_lock(&(sink->lock));
+		sink->is_busy = false;
+		pthread_cond_broadcast(&(sink->cond));
+	}
+	pthread_mutex_unlock(&(sink->lock));
+
+	return NULL;
+}
+
+/*
+ * Emits the label image of the scale's forest through the sink provided. If 
+ * it is in parallel, the label image is handed to the writer thread once it
+ * has emitted the previous one, such that the next iterations overlap with
+ * its emission and a single label image is kept at a time.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data with the scale's forest
+ *  scale[in] - REQUIRED: Index of the scale
+ *  user_data[in/out] - REQUIRED: Scale sink
+ */
+void iftSICLE_EmitScale
+(iftSICLE *sicle, iftSICLE_IFTData *data, int scale, void *user_data)
+{
+	iftSICLE_ScaleSink *sink;
+
+	sink = (iftSICLE_ScaleSink*)user_data;
+	if(sink->in_parallel == false)
+	{
+		iftImage *label_img;
+
+		label_img = iftSICLE_CreateLabelImage(sicle, data);
+		sink->emit(label_img, scale, sink->user_data);
+		iftDestroyImage(&label_img);
+	}
+	else
+	{
+		iftImage *label_img;
+
+		pthread_mutex_lock(&(sink->lock));
+		while(sink->label_img != NULL || sink->is_busy) // Previous one emitted?
+		{ pthread_cond_wait(&(sink->cond), &(sink->lock)); }
+		pthread_mutex_unlock(&(sink->lock));
+
+		label_img = iftSICLE_CreateLabelImage(sicle, data);
+
+		pthread_mutex_lock(&(sink->lock));
+		sink->label_img = label_img; sink->scale = scale;
+		pthread_cond_broadcast(&(sink->cond));
+		pthread_mutex_unlock(&(sink->lock));
+	}
+}
+
+//============================================================================|
+// Streaming
+//============================================================================|
+// Orders the (label, global label) pairs encoded as long integers
+int iftSICLE_CmpPairs
+(const void *a, const void *b)
+{
+	long pa, pb;
+
+	pa = *(const long*)a; pb = *(const long*)b;
+	return (pa > pb) - (pa < pb);
+}
+
+// Orders the matches by decreasing overlap, and then by their labels
+int iftSICLE_CmpMatches
+(const void *a, const void *b)
+{
+	const iftSICLE_Match *ma, *mb;
+
+	ma = (const iftSICLE_Match*)a; mb = (const iftSICLE_Match*)b;
+	if(ma->count != mb->count) { return (mb->count > ma->count) - (mb->count < ma->count); }
+	if(ma->label != mb->label) { return (ma->label > mb->label) - (ma->label < mb->label); }
+	return (ma->glob > mb->glob) - (ma->glob < mb->glob);
+}
+
+/*
+ * Maps labels to global labels given pairs of (label, global label) of the 
+ * same spels. Each label inherits, at most once, the global label with which
+ * it overlaps the most (greedily, by decreasing overlap). The remaining ones 
+ * receive new global labels.
+ *
+ * PARAMETERS:
+ *  label[in] - REQUIRED: Labels within [0,max_label] (0 is ignored)
+ *  glob_label[in] - REQUIRED: Global labels within [0,next_label[ (0 is ignored)
+ *  num_pairs[in] - REQUIRED: Number of pairs (may be 0)
+ *  max_label[in] - REQUIRED: Maximum label
+ *  next_label[in/out] - REQUIRED: Next unused global label
+ *
+ * RETURNS: Global label of each label within [0,max_label]. The label 0 is kept
+ */
+int *iftSICLE_MatchLabels
+(const int *label, const int *glob_label, int num_pairs, int max_label, 
+ int *next_label)
+{
+	int *glob;
+
+	glob = malloc((max_label + 1) * sizeof(int));
+	assert(glob != NULL);
+
+	glob[0] = 0;
+	for(int l = 1; l <= max_label; ++l) { glob[l] = IFT_NIL; }
+
+	if(num_pairs > 0)
+	{
+		int num_matches;
+		long *pair;
+		char *taken;
+		iftSICLE_Match *match;
+
+		pair = malloc(num_pairs * sizeof(long));
+		assert(pair != NULL);
+		#ifdef IFT_OMP //-------------------------------------------------------|
+		#pragma omp parallel for
+		#endif //---------------------------------------------------------------|
+		for(int i = 0; i < num_pairs; ++i)
+		{ pair[i] = (long)label[i] * (*next_label) + glob_label[i]; }
+		qsort(pair, num_pairs, sizeof(long), iftSICLE_CmpPairs);
+
+		match = malloc(num_pairs * sizeof(iftSICLE_Match));
+		assert(match != NULL);
+		num_matches = 0;
+		for(int i = 0; i < num_pairs; ++i)
+		{
+			if(i == 0 || pair[i] != pair[i - 1]) // New pair?
+			{
+				match[num_matches].count = 0;
+				match[num_matches].label = pair[i] / (*next_label);
+				match[num_matches].glob = pair[i] % (*next_label);
+				num_matches++;
+			}
+			match[num_matches - 1].count++;
+		}
+		free(pair);
+		qsort(match, num_matches, sizeof(iftSICLE_Match), iftSICLE_CmpMatches);
+
+		taken = calloc((*next_label), sizeof(char));
+		assert(taken != NULL);
+		for(int i = 0; i < num_matches; ++i)
+		{
+			int l, g;
+
+			l = match[i].label; g = match[i].glob;
+			if(l > 0 && g > 0 && glob[l] == IFT_NIL && taken[g] == 0)
+			{ glob[l] = g; taken[g] = 1; }
+		}
+		free(taken); free(match);
+	}
+
+	for(int l = 1; l <= max_label; ++l)
+	{ if(glob[l] == IFT_NIL) { glob[l] = (*next_label)++; } }
+
+	return glob;
+}
+
+/*
+ * Maps the labels of a window's segmentation to global labels, by matching 
+ * them within the frames shared with the previous window (if any).
+ *
+ * PARAMETERS:
+ *  segm[in] - REQUIRED: Window's segmentation whose labels are within [0,N]
+ *  start[in] - REQUIRED: Window's first frame
+ *  prev_glob[in] - OPTIONAL: Previous window's global segmentation
+ *  prev_start[in] - REQUIRED: Previous window's first frame (if any)
+ *  next_label[in/out] - REQUIRED: Next unused global label
+ *
+ * RETURNS: Global label of each label within [0,N]. The label 0 is kept
+ */
+int *iftSICLE_MatchWindowLabels
+(iftImage *segm, int start, iftImage *prev_glob, int prev_start, 
+ int *next_label)
+{
+	int num_pairs, shift;
+
+	num_pairs = shift = 0;
+	if(prev_glob != NULL && prev_start + prev_glob->zsize > start)
+	{
+		int slice_size;
+
+		slice_size = segm->xsize * segm->ysize;
+		num_pairs = (prev_start + prev_glob->zsize - start) * slice_size;
+		shift = (start - prev_start) * slice_size;
+	}
+
+	return iftSICLE_MatchLabels(segm->val, 
+															(prev_glob != NULL) ? prev_glob->val + shift : NULL,
+															num_pairs, iftMaximumValue(segm), next_label);
+}
+
+/*
+ * Loads the frames of a window not yet within the ring buffer, and copies
+ * every one of them to the window's volume, which is created at the first
+ * call.
+ *
+ * PARAMETERS:
+ *  frames[in] - REQUIRED: Paths of the video's frames
+ *  start[in] - REQUIRED: Window's first frame
+ *  window_size[in] - REQUIRED: Window's number of frames
+ *  ring[in/out] - REQUIRED: Loaded frames, indexed by frame modulo window size
+ *  ring_id[in/out] - REQUIRED: Frame held by each ring's slot (-1 if none)
+ *  volume[in/out] - REQUIRED: Window's volume. Created if NULL
+ */
+void iftSICLE_LoadWindow
+(const iftFileSet *frames, int start, int window_size, iftImage **ring, 
+ int *ring_id, iftImage **volume)
+{
+	for(int t = start; t < start + window_size; ++t)
+	{
+		int slot;
+
+		slot = t % window_size;
+		if(ring_id[slot] != t) // Not loaded yet?
+		{
+			const char *PATH;
+
+			PATH = frames->files[t]->path;
+			if(!iftIsImageFile(PATH) || iftCompareStrings(iftFileExt(PATH),".scn"))
+			{ iftError("File %s cannot be read as a video frame", __func__, PATH); }
+
+			if(ring[slot] != NULL) { iftDestroyImage(&(ring[slot])); }
+			ring[slot] = iftReadImageByExt(PATH); ring_id[slot] = t;
+
+			if((*volume) == NULL)
+			{
+				if(iftIsColorImage(ring[slot]) == true)
+				{
+					(*volume) = iftCreateColorImage(ring[slot]->xsize, ring[slot]->ysize,
+																					window_size, iftImageDepth(ring[slot]));
+				}
+				else 
+				{ 
+					(*volume) = iftCreateImage(ring[slot]->xsize, ring[slot]->ysize, 
+																		 window_size); 
+				}
+			}
+			if(ring[slot]->xsize != (*volume)->xsize || 
+				 ring[slot]->ysize != (*volume)->ysize || ring[slot]->zsize != 1)
+			{ iftError("The frame %s differs from the first one's domain", __func__, PATH); }
+			if(iftIsColorImage(ring[slot]) != iftIsColorImage((*volume)))
+			{ 
+				iftError("The frame %s and the first one must either be colored or "
+								 "grayscaled", __func__, PATH);
+			}
+		}
+		iftPutXYSlice((*volume), ring[slot], t - start);
+	}
+}
+
+//============================================================================|
+// Tiling
+//============================================================================|
+/*
+ * Computes the core (i.e., the spels labeled by the tile) and the extended 
+ * region (i.e., the core expanded by the overlap) of a tile in raster order
+ *
+ * PARAMETERS:
+ *  dom[in] - REQUIRED: Image's domain
+ *  tile_size[in] - REQUIRED: Core's side length
+ *  overlap[in] - REQUIRED: Core's expansion length on each side
+ *  k[in] - REQUIRED: Tile's raster index
+ *  core[out] - REQUIRED: Core's (inclusive) bounding box
+ *  ext[out] - REQUIRED: Extended region's (inclusive) bounding box
+ */
+void iftSICLE_CalcTileBoxes
+(iftImageDomain dom, int tile_size, int overlap, int k, iftBoundingBox *core,
+ iftBoundingBox *ext)
+{
+	int num_xtiles;
+
+	num_xtiles = (dom.xsize + tile_size - 1) / tile_size;
+
+	core->begin.x = (k % num_xtiles) * tile_size; 
+	core->begin.y = (k / num_xtiles) * tile_size;
+	core->end.x = iftMin(core->begin.x + tile_size, dom.xsize) - 1;
+	core->end.y = iftMin(core->begin.y + tile_size, dom.ysize) - 1;
+	core->begin.z = core->end.z = 0;
+
+	ext->begin.x = iftMax(core->begin.x - overlap, 0);
+	ext->begin.y = iftMax(core->begin.y - overlap, 0);
+	ext->end.x = iftMin(core->end.x + overlap, dom.xsize - 1);
+	ext->end.y = iftMin(core->end.y + overlap, dom.ysize - 1);
+	ext->begin.z = ext->end.z = 0;
+}
+
+/*
+ * Sets the arguments of a tile. If a global target is given, its quantities of
+ * seeds are proportional to its size, keeping the N0/Nf ratio of the original
+ * arguments. Then, they are clamped to the tile's size, down to the least
+ * runnable quantities (i.e., N0 = 3 and Nf = 2).
+ *
+ * PARAMETERS:
+ *  args[in] - REQUIRED: SICLE arguments
+ *  num_spels[in] - REQUIRED: Tile's number of spels
+ *  img_area[in] - REQUIRED: Image's number of spels
+ *  global_nf[in] - REQUIRED: Global quantity of superspels (0 = per tile)
+ *  targs[out] - REQUIRED: Tile's arguments, sharing the user's Ni (if any)
+ *
+ * RETURNS: Whether the tile is large enough to be segmented by SICLE
+ */
+bool iftSICLE_SetTileArgs
+(iftSICLEArgs *args, int num_spels, long img_area, int global_nf,
+ iftSICLEArgs *targs)
+{
+	(*targs) = (*args);
+	if(global_nf > 0)
+	{
+		targs->nf = iftMax(2, iftRound(global_nf * (double)num_spels / img_area));
+		targs->n0 = iftMax(3, iftRound(targs->nf * (args->n0 / (double)args->nf)));
+	}
+	targs->n0 = iftMax(3, iftMin(targs->n0, num_spels - 1));
+	targs->nf = iftMax(2, iftMin(targs->nf, targs->n0 - 1));
+
+	return targs->n0 < num_spels;
+}
+
+/*
+ * Re-conquers the band of a tile's core next to its finalized neighbors by an
+ * Fmax IFT, whose seeds are the fixed spels adjacent to the band (i.e., the 
+ * neighbors' seam spels and the core's spels past the band). Thus, the labels
+ * across the seams compete for the band according to the tile's features.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data of the tile's extended region
+ *  args[in] - REQUIRED: SICLE arguments
+ *  status[in] - REQUIRED: Spel's status: 0 if ignored, 1 if fixed, 2 if band
+ *  segm[in/out] - REQUIRED: Tile's global labels to be updated in the band
+ */
+void iftSICLE_StitchBand
+(iftSICLE *sicle, iftSICLEArgs *args, char *status, iftImage *segm)
+{
+	int *root;
+	double *cost;
+	iftAdjRel *A;
+	iftDHeap *heap;
+
+	if(segm->zsize > 1) { A = iftSpheric((args->use_diag) ? sqrtf(3.0) : 1.0); }
+	else { A = iftCircular((args->use_diag) ? sqrtf(2.0) : 1.0); }
+
+	cost = malloc(segm->n * sizeof(double));
+	root = malloc(segm->n * sizeof(int));
+	assert(cost != NULL); assert(root != NULL);
+	heap = iftCreateDHeap(segm->n, cost);
+
+	for(int v_index = 0; v_index < segm->n; ++v_index)
+	{
+		cost[v_index] = IFT_INFINITY_DBL; root[v_index] = v_index;
+		if(status[v_index] == 1) // Fixed and adjacent to the band?
+		{
+			iftVoxel v_vxl;
+
+			v_vxl = iftGetVoxelCoord(segm, v_index);
+			for(int i = 1; i < A->n; ++i)
+			{
+				iftVoxel u_vxl;
+
+				u_vxl = iftGetAdjacentVoxel(A, v_vxl, i);
+				if(iftValidVoxel(segm, u_vxl) && 
+					 status[iftGetVoxelIndex(segm, u_vxl)] == 2)
+				{ cost[v_index] = 0; iftInsertDHeap(heap, v_index); break; }
+			}
+		}
+	}
+
+	while(!iftEmptyDHeap(heap))
+	{
+		int v_index;
+		iftVoxel v_vxl;
+
+		v_index = iftRemoveDHeap(heap);
+		v_vxl = iftGetVoxelCoord(segm, v_index);
+		for(int i = 1; i < A->n; ++i)
+		{
+			int u_index;
+			iftVoxel u_vxl;
+
+			u_vxl = iftGetAdjacentVoxel(A, v_vxl, i);
+			if(!iftValidVoxel(segm, u_vxl)) { continue; }
+
+			u_index = iftGetVoxelIndex(segm, u_vxl);
+			if(status[u_index] == 2 && heap->color[u_index] != IFT_BLACK)
+			{
+				double path_cost;
+
+				path_cost = iftEuclDistance(sicle->mimg->val[root[v_index]], 
+																		sicle->mimg->val[u_index], sicle->mimg->m);
+				path_cost = iftMax(cost[v_index], path_cost);
+				if(path_cost < cost[u_index])
+				{
+					cost[u_index] = path_cost; root[u_index] = root[v_index];
+					segm->val[u_index] = segm->val[v_index];
+					if(heap->color[u_index] == IFT_GRAY) 
+					{ iftGoUpDHeap(heap, heap->pos[u_index]); }
+					else { iftInsertDHeap(heap, u_index); }
+				}
+			}
+		}
+	}
+
+	iftDestroyDHeap(&heap);
+	free(cost); free(root);
+	iftDestroyAdjRel(&A);
+}
+
+/*
+ * Pins the frames a window shares with the previous one to their previous
+ * global labels, and re-conquers the window's band of frames right after 
+ * them. Thus, the superspels cross the window's seam consistently.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data of the window
+ *  args[in] - REQUIRED: SICLE arguments
+ *  start[in] - REQUIRED: Window's first frame
+ *  prev_glob[in] - REQUIRED: Previous window's global labels
+ *  prev_start[in] - REQUIRED: Previous window's first frame
+ *  band_size[in] - REQUIRED: Number of frames to be re-conquered
+ *  segm[in/out] - REQUIRED: Window's global labels
+ */
+void iftSICLE_PinSharedFrames
+(iftSICLE *sicle, iftSICLEArgs *args, int start, iftImage *prev_glob,
+ int prev_start, int band_size, iftImage *segm)
+{
+	int slice_size, num_shared, shift;
+	char *status;
+
+	slice_size = segm->xsize * segm->ysize;
+	num_shared = iftMax(0, prev_start + prev_glob->zsize - start);
+	shift = (start - prev_start) * slice_size;
+	if(num_shared == 0) { return; }
+
+	status = malloc(segm->n * sizeof(char));
+	assert(status != NULL);
+
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int v_index = 0; v_index < segm->n; ++v_index)
+	{
+		int t;
+
+		t = v_index / slice_size;
+		if(t < num_shared) 
+		{ 
+			segm->val[v_index] = prev_glob->val[v_index + shift]; 
+			status[v_index] = 1;
+		}
+		else if(t < num_shared + band_size) { status[v_index] = 2; }
+		else { status[v_index] = 1; }
+	}
+
+	iftSICLE_StitchBand(sicle, args, status, segm);
+	free(status);
+}
+
+/*
+ * Stitches a segmented tile to its finalized neighbors (i.e., the left and
+ * the upper ones). Its labels inherit the global labels they most overlap
+ * with in the neighbors' cores covered by its extended region, and then its
+ * band next to them is re-conquered. Finally, the core's right and bottom
+ * bands are kept for its right and lower neighbors.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data of the tile's extended region
+ *  args[in] - REQUIRED: SICLE arguments
+ *  dom[in] - REQUIRED: Image's domain
+ *  overlap[in] - REQUIRED: Core's expansion length on each side
+ *  core[in] - REQUIRED: Core's bounding box
+ *  ext[in] - REQUIRED: Extended region's bounding box
+ *  top[in] - REQUIRED: Global labels of the rows above the core's row
+ *  left[in/out] - REQUIRED: Global labels of the columns left of the core
+ *  next_top[out] - REQUIRED: Global labels of the core's row's last rows
+ *  next_label[in/out] - REQUIRED: Next unused global label
+ *  segm[in/out] - REQUIRED: Tile's labels, replaced by the global ones
+ */
+void iftSICLE_StitchTile
+(iftSICLE *sicle, iftSICLEArgs *args, iftImageDomain dom, int overlap,
+ iftBoundingBox core, iftBoundingBox ext, int *top, int *left, int *next_top,
+ int *next_label, iftImage *segm)
+{
+	bool has_top, has_left;
+	int num_pairs;
+	int *label, *glob_label, *glob;
+	char *status;
+
+	has_top = core.begin.y > 0 && overlap > 0;
+	has_left = core.begin.x > 0 && overlap > 0;
+
+	status = malloc(segm->n * sizeof(char));
+	label = malloc(segm->n * sizeof(int));
+	glob_label = malloc(segm->n * sizeof(int));
+	assert(status != NULL); assert(label != NULL); assert(glob_label != NULL);
+
+	num_pairs = 0;
+	for(int v_index = 0; v_index < segm->n; ++v_index)
+	{
+		int x, y;
+		iftVoxel v_vxl;
+
+		v_vxl = iftGetVoxelCoord(segm, v_index);
+		x = v_vxl.x + ext.begin.x; y = v_vxl.y + ext.begin.y;
+
+		if(x > core.end.x || y > core.end.y) { status[v_index] = 0; }
+		else if(y < core.begin.y || x < core.begin.x) // Finalized?
+		{
+			status[v_index] = 1;
+			label[num_pairs] = segm->val[v_index];
+			if(y < core.begin.y) 
+			{ 
+				glob_label[num_pairs] = top[(y - core.begin.y + overlap) * dom.xsize + 
+																		x]; 
+			}
+			else 
+			{ 
+				glob_label[num_pairs] = left[(y - core.begin.y) * overlap + 
+																		 x - core.begin.x + overlap]; 
+			}
+			num_pairs++;
+		}
+		else if((has_left && x < core.begin.x + overlap) || 
+						(has_top && y < core.begin.y + overlap))
+		{ status[v_index] = 2; }
+		else { status[v_index] = 1; }
+	}
+
+	glob = iftSICLE_MatchLabels(label, glob_label, num_pairs, 
+															iftMaximumValue(segm), next_label);
+	num_pairs = 0;
+	for(int v_index = 0; v_index < segm->n; ++v_index)
+	{
+		iftVoxel v_vxl;
+
+		v_vxl = iftGetVoxelCoord(segm, v_index);
+		if(status[v_index] == 1 && (v_vxl.y + ext.begin.y < core.begin.y || 
+			 v_vxl.x + ext.begin.x < core.begin.x))
+		{ segm->val[v_index] = glob_label[num_pairs++]; } // Keeps the finalized
+		else { segm->val[v_index] = glob[segm->val[v_index]]; }
+	}
+	free(glob); free(label); free(glob_label);
+
+	if(has_top || has_left) { iftSICLE_StitchBand(sicle, args, status, segm); }
+	free(status);
+
+	if(overlap > 0) // Keeps the core's right and bottom bands
+	{
+		for(int y = core.begin.y; y <= core.end.y; ++y)
+		{
+			for(int x = core.begin.x; x <= core.end.x; ++x)
+			{
+				int v_index;
+
+				v_index = (x - ext.begin.x) + segm->tby[y - ext.begin.y];
+				if(x > core.end.x - overlap)
+				{ 
+					left[(y - core.begin.y) * overlap + x - core.end.x + overlap - 1] = 
+						segm->val[v_index]; 
+				}
+				if(y > core.end.y - overlap)
+				{ 
+					next_top[(y - core.end.y + overlap - 1) * dom.xsize + x] = 
+						segm->val[v_index]; 
+				}
+			}
+		}
+	}
+}
+
+//============================================================================|
+// Seed Edition
+//============================================================================|
+/*
+ * Prepares the forest of the prototype's last segmentation for a seed
+ * edition: allocates the removal stacks, if the segmentation did not require
+ * them, and empties the queue. Since the forest will change, the tree sums
+ * are invalidated.
+ *
+ * PARAMETERS:
+ *  sicle[in/out] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments of the segmentation
+ *  label_img[in] - REQUIRED: Label image of the segmentation
+ *  func[in] - REQUIRED: Name of the public method, for error messages
+ *
+ * RETURNS: IFT data owned by the SICLE prototype
+ */
+iftSICLE_IFTData *iftSICLE_BeginSeedEdit
+(iftSICLE *sicle, iftSICLEArgs *args, iftImage *label_img, const char *func)
+{
+	iftSICLEArgs dift_args;
+	iftSICLE_IFTData *data;
+
+	data = sicle->ws;
+	if(data == NULL) 
+	{ iftError("The prototype has no segmentation to be edited", func); }
+	if(label_img->xsize != sicle->mimg->xsize || 
+		 label_img->ysize != sicle->mimg->ysize ||
+		 label_img->zsize != sicle->mimg->zsize)
+	{ iftError("The label image's domain differs from the prototype's", func); }
+
+	dift_args = (*args); dift_args.use_dift = true; // Removes subtrees
+	iftSICLE_AllocRemovalStacks(sicle, &dift_args, data);
+	if(data->tsums != NULL) { data->tsums->valid = false; }
+	iftSICLE_ResetPQueue(data->queue);
+
+	return data;
+}
+
+/*
+ * Gets the position of the spel within the IFT data's seeds
+ *
+ * PARAMETERS:
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  s_index[in] - REQUIRED: Spel to be searched
+ *
+ * RETURNS: Seed's position, or IFT_NIL if the spel is not a seed
+ */
+int iftSICLE_FindSeed
+(iftSICLE_IFTData *data, int s_index)
+{
+	if(iftSICLE_RootOf(data, s_index) != s_index) { return IFT_NIL; }
+
+	for(int s_id = 0; s_id < data->seeds->n; ++s_id)
+	{ if(data->seeds->val[s_id] == s_index) { return s_id; } }
+
+	return IFT_NIL;
+}
+
+/*
+ * Gets the seed of the superspel containing the voxel provided, which must
+ * have been conquered by the segmentation
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  vxl[in] - REQUIRED: Voxel within the superspel
+ *  func[in] - REQUIRED: Name of the public method, for error messages
+ *
+ * RETURNS: Seed's position within the IFT data's seeds
+ */
+int iftSICLE_FindSeedOf
+(iftSICLE *sicle, iftSICLE_IFTData *data, iftVoxel vxl, const char *func)
+{
+	int v_index, s_id;
+
+	if(!iftMValidVoxel(sicle->mimg, vxl))
+	{ iftError("Voxel (%d,%d,%d) is out of the domain", func, vxl.x, vxl.y, vxl.z); }
+
+	v_index = iftMGetVoxelIndex(sicle->mimg, vxl);
+	if(iftSICLE_CostOf(data, v_index) == IFTSICLE_BKGCOST ||
+		 iftSICLE_RootOf(data, v_index) == IFTSICLE_NIL) // Not conquered?
+	{ iftError("Voxel (%d,%d,%d) has no superspel", func, vxl.x, vxl.y, vxl.z); }
+
+	s_id = iftSICLE_FindSeed(data, iftSICLE_RootOf(data, v_index));
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(s_id != IFT_NIL);
+	#endif //-------------------------------------------------------------------|
+
+	return s_id;
+}
+
+/*
+ * Gets the spel at the voxel provided for becoming a seed, which must be 
+ * within the region of interest and must not be a seed already
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in] - REQUIRED: IFT auxiliary data
+ *  vxl[in] - REQUIRED: Voxel of the new seed
+ *  func[in] - REQUIRED: Name of the public method, for error messages
+ *
+ * RETURNS: Spel of the new seed
+ */
+int iftSICLE_GetNewSeed
+(iftSICLE *sicle, iftSICLE_IFTData *data, iftVoxel vxl, const char *func)
+{
+	int s_index;
+
+	if(!iftMValidVoxel(sicle->mimg, vxl))
+	{ iftError("Voxel (%d,%d,%d) is out of the domain", func, vxl.x, vxl.y, vxl.z); }
+
+	s_index = iftMGetVoxelIndex(sicle->mimg, vxl);
+	if(!iftSICLE_InROI(sicle, s_index))
+	{ 
+		iftError("Voxel (%d,%d,%d) is out of the region of interest", func, 
+						 vxl.x, vxl.y, vxl.z); 
+	}
+	if(iftSICLE_FindSeed(data, s_index) != IFT_NIL)
+	{ iftError("Voxel (%d,%d,%d) is already a seed", func, vxl.x, vxl.y, vxl.z); }
+
+	return s_index;
+}
+
+/*
+ * Removes the tree of the seed provided, and inserts the spels at its
+ * frontier in the queue for a new competition. The seed must be removed
+ * from the IFT data's seeds by the caller.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  s_index[in] - REQUIRED: Seed whose tree is removed
+ *  bb[in/out] - REQUIRED: Bounding box expanded by the removed spels
+ */
+void iftSICLE_UprootSeed
+(iftSICLE *sicle, iftSICLE_IFTData *data, int s_index, iftBoundingBox *bb)
+{
+	int num_front;
+	iftIntArray *irre_seeds;
+
+	irre_seeds = iftCreateIntArray(1);
+	irre_seeds->val[0] = s_index;
+	num_front = iftSICLE_RemoveTrees(sicle, &data, &irre_seeds, bb);
+
+	while(num_front > 0)
+	{ iftSICLE_InsertPQueue(data->queue, data->front_stack[--num_front]); }
+}
+
+/*
+ * Turns the spel provided into a seed with the label given, and inserts it
+ * in the queue for offering its paths to its adjacents. The seed must be 
+ * added to the IFT data's seeds by the caller.
+ *
+ * PARAMETERS:
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  s_index[in] - REQUIRED: Spel of the new seed
+ *  label[in] - REQUIRED: Label of the new seed's tree (> 0)
+ */
+void iftSICLE_PlantSeed
+(iftSICLE_IFTData *data, int s_index, int label)
+{
+	iftSICLE_RootOf(data, s_index) = s_index;
+	iftSICLE_PredOf(data, s_index) = -label; // 2's complement
+	iftSICLE_CostOf(data, s_index) = 0;
+
+	if(iftSICLE_InPQueue(data->queue, s_index)) // A frontier spel?
+	{ iftSICLE_RemovePQueueElem(data->queue, s_index); }
+	iftSICLE_InsertPQueue(data->queue, s_index);
+}
+
+/*
+ * Propagates the differential IFT from the spels within the queue, and 
+ * relabels the label image within the bounding box of the spels whose trees
+ * may have changed. Unconquered spels (i.e., unreachable from every seed) 
+ * are labeled as background.
+ *
+ * PARAMETERS:
+ *  sicle[in] - REQUIRED: SICLE auxiliary data
+ *  args[in] - REQUIRED: SICLE arguments of the segmentation
+ *  data[in/out] - REQUIRED: IFT auxiliary data to be modified
+ *  bb[in/out] - REQUIRED: Bounding box of the changed spels to be expanded
+ *  label_img[in/out] - REQUIRED: Label image of the segmentation
+ */
+void iftSICLE_EndSeedEdit
+(iftSICLE *sicle, iftSICLEArgs *args, iftSICLE_IFTData *data,
+ iftBoundingBox *bb, iftImage *label_img)
+{
+	iftSICLE_PropagateDIFT(sicle, args, &data, data->queue, bb);
+
+	for(int z = bb->begin.z; z <= bb->end.z; ++z)
+	{
+		for(int y = bb->begin.y; y <= bb->end.y; ++y)
+		{
+			for(int x = bb->begin.x; x <= bb->end.x; ++x)
+			{
+				int v_index;
+				iftVoxel v_voxel;
+
+				v_voxel.x = x; v_voxel.y = y; v_voxel.z = z;
+				v_index = iftMGetVoxelIndex(sicle->mimg, v_voxel);
+				if(iftSICLE_InROI(sicle, v_index) && 
+					 iftSICLE_RootOf(data, v_index) != IFTSICLE_NIL)
+				{ label_img->val[v_index] = iftSICLE_GetRootLabel(data, v_index) + 1; }
+				else { label_img->val[v_index] = 0; }
+			}
+		}
+	}
+}
+
+//############################################################################|
+// 
+//	PUBLIC METHODS
+//
+//############################################################################|
+//============================================================================|
+// iftSICLEArgs
+//============================================================================|
+iftSICLEArgs *iftCreateSICLEArgs()
+{
+	iftSICLEArgs *args;
+
+	args = malloc(sizeof(iftSICLEArgs));
+	assert(args != NULL);
+
+	args->use_diag = true;
+	args->use_dift = true;
+	args->use_bqueue = false;
+	args->n0 = 3000;
+	args->nf = 200;
+	args->max_iters = 5;
+	args->irreg = 0.12;
+	args->adhr = 12;
+	args->num_buckets = 65536;
+	args->tile_size = 0;
+	args->alpha = 0.0;
+	args->user_ni = NULL;
+	args->nf_targets = NULL;
+	args->samplopt = IFT_SICLE_SAMPL_RND;
+	args->connopt = IFT_SICLE_CONN_FMAX;
+	args->critopt = IFT_SICLE_CRIT_MINSC;
+	args->penopt = IFT_SICLE_PEN_NONE;
+
+	return args;
+}
+
+inline void iftDestroySICLEArgs
+(iftSICLEArgs **args)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(args != NULL);
+	#endif //-------------------------------------------------------------------|
+	if((*args) != NULL) 
+	{
+		if((*args)->user_ni != NULL) { iftDestroyIntArray(&((*args)->user_ni)); } 
+		if((*args)->nf_targets != NULL) 
+		{ iftDestroyIntArray(&((*args)->nf_targets)); } 
+		free(*args); 
 		(*args) = NULL; 
 	}
 }
 
-//============================================================================|
-// iftSICLE
-//============================================================================|
-iftSICLE *iftCreateSICLE
-(iftImage *img, iftImage *objsm, iftImage *mask)
+//============================================================================|
+// iftSICLE
+//============================================================================|
+iftSICLE *iftCreateSICLE
+(iftImage *img, iftImage *objsm, iftImage *mask)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(img != NULL);
+	if(objsm != NULL) { iftVerifyImageDomains(img, objsm, __func__); }
+	if(mask != NULL) { iftVerifyImageDomains(img, mask, __func__); }
+	#endif //-------------------------------------------------------------------|
+	iftSICLE *sicle;
+
+	sicle = malloc(sizeof(iftSICLE));
+	assert(sicle != NULL);
+
+	sicle->mimg = NULL; sicle->feats = NULL; sicle->sal = NULL; 
+	sicle->roi = NULL; sicle->ws = NULL; sicle->scratch_dir = NULL;
+	sicle->carried_seeds = NULL; sicle->pinned = NULL;
+	iftSICLE_SetInputs(sicle, img, objsm, mask);
+
+	return sicle;
+}
+
+iftSICLE *iftCreateMappedSICLE
+(iftMImage *mimg, iftImage *objsm, iftImage *mask, const char *scratch_dir)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(mimg != NULL); assert(scratch_dir != NULL);
+	#endif //-------------------------------------------------------------------|
+	iftSICLE *sicle;
+
+	if(iftDirExists(scratch_dir) == false)
+	{ iftError("The scratch directory %s does not exist", __func__, scratch_dir); }
+	if((objsm != NULL && objsm->n != mimg->n) || (mask != NULL && mask->n != mimg->n))
+	{ iftError("The maps' domains differ from the features'", __func__); }
+
+	sicle = malloc(sizeof(iftSICLE));
+	assert(sicle != NULL);
+
+	sicle->mimg = mimg; 
+	sicle->feats = NULL; // The SIMD copy would double the features' footprint
+	sicle->sal = NULL; sicle->roi = NULL; sicle->ws = NULL;
+	sicle->carried_seeds = NULL; sicle->pinned = NULL;
+	sicle->scratch_dir = iftCopyString("%s", scratch_dir);
+	iftSICLE_SetMaps(sicle, objsm, mask);
+
+	return sicle;
+}
+
+void iftUpdateSICLE
+(iftSICLE *sicle, iftImage *img, iftImage *objsm, iftImage *mask)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL); assert(img != NULL);
+	if(objsm != NULL) { iftVerifyImageDomains(img, objsm, __func__); }
+	if(mask != NULL) { iftVerifyImageDomains(img, mask, __func__); }
+	#endif //-------------------------------------------------------------------|
+	if(img->xsize != sicle->mimg->xsize || img->ysize != sicle->mimg->ysize ||
+		 img->zsize != sicle->mimg->zsize)
+	{ iftError("The image's domain differs from the prototype's", __func__); }
+	if(sicle->scratch_dir != NULL)
+	{ iftError("Out-of-core prototypes cannot be updated", __func__); }
+
+	iftSICLE_SetInputs(sicle, img, objsm, mask);
+}
+
+void iftDestroySICLE
+(iftSICLE **sicle)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL);
+	#endif //-------------------------------------------------------------------|
+	if((*sicle) != NULL)
+	{
+		if((*sicle)->ws != NULL) { iftSICLE_DestroyIFTData(&((*sicle)->ws)); }
+		if((*sicle)->sal != NULL) 
+		{ 
+			iftSICLE_FreeMap((*sicle)->scratch_dir != NULL, (*sicle)->sal,
+											 (*sicle)->mimg->n * sizeof(float)); 
+		}
+		iftDestroyMImage(&((*sicle)->mimg));
+		if((*sicle)->feats != NULL) { free((*sicle)->feats); }
+		if((*sicle)->roi != NULL) iftDestroyBMap(&((*sicle)->roi));
+		if((*sicle)->scratch_dir != NULL) { free((*sicle)->scratch_dir); }
+		if((*sicle)->carried_seeds != NULL) 
+		{ iftDestroyIntArray(&((*sicle)->carried_seeds)); }
+		if((*sicle)->pinned != NULL) { iftDestroyBMap(&((*sicle)->pinned)); }
+		free(*sicle);
+		(*sicle) = NULL;
+	}
+}
+
+//============================================================================|
+// Runner
+//============================================================================|
+void iftVerifySICLEArgs
+(iftSICLE *sicle, iftSICLEArgs *args)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL); assert(args != NULL);
+	#endif //-------------------------------------------------------------------|
+	int num_vtx;
+
+	if(sicle->roi == NULL) { num_vtx = sicle->mimg->n; }
+	else
+	{
+		num_vtx = 0;
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for
+		#endif //-----------------------------------------------------------------|
+		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
+		{ if(iftBMapValue(sicle->roi, v_index) == true) { num_vtx++; } }
+	}
+
+	if(args->n0 >= num_vtx || args->n0 <= 2)
+	{ 
+		iftError("Invalid N0 value of %d. It must be within ]2,%d[\n", __func__,
+							args->n0, num_vtx); 
+	}
+
+	if(args->nf >= args->n0)
+	{ 
+		iftError("Invalid Nf value of %d. It must be within [2,%d[\n", __func__,
+							args->nf, args->n0); 
+	}
+
+	if(args->max_iters < 2)
+	{
+		iftError("Invalid quantity of %d iterations. It must be >= 2\n", __func__,
+							args->max_iters); 	
+	}
+
+	if(args->irreg < 0.0)
+	{
+		iftError("Invalid irregularity value of %f. It must be >= 0\n", __func__,
+							args->irreg); 	
+	}
+
+	if(args->adhr < 0)
+	{
+		iftError("Invalid boundary adherence value of %f. It must be >= 0\n", 
+							__func__, args->adhr); 	
+	}
+
+	if(args->alpha < 0.0)
+	{
+		iftError("Invalid boosting factor of %f. It must be within [0,1]\n", 
+							__func__, args->alpha); 	
+	}
+
+	if(args->user_ni != NULL)
+	{
+		if(args->user_ni->val[0] >= args->n0 || 
+			args->user_ni->val[args->user_ni->n - 1] <= args->nf)
+		{
+			iftError("intermediary values must be within ]N0,...,Ni,...,Nf[\n",
+							__func__);	
+		}
+		for(long i = 1; i < args->user_ni->n; ++i)
+		{
+			if(args->user_ni->val[i-1] <= args->user_ni->val[i])
+			{
+				iftError("Ni values must be strictly decreasing\n",__func__); 	
+			}
+		}
+	}
+	if(args->nf_targets != NULL)
+	{
+		for(long i = 0; i < args->nf_targets->n; ++i)
+		{
+			if(args->nf_targets->val[i] < args->nf || 
+				 args->nf_targets->val[i] >= args->n0)
+			{
+				iftError("Invalid Nf target of %d. It must be within [%d,%d[\n", 
+								 __func__, args->nf_targets->val[i], args->nf, args->n0);
+			}
+			if(i > 0 && args->nf_targets->val[i-1] <= args->nf_targets->val[i])
+			{
+				iftError("Nf targets must be strictly decreasing\n",__func__);
+			}
+		}
+	}
+	if(sicle->sal == NULL && args->penopt != IFT_SICLE_PEN_NONE)
+	{
+		iftError("Penalization cannot be used without a saliency map\n",
+							__func__); 	
+	}
+
+	if(args->tile_size < 0)
+	{
+		iftError("Invalid tile size of %d. It must be >= 0\n", __func__,
+							args->tile_size);
+	}
+
+	if(args->use_bqueue == true)
+	{
+		#ifdef IFT_COMPACT //-----------------------------------------------------|
+		iftError("Bucket queue is unavailable in the compact build\n", __func__);
+		#endif //-----------------------------------------------------------------|
+		if(args->connopt != IFT_SICLE_CONN_FMAX)
+		{
+			iftError("Bucket queue can only be used with the Fmax connectivity\n",
+								__func__);
+		}
+		if(args->num_buckets < 2)
+		{
+			iftError("Invalid quantity of %d buckets. It must be >= 2\n", __func__,
+								args->num_buckets);
+		}
+		if(sicle->scratch_dir != NULL)
+		{
+			iftError("Bucket queue is unavailable for out-of-core prototypes\n",
+								__func__);
+		}
+	}
+			
+}
+
+iftImage *iftRunSICLE
+(iftSICLE *sicle, iftSICLEArgs *args)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL);
+	if(args != NULL) { iftVerifySICLEArgs(sicle,args); }
+	#endif //-------------------------------------------------------------------|
+	bool default_args;
+	iftSICLE_IFTData *data;
+	iftImage *segm;
+
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
+
+	data = iftSICLE_AcquireIFTData(sicle, args); // Owned by the prototype
+	iftSICLE_RunIterations(sicle, args, data, NULL, NULL);
+	segm = iftSICLE_CreateLabelImage(sicle, data);
+
+	if(default_args) { iftDestroySICLEArgs(&args); }
+	return segm;
+}
+
+iftImage **iftRunMultiscaleSICLE
+(iftSICLE *sicle, iftSICLEArgs *args, int *num_scales)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL);
+	if(args != NULL) { iftVerifySICLEArgs(sicle,args); }
+	#endif //-------------------------------------------------------------------|
+	bool default_args;
+	iftSICLE_IFTData *data;
+	iftIntArray *ni;
+	iftImage **segm;
+
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
+
+	data = iftSICLE_AcquireIFTData(sicle, args); // Owned by the prototype
+	ni = iftSICLE_CreateNiArray(args, data);
+	segm = calloc(ni->n, sizeof(iftImage*));
+	assert(segm != NULL);
+	iftDestroyIntArray(&ni);
+
+	(*num_scales) = iftSICLE_RunIterations(sicle, args, data, 
+																				 iftSICLE_StoreScale, segm);
+
+	if(default_args) { iftDestroySICLEArgs(&args); }
+	return segm;
+}
+
+int iftRunEmittedMultiscaleSICLE
+(iftSICLE *sicle, iftSICLEArgs *args, bool in_parallel, 
+ iftSICLEScaleFunc emit, void *user_data)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL); assert(emit != NULL);
+	if(args != NULL) { iftVerifySICLEArgs(sicle,args); }
+	#endif //-------------------------------------------------------------------|
+	bool default_args;
+	int num_scales;
+	iftSICLE_IFTData *data;
+	iftSICLE_ScaleSink sink;
+
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
+
+	sink.emit = emit; sink.user_data = user_data; sink.in_parallel = in_parallel;
+	sink.is_done = sink.is_busy = false; sink.scale = -1; sink.label_img = NULL;
+	if(in_parallel == true)
+	{
+		pthread_mutex_init(&(sink.lock), NULL);
+		pthread_cond_init(&(sink.cond), NULL);
+		if(pthread_create(&(sink.writer), NULL, iftSICLE_RunScaleWriter, 
+											&sink) != 0)
+		{ iftError("Could not create the writer thread", __func__); }
+	}
+
+	data = iftSICLE_AcquireIFTData(sicle, args); // Owned by the prototype
+	num_scales = iftSICLE_RunIterations(sicle, args, data, iftSICLE_EmitScale, 
+																			&sink);
+
+	if(in_parallel == true) // Waits for the last scale
+	{
+		pthread_mutex_lock(&(sink.lock));
+		sink.is_done = true;
+		pthread_cond_broadcast(&(sink.cond));
+		pthread_mutex_unlock(&(sink.lock));
+		pthread_join(sink.writer, NULL);
+		pthread_cond_destroy(&(sink.cond));
+		pthread_mutex_destroy(&(sink.lock));
+	}
+
+	if(default_args) { iftDestroySICLEArgs(&args); }
+	return num_scales;
+}
+
+iftImage **iftRunMultiTargetSICLE
+(iftSICLE *sicle, iftSICLEArgs *args)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL); assert(args != NULL);
+	iftVerifySICLEArgs(sicle,args);
+	#endif //-------------------------------------------------------------------|
+	iftSICLE_IFTData *data;
+	iftIntArray *ni;
+	iftSICLE_Targets targets;
+
+	if(args->nf_targets == NULL || args->nf_targets->n < 1)
+	{ iftError("No Nf targets were given", __func__); }
+
+	data = iftSICLE_AcquireIFTData(sicle, args); // Owned by the prototype
+	ni = iftSICLE_CreateNiArray(args, data);
+
+	targets.num_targets = args->nf_targets->n;
+	targets.scale = malloc(targets.num_targets * sizeof(int));
+	assert(targets.scale != NULL);
+	targets.segm = calloc(targets.num_targets, sizeof(iftImage*));
+	assert(targets.segm != NULL);
+	for(long i = 0; i < targets.num_targets; ++i)
+	{
+		int scale;
+
+		scale = 0;
+		while(ni->val[scale] > args->nf_targets->val[i]) { ++scale; }
+		targets.scale[i] = scale;
+	}
+	iftDestroyIntArray(&ni);
+
+	iftSICLE_RunIterations(sicle, args, data, iftSICLE_StoreTargets, &targets);
+
+	free(targets.scale);
+	return targets.segm;
+}
+
+void iftRunStreamingSICLE
+(const iftFileSet *frames, iftSICLEArgs *args, int window_size, int overlap,
+ iftSICLEFrameFunc emit, void *user_data)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(frames != NULL); assert(emit != NULL);
+	#endif //-------------------------------------------------------------------|
+	bool default_args, is_last;
+	int start, prev_start, num_emitted, next_label, slice_size;
+	int *ring_id;
+	iftImage **ring, *volume, *prev_glob;
+	iftIntArray *carried;
+	iftBMap *pinned;
+	iftSICLE *sicle;
+
+	if(frames->n < 1) { iftError("No frames were given", __func__); }
+	if(window_size < 1)
+	{
+		iftError("Invalid window size of %d frames. It must be >= 1", __func__,
+						 window_size);
+	}
+	if(overlap < 0 || overlap >= window_size)
+	{
+		iftError("Invalid overlap of %d frames. It must be within [0,%d[", 
+						 __func__, overlap, window_size);
+	}
+
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
+
+	window_size = iftMin(window_size, frames->n);
+	ring = calloc(window_size, sizeof(iftImage*));
+	ring_id = malloc(window_size * sizeof(int));
+	assert(ring != NULL); assert(ring_id != NULL);
+	for(int slot = 0; slot < window_size; ++slot) { ring_id[slot] = IFT_NIL; }
+
+	sicle = NULL; volume = prev_glob = NULL; carried = NULL; pinned = NULL;
+	start = prev_start = num_emitted = 0; next_label = 1; 
+	do
+	{
+		int next_start, *glob;
+		iftImage *segm;
+
+		iftSICLE_LoadWindow(frames, start, window_size, ring, ring_id, &volume);
+		if(sicle == NULL) // Same-sized windows reuse the prototype
+		{ sicle = iftCreateSICLE(volume, NULL, NULL); iftVerifySICLEArgs(sicle, args); }
+		else { iftUpdateSICLE(sicle, volume, NULL, NULL); }
+		sicle->carried_seeds = carried; carried = NULL;
+		sicle->pinned = pinned; pinned = NULL;
+
+		segm = iftRunSICLE(sicle, args);
+		if(sicle->pinned != NULL) { iftDestroyBMap(&(sicle->pinned)); }
+		glob = iftSICLE_MatchWindowLabels(segm, start, prev_glob, prev_start,
+																			&next_label);
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for
+		#endif //-----------------------------------------------------------------|
+		for(int v_index = 0; v_index < segm->n; ++v_index)
+		{ segm->val[v_index] = glob[segm->val[v_index]]; }
+		free(glob);
+		if(prev_glob != NULL) // Keeps the shared frames' labels across the seam
+		{ iftSICLE_PinSharedFrames(sicle, args, start, prev_glob, prev_start, 1, segm); }
+
+		// The last window is shifted back for keeping the window size
+		is_last = (start + window_size == frames->n);
+		if(is_last == true) { next_start = frames->n; }
+		else 
+		{ next_start = iftMin(start + window_size - overlap, frames->n - window_size); }
+
+		for(; num_emitted < next_start; ++num_emitted) // Finalized frames
+		{
+			iftImage *label_frame;
+
+			label_frame = iftGetXYSlice(segm, num_emitted - start);
+			emit(label_frame, num_emitted, user_data);
+			iftDestroyImage(&label_frame);
+		}
+
+		if(is_last == false) // Pins a seed per superspel of the shared frames
+		{
+			int shift;
+			iftImage *shared;
+
+			slice_size = segm->xsize * segm->ysize;
+			shift = (next_start - start) * slice_size;
+			shared = iftCreateImage(segm->xsize, segm->ysize, 
+															start + segm->zsize - next_start);
+			memcpy(shared->val, segm->val + shift, shared->n * sizeof(int));
+			carried = iftLabelsToSICLESeeds(shared);
+			iftDestroyImage(&shared);
+
+			pinned = iftCreateBMap(segm->n);
+			for(long i = 0; i < carried->n; ++i) { iftBMapSet1(pinned, carried->val[i]); }
+		}
+
+		if(prev_glob != NULL) { iftDestroyImage(&prev_glob); }
+		prev_glob = segm; prev_start = start;
+		start = next_start;
+	} while(is_last == false);
+
+	for(int slot = 0; slot < window_size; ++slot)
+	{ if(ring[slot] != NULL) { iftDestroyImage(&(ring[slot])); } }
+	free(ring); free(ring_id);
+	iftDestroyImage(&prev_glob);
+	iftDestroyImage(&volume);
+	iftDestroySICLE(&sicle);
+	if(default_args) { iftDestroySICLEArgs(&args); }
+}
+
+void iftRunTiledSICLE
+(const char *img_path, iftSICLEArgs *args, int tile_size, int overlap,
+ int global_nf, bool in_parallel, iftSICLETileFunc emit, void *user_data)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(img_path != NULL); assert(emit != NULL);
+	#endif //-------------------------------------------------------------------|
+	bool default_args;
+	int num_tiles, batch_size, next_label;
+	int *top, *next_top, *left;
+	long img_area;
+	iftImageDomain dom;
+	iftSICLE **sicle;
+	iftImage **segm;
+
+	if(tile_size < 2)
+	{
+		iftError("Invalid tile size of %d. It must be >= 2", __func__, tile_size);
+	}
+	if(overlap < 0 || overlap >= tile_size)
+	{
+		iftError("Invalid overlap of %d. It must be within [0,%d[", __func__, 
+						 overlap, tile_size);
+	}
+	if(global_nf < 0)
+	{
+		iftError("Invalid global quantity of %d superspels. It must be >= 0",
+						 __func__, global_nf);
+	}
+
+	dom = iftReadImageDomain(img_path);
+	if(dom.zsize != 1) { iftError("Only 2D images are supported", __func__); }
+	img_area = (long)dom.xsize * dom.ysize;
+	num_tiles = ((dom.xsize + tile_size - 1) / tile_size) * 
+							((dom.ysize + tile_size - 1) / tile_size);
+
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
+
+	top = next_top = left = NULL;
+	if(overlap > 0)
+	{
+		top = calloc(overlap * dom.xsize, sizeof(int));
+		next_top = calloc(overlap * dom.xsize, sizeof(int));
+		left = calloc(overlap * tile_size, sizeof(int));
+		assert(top != NULL); assert(next_top != NULL); assert(left != NULL);
+	}
+
+	batch_size = 1;
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	if(in_parallel == true) { batch_size = omp_get_max_threads(); }
+	#else //--------------------------------------------------------------------|
+	(void)in_parallel;
+	#endif //-------------------------------------------------------------------|
+	sicle = calloc(batch_size, sizeof(iftSICLE*));
+	segm = calloc(batch_size, sizeof(iftImage*));
+	assert(sicle != NULL); assert(segm != NULL);
+
+	next_label = 1;
+	for(int first = 0; first < num_tiles; first += batch_size)
+	{
+		int last;
+
+		last = iftMin(first + batch_size, num_tiles) - 1;
+
+		// Segments a batch of tiles independently
+		#ifdef IFT_OMP //---------------------------------------------------------|
+		#pragma omp parallel for schedule(dynamic)
+		#endif //-----------------------------------------------------------------|
+		for(int k = first; k <= last; ++k)
+		{
+			iftBoundingBox core, ext;
+			iftSICLEArgs targs;
+			iftImage *tile;
+
+			iftSICLE_CalcTileBoxes(dom, tile_size, overlap, k, &core, &ext);
+			tile = iftReadImageRegion(img_path, ext);
+
+			sicle[k - first] = iftCreateSICLE(tile, NULL, NULL);
+			if(iftSICLE_SetTileArgs(args, tile->n, img_area, global_nf, &targs))
+			{
+				iftVerifySICLEArgs(sicle[k - first], &targs);
+				segm[k - first] = iftRunSICLE(sicle[k - first], &targs);
+
+				// Only the features are needed for stitching
+				iftSICLE_DestroyIFTData(&(sicle[k - first]->ws));
+			}
+			else // Too small: a single superspel, merged by the stitching
+			{
+				segm[k - first] = iftCreateImage(tile->xsize, tile->ysize, 1);
+				iftSetImage(segm[k - first], 1);
+			}
+			iftDestroyImage(&tile);
+		}
+
+		// Stitches and emits them in raster order
+		for(int k = first; k <= last; ++k)
+		{
+			iftBoundingBox core, ext;
+			iftImage *label_tile;
+
+			iftSICLE_CalcTileBoxes(dom, tile_size, overlap, k, &core, &ext);
+			iftSICLE_StitchTile(sicle[k - first], args, dom, overlap, core, ext,
+													top, left, next_top, &next_label, segm[k - first]);
+
+			label_tile = iftCreateImage(core.end.x - core.begin.x + 1, 
+																	core.end.y - core.begin.y + 1, 1);
+			for(int y = core.begin.y; y <= core.end.y; ++y)
+			{
+				for(int x = core.begin.x; x <= core.end.x; ++x)
+				{
+					label_tile->val[x - core.begin.x + label_tile->tby[y - core.begin.y]] =
+						segm[k - first]->val[x - ext.begin.x + 
+																 segm[k - first]->tby[y - ext.begin.y]];
+				}
+			}
+			emit(label_tile, core.begin.x, core.begin.y, user_data);
+
+			iftDestroyImage(&label_tile);
+			iftDestroyImage(&(segm[k - first]));
+			iftDestroySICLE(&(sicle[k - first]));
+
+			if(core.end.x == dom.xsize - 1 && overlap > 0) // End of a row?
+			{ int *tmp = top; top = next_top; next_top = tmp; }
+		}
+	}
+
+	free(sicle); free(segm);
+	if(top != NULL) { free(top); free(next_top); free(left); }
+	if(default_args) { iftDestroySICLEArgs(&args); }
+}
+
+//============================================================================|
+// Hierarchy
+//============================================================================|
+iftSICLEHierarchy *iftRunHierarchicalSICLE
+(iftSICLE *sicle, iftSICLEArgs *args)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL);
+	if(args != NULL) { iftVerifySICLEArgs(sicle,args); }
+	#endif //-------------------------------------------------------------------|
+	bool default_args;
+	iftSICLE_IFTData *data;
+	iftIntArray *ni;
+	iftSICLEHierarchy *hier;
+
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
+
+	data = iftSICLE_AcquireIFTData(sicle, args); // Owned by the prototype
+	ni = iftSICLE_CreateNiArray(args, data);
+	hier = iftSICLE_CreateHierarchy(ni->n);
+	iftDestroyIntArray(&ni);
+
+	iftSICLE_RunIterations(sicle, args, data, iftSICLE_AddHierarchyScale, hier);
+
+	if(default_args) { iftDestroySICLEArgs(&args); }
+	return hier;
+}
+
+void iftDestroySICLEHierarchy
+(iftSICLEHierarchy **hier)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(hier != NULL);
+	#endif //-------------------------------------------------------------------|
+	if((*hier) != NULL)
+	{
+		for(int i = 0; i < (*hier)->num_scales; ++i)
+		{
+			if((*hier)->parent[i] != NULL) 
+			{ iftDestroyIntArray(&((*hier)->parent[i])); }
+			if((*hier)->exc_index[i] != NULL) 
+			{ iftDestroyIntArray(&((*hier)->exc_index[i])); }
+			if((*hier)->exc_label[i] != NULL) 
+			{ iftDestroyIntArray(&((*hier)->exc_label[i])); }
+		}
+		if((*hier)->finest != NULL) { iftDestroyImage(&((*hier)->finest)); }
+		free((*hier)->parent); free((*hier)->exc_index); 
+		free((*hier)->exc_label);
+
+		free(*hier);
+		(*hier) = NULL;
+	}
+}
+
+iftImage *iftGetSICLEHierarchyScale
+(const iftSICLEHierarchy *hier, int scale)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(hier != NULL);
+	#endif //-------------------------------------------------------------------|
+	const iftIntArray *parent, *exc_index, *exc_label;
+	iftImage *label_img;
+
+	if(scale < 0 || scale >= hier->num_scales)
+	{ 
+		iftError("Invalid scale %d. It must be within [0,%d]", __func__, scale,
+						 hier->num_scales - 1);
+	}
+	if(scale == 0) { return iftCopyImage(hier->finest); }
+
+	parent = hier->parent[scale];
+	exc_index = hier->exc_index[scale]; exc_label = hier->exc_label[scale];
+	label_img = iftCreateImage(hier->finest->xsize, hier->finest->ysize,
+														 hier->finest->zsize);
+	#ifdef IFT_OMP //-----------------------------------------------------------|
+	#pragma omp parallel for
+	#endif //-------------------------------------------------------------------|
+	for(int v_index = 0; v_index < label_img->n; ++v_index)
+	{ label_img->val[v_index] = parent->val[hier->finest->val[v_index]]; }
+	for(long i = 0; i < exc_index->n; ++i)
+	{ label_img->val[exc_index->val[i]] = exc_label->val[i]; }
+
+	return label_img;
+}
+
+void iftWriteSICLEHierarchy
+(const iftSICLEHierarchy *hier, const char *path)
 {
 	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	assert(img != NULL);
-	if(objsm != NULL) { iftVerifyImageDomains(img, objsm, __func__); }
-	if(mask != NULL) { iftVerifyImageDomains(img, mask, __func__); }
+	assert(hier != NULL); assert(path != NULL);
 	#endif //-------------------------------------------------------------------|
-	iftSICLE *sicle;
-
-	sicle = malloc(sizeof(iftSICLE));
-	assert(sicle != NULL);
+	FILE *fp;
 
-	if(iftIsColorImage(img)) 
-	{ sicle->mimg = iftImageToMImage(img, LAB_CSPACE); }
-	else { sicle->mimg = iftImageToMImage(img, GRAY_CSPACE); }
-	
-	if(mask != NULL) { sicle->roi = iftBinImageToBMap(mask); }
-	else { sicle->roi = NULL; }
+	fp = fopen(path, "wb");
+	if(fp == NULL) { iftError("Cannot open file: \"%s\"", __func__, path); }
 
-	if(objsm != NULL)
+	fprintf(fp, "SHR\n%d %d %d %d\n", hier->finest->xsize, hier->finest->ysize,
+					hier->finest->zsize, hier->num_scales);
+	fwrite(hier->finest->val, sizeof(int), hier->finest->n, fp);
+	for(int i = 1; i < hier->num_scales; ++i)
 	{
-		int max_sal;
-
-		sicle->sal = calloc(sicle->mimg->n, sizeof(float));
-		assert(sicle->sal);
-
-		max_sal = 0;
-		#ifdef IFT_OMP //---------------------------------------------------------|
-		#pragma omp parallel for reduction(+:max_sal)
-		#endif //-----------------------------------------------------------------|
-		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
-		{ max_sal = iftMax(max_sal, objsm->val[v_index]); }
+		const iftIntArray *arrs[3] = {hier->parent[i], hier->exc_index[i], 
+																	hier->exc_label[i]};
 
-		#ifdef IFT_OMP //---------------------------------------------------------|
-		#pragma omp parallel for
-		#endif //-----------------------------------------------------------------|
-		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
-		{ sicle->sal[v_index] = (float)objsm->val[v_index]/max_sal; } // Norm [0,1]
+		for(int j = 0; j < 3; ++j)
+		{
+			fwrite(&(arrs[j]->n), sizeof(long), 1, fp);
+			fwrite(arrs[j]->val, sizeof(int), arrs[j]->n, fp);
+		}
 	}
-	else { sicle->sal = NULL; }
-
-	return sicle;
+	fclose(fp);
 }
 
-void iftDestroySICLE
-(iftSICLE **sicle)
+iftSICLEHierarchy *iftReadSICLEHierarchy
+(const char *path)
 {
 	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	assert(sicle != NULL);
+	assert(path != NULL);
 	#endif //-------------------------------------------------------------------|
-	if((*sicle) != NULL)
+	bool is_valid;
+	int xsize, ysize, zsize, num_scales;
+	FILE *fp;
+	iftSICLEHierarchy *hier;
+
+	fp = fopen(path, "rb");
+	if(fp == NULL) { iftError("Cannot open file: \"%s\"", __func__, path); }
+
+	if(fscanf(fp, "SHR %d %d %d %d", &xsize, &ysize, &zsize, &num_scales) != 4 
+		 || fgetc(fp) != '\n' || num_scales < 1 || xsize < 1 || ysize < 1 || 
+		 zsize < 1)
+	{ iftError("Invalid SICLE hierarchy file: \"%s\"", __func__, path); }
+
+	hier = iftSICLE_CreateHierarchy(num_scales);
+	hier->finest = iftCreateImage(xsize, ysize, zsize);
+	is_valid = fread(hier->finest->val, sizeof(int), hier->finest->n, fp) 
+						 == (size_t)hier->finest->n;
+	for(int i = 1; i < num_scales && is_valid; ++i)
 	{
-		iftDestroyMImage(&((*sicle)->mimg));
-		if((*sicle)->sal != NULL) { free((*sicle)->sal); }
-		if((*sicle)->roi != NULL) iftDestroyBMap(&((*sicle)->roi));
-		free(*sicle);
-		(*sicle) = NULL;
+		iftIntArray **arrs[3] = {&(hier->parent[i]), &(hier->exc_index[i]), 
+														 &(hier->exc_label[i])};
+
+		for(int j = 0; j < 3 && is_valid; ++j)
+		{
+			long n;
+
+			// No table is longer than the spels (or their labels, counting 0)
+			is_valid = fread(&n, sizeof(long), 1, fp) == 1 && n >= 0 && 
+								 n <= hier->finest->n + 1;
+			if(is_valid)
+			{
+				(*arrs[j]) = iftCreateIntArray(n);
+				is_valid = fread((*arrs[j])->val, sizeof(int), n, fp) == (size_t)n;
+			}
+		}
+	}
+	fclose(fp);
+	if(!is_valid) 
+	{ iftError("Truncated SICLE hierarchy file: \"%s\"", __func__, path); }
+
+	// The tables must be indexable by the finest labels and spels
+	is_valid = iftMinimumValue(hier->finest) >= 0;
+	for(int i = 1; i < num_scales && is_valid; ++i)
+	{
+		is_valid = hier->parent[i]->n > iftMaximumValue(hier->finest) &&
+							 hier->exc_index[i]->n == hier->exc_label[i]->n;
+		for(long j = 0; j < hier->exc_index[i]->n && is_valid; ++j)
+		{ 
+			is_valid = hier->exc_index[i]->val[j] >= 0 && 
+								 hier->exc_index[i]->val[j] < hier->finest->n; 
+		}
 	}
+	if(!is_valid) 
+	{ iftError("Corrupted SICLE hierarchy file: \"%s\"", __func__, path); }
+
+	return hier;
 }
 
 //============================================================================|
-// Runner
+// Warm Start
 //============================================================================|
-void iftVerifySICLEArgs
-(iftSICLE *sicle, iftSICLEArgs *args)
+iftImage *iftRunWarmSICLE
+(iftSICLE *sicle, iftSICLEArgs *args, const iftIntArray *prior_seeds, 
+ int num_extra)
 {
 	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	assert(sicle != NULL); assert(args != NULL);
+	assert(sicle != NULL);
 	#endif //-------------------------------------------------------------------|
-	int num_vtx;
+	bool default_args;
+	iftSICLEArgs warm_args;
+	iftSICLE_IFTData *data;
+	iftImage *segm;
 
-	if(sicle->roi == NULL) { num_vtx = sicle->mimg->n; }
-	else
-	{
-		num_vtx = 0;
-		#ifdef IFT_OMP //---------------------------------------------------------|
-		#pragma omp parallel for
-		#endif //-----------------------------------------------------------------|
-		for(int v_index = 0; v_index < sicle->mimg->n; ++v_index)
-		{ if(iftBMapValue(sicle->roi, v_index) == true) { num_vtx++; } }
-	}
+	if(num_extra < 0)
+	{ iftError("Invalid quantity of %d extra seeds. It must be >= 0", __func__,
+						 num_extra); }
 
-	if(args->n0 >= num_vtx || args->n0 <= 2)
-	{ 
-		iftError("Invalid N0 value of %d. It must be within ]2,%d[\n", __func__,
-							args->n0, num_vtx); 
-	}
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
 
-	if(args->nf >= args->n0)
-	{ 
-		iftError("Invalid Nf value of %d. It must be within [2,%d[\n", __func__,
-							args->nf, args->n0); 
-	}
+	warm_args = (*args);
+	warm_args.n0 = num_extra; // The prior seeds replace most of the N0 ones
+	warm_args.user_ni = NULL; // The schedule is shorter
 
-	if(args->max_iters < 2)
+	if(sicle->carried_seeds != NULL) { iftDestroyIntArray(&(sicle->carried_seeds)); }
+	if(prior_seeds != NULL) // Joined first at the sampling
 	{
-		iftError("Invalid quantity of %d iterations. It must be >= 2\n", __func__,
-							args->max_iters); 	
+		sicle->carried_seeds = iftCreateIntArray(prior_seeds->n);
+		memcpy(sicle->carried_seeds->val, prior_seeds->val, 
+					 prior_seeds->n * sizeof(int));
 	}
 
-	if(args->irreg < 0.0)
-	{
-		iftError("Invalid irregularity value of %f. It must be >= 0\n", __func__,
-							args->irreg); 	
-	}
+	data = iftSICLE_AcquireIFTData(sicle, &warm_args); // Owned by the prototype
+	iftSICLE_TopUpSeeds(sicle, data, warm_args.nf + 1);
 
-	if(args->adhr < 0)
-	{
-		iftError("Invalid boundary adherence value of %f. It must be >= 0\n", 
-							__func__, args->adhr); 	
-	}
+	iftSICLE_RunIterations(sicle, &warm_args, data, NULL, NULL);
+	segm = iftSICLE_CreateLabelImage(sicle, data);
 
-	if(args->alpha < 0.0)
+	if(default_args) { iftDestroySICLEArgs(&args); }
+	return segm;
+}
+
+iftIntArray *iftLabelsToSICLESeeds
+(iftImage *label_img)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(label_img != NULL);
+	#endif //-------------------------------------------------------------------|
+	int max_label, num_seeds;
+	int *size, *best;
+	float *best_dist;
+	double *centr;
+	iftIntArray *seeds;
+
+	max_label = iftMaximumValue(label_img);
+	size = calloc(max_label + 1, sizeof(int));
+	assert(size != NULL);
+	best = malloc((max_label + 1) * sizeof(int));
+	assert(best != NULL);
+	best_dist = malloc((max_label + 1) * sizeof(float));
+	assert(best_dist != NULL);
+	centr = calloc(3 * (max_label + 1), sizeof(double));
+	assert(centr != NULL);
+
+	for(int p_index = 0; p_index < label_img->n; ++p_index)
 	{
-		iftError("Invalid boosting factor of %f. It must be within [0,1]\n", 
-							__func__, args->alpha); 	
+		int label;
+		iftVoxel p_voxel;
+
+		label = label_img->val[p_index];
+		if(label <= 0) { continue; } // Background
+		p_voxel = iftGetVoxelCoord(label_img, p_index);
+		size[label]++;
+		centr[3 * label] += p_voxel.x; centr[3 * label + 1] += p_voxel.y;
+		centr[3 * label + 2] += p_voxel.z;
 	}
 
-	if(args->user_ni != NULL)
+	for(int l = 1; l <= max_label; ++l) 
 	{
-		if(args->user_ni->val[0] >= args->n0 || 
-			args->user_ni->val[args->user_ni->n - 1] <= args->nf)
-		{
-			iftError("intermediary values must be within ]N0,...,Ni,...,Nf[\n",
-							__func__);	
-		}
-		for(long i = 1; i < args->user_ni->n; ++i)
-		{
-			if(args->user_ni->val[i-1] <= args->user_ni->val[i])
-			{
-				iftError("Ni values must be strictly decreasing\n",__func__); 	
-			}
-		}
+		best[l] = IFT_NIL; best_dist[l] = IFT_INFINITY_FLT;
+		if(size[l] > 0) 
+		{ for(int c = 0; c < 3; ++c) { centr[3 * l + c] /= size[l]; } }
 	}
-	if(sicle->sal == NULL && args->penopt != IFT_SICLE_PEN_NONE)
+
+	// The superspel's spel nearest to its centroid
+	for(int p_index = 0; p_index < label_img->n; ++p_index)
 	{
-		iftError("Penalization cannot be used without a saliency map\n",
-							__func__); 	
+		int label;
+		float dist;
+		iftVoxel p_voxel;
+
+		label = label_img->val[p_index];
+		if(label <= 0) { continue; }
+		p_voxel = iftGetVoxelCoord(label_img, p_index);
+		dist = (p_voxel.x - centr[3 * label]) * (p_voxel.x - centr[3 * label]) +
+					 (p_voxel.y - centr[3 * label + 1]) * (p_voxel.y - centr[3 * label + 1]) +
+					 (p_voxel.z - centr[3 * label + 2]) * (p_voxel.z - centr[3 * label + 2]);
+		if(dist < best_dist[label]) { best_dist[label] = dist; best[label] = p_index; }
 	}
-			
+
+	num_seeds = 0;
+	for(int l = 1; l <= max_label; ++l) { num_seeds += size[l] > 0; }
+	seeds = iftCreateIntArray(num_seeds);
+	num_seeds = 0;
+	for(int l = 1; l <= max_label; ++l)
+	{ if(size[l] > 0) { seeds->val[num_seeds++] = best[l]; } }
+
+	free(size); free(best); free(best_dist); free(centr);
+	return seeds;
 }
 
-iftImage *iftRunSICLE
-(iftSICLE *sicle, iftSICLEArgs *args)
+//============================================================================|
+// Seed Edition
+//============================================================================|
+iftIntArray *iftGetSICLESeeds
+(iftSICLE *sicle)
 {
 	#ifdef IFT_DEBUG //---------------------------------------------------------|
 	assert(sicle != NULL);
-	if(args != NULL) { iftVerifySICLEArgs(sicle,args); }
+	#endif //-------------------------------------------------------------------|
+	iftIntArray *seeds;
+
+	if(sicle->ws == NULL) { return NULL; }
+
+	seeds = iftCreateIntArray(sicle->ws->seeds->n);
+	memcpy(seeds->val, sicle->ws->seeds->val, seeds->n * sizeof(int));
+
+	return seeds;
+}
+
+iftBoundingBox iftAddSICLESeed
+(iftSICLE *sicle, iftSICLEArgs *args, iftVoxel vxl, iftImage *label_img)
+{
+	#ifdef IFT_DEBUG //---------------------------------------------------------|
+	assert(sicle != NULL); assert(label_img != NULL);
 	#endif //-------------------------------------------------------------------|
 	bool default_args;
+	int s_index, max_label;
+	iftBoundingBox bb;
+	iftIntArray *seeds;
 	iftSICLE_IFTData *data;
-	iftSet *irre_seeds;
-	iftIntArray *ni;
-	iftImage *segm;
 
 	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
 	else { default_args = false; }
 
-	data = iftSICLE_CreateIFTData(sicle, args);
-	ni = iftSICLE_CreateNiArray(args, data);
+	data = iftSICLE_BeginSeedEdit(sicle, args, label_img, __func__);
+	s_index = iftSICLE_GetNewSeed(sicle, data, vxl, __func__);
 
-	irre_seeds = NULL;
-  for(int it = 1; it < ni->n; ++it)
-  {
-  	#ifdef IFT_DEBUG //-------------------------------------------------------|
-		fprintf(stderr, "DEBUG (%s): Iteration %d\n", __func__, it);
-		#endif //-----------------------------------------------------------------|	
-		if(args->use_dift == false || it == 1) // Seq or 1st iter?
-		{ iftSICLE_RunSeedIFT(sicle, args, &data); }
-		else 
-		{ iftSICLE_RunSeedDIFT(sicle, args, &data, &irre_seeds); }
+	// The other superspels keep their labels
+	max_label = 0;
+	for(int s_id = 0; s_id < data->seeds->n; ++s_id)
+	{ max_label = iftMax(max_label, -iftSICLE_PredOf(data, data->seeds->val[s_id])); }
 
-		#ifdef IFT_DEBUG //-------------------------------------------------------|
-		iftImage *seed_img = iftSICLE_CreateSeedImage(sicle, data);
-		iftWriteImageByExt(seed_img, "debug/seeds_%d_%d.pgm", it, ni->val[it-1]);
-		iftDestroyImage(&seed_img);
-		iftImage *segm_img = iftSICLE_CreateLabelImage(sicle, data);
-		iftWriteImageByExt(segm_img, "debug/segm_%d_%d.pgm", it, ni->val[it-1]);
-		iftDestroyImage(&segm_img);
-		fprintf(stderr, "DEBUG (%s): Ni = %d\n", __func__, ni->val[it]);
-		#endif //-----------------------------------------------------------------|		
-		
-		iftSICLE_RemSeeds(sicle, ni->val[it], args,&data, &irre_seeds);
-  }
-	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	fprintf(stderr, "DEBUG (%s): Last iteration\n", __func__);
-	#endif //-------------------------------------------------------------------|	
-	// Segmentation with Nf seeds
-	if(args->use_dift == false) // Seq?
-	{ iftSICLE_RunSeedIFT(sicle, args, &data); }
-	else 
-	{ iftSICLE_RunSeedDIFT(sicle, args, &data, &irre_seeds); }
-	
-  #ifdef IFT_DEBUG //---------------------------------------------------------|
-	iftImage *seed_img = iftSICLE_CreateSeedImage(sicle, data);
-	iftWriteImageByExt(seed_img, "debug/seeds_%d_%d.pgm", ni->n, args->nf);
-	iftDestroyImage(&seed_img);
-	iftImage *segm_img = iftSICLE_CreateLabelImage(sicle, data);
-	iftWriteImageByExt(segm_img, "debug/segm_%d_%d.pgm", ni->n, args->nf);
-	iftDestroyImage(&segm_img);
-	#endif //-------------------------------------------------------------------|
+	seeds = iftCreateIntArray(data->seeds->n + 1);
+	memcpy(seeds->val, data->seeds->val, data->seeds->n * sizeof(int));
+	seeds->val[data->seeds->n] = s_index;
+	iftDestroyIntArray(&(data->seeds));
+	data->seeds = seeds;
 
-	segm = iftSICLE_CreateLabelImage(sicle, data);
+	bb.begin.x = bb.begin.y = bb.begin.z = IFT_INFINITY_INT;
+	bb.end.x = bb.end.y = bb.end.z = IFT_INFINITY_INT_NEG;
+	iftSICLE_PlantSeed(data, s_index, max_label + 1);
+	iftSICLE_EndSeedEdit(sicle, args, data, &bb, label_img);
 
 	if(default_args) { iftDestroySICLEArgs(&args); }
-	iftSICLE_DestroyIFTData(&data);
-	iftDestroyIntArray(&ni);
-	return segm;
+	return bb;
 }
 
-iftImage **iftRunMultiscaleSICLE
-(iftSICLE *sicle, iftSICLEArgs *args, int *num_scales)
+iftBoundingBox iftRemoveSICLESeed
+(iftSICLE *sicle, iftSICLEArgs *args, iftVoxel vxl, iftImage *label_img)
 {
 	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	assert(sicle != NULL);
-	if(args != NULL) { iftVerifySICLEArgs(sicle,args); }
+	assert(sicle != NULL); assert(label_img != NULL);
 	#endif //-------------------------------------------------------------------|
 	bool default_args;
+	int s_id;
+	iftBoundingBox bb;
 	iftSICLE_IFTData *data;
-	iftSet *irre_seeds;
-	iftIntArray *ni;
-	iftImage **segm;
 
 	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
 	else { default_args = false; }
 
-	data = iftSICLE_CreateIFTData(sicle, args);
-	ni = iftSICLE_CreateNiArray(args, data);
-	(*num_scales) = ni->n;
-	segm = calloc(ni->n, sizeof(iftImage*));
+	data = iftSICLE_BeginSeedEdit(sicle, args, label_img, __func__);
+	if(data->seeds->n <= 1)
+	{ iftError("The last seed cannot be removed", __func__); }
+	s_id = iftSICLE_FindSeedOf(sicle, data, vxl, __func__);
 
-	irre_seeds = NULL;
-  for(int it = 1; it < ni->n; ++it)
-  {
-  	#ifdef IFT_DEBUG //-------------------------------------------------------|
-		fprintf(stderr, "DEBUG (%s): Iteration %d\n", __func__, it);
-		#endif //-----------------------------------------------------------------|	
-		if(args->use_dift == false || it == 1) // Seq or 1st iter?
-		{ iftSICLE_RunSeedIFT(sicle, args, &data); }
-		else 
-		{ iftSICLE_RunSeedDIFT(sicle, args, &data, &irre_seeds); }
-		segm[it - 1] = iftSICLE_CreateLabelImage(sicle, data);
+	bb.begin.x = bb.begin.y = bb.begin.z = IFT_INFINITY_INT;
+	bb.end.x = bb.end.y = bb.end.z = IFT_INFINITY_INT_NEG;
+	iftSICLE_UprootSeed(sicle, data, data->seeds->val[s_id], &bb);
+	// Order is irrelevant, since the labels are kept within the roots
+	data->seeds->val[s_id] = data->seeds->val[data->seeds->n - 1];
+	data->seeds->n--;
+	iftSICLE_EndSeedEdit(sicle, args, data, &bb, label_img);
 
-		#ifdef IFT_DEBUG //-------------------------------------------------------|
-		iftImage *seed_img = iftSICLE_CreateSeedImage(sicle, data);
-		iftWriteImageByExt(seed_img, "debug/seeds_%d_%d.pgm", it, ni->val[it-1]);
-		iftDestroyImage(&seed_img);
-		fprintf(stderr, "DEBUG (%s): Ni = %d\n", __func__, ni->val[it]);
-		#endif //-----------------------------------------------------------------|		
-		iftSICLE_RemSeeds(sicle, ni->val[it], args,&data, &irre_seeds);
-  }
+	if(default_args) { iftDestroySICLEArgs(&args); }
+	return bb;
+}
 
-	// Segmentation with Nf seeds
+iftBoundingBox iftMoveSICLESeed
+(iftSICLE *sicle, iftSICLEArgs *args, iftVoxel src, iftVoxel dst, 
+ iftImage *label_img)
+{
 	#ifdef IFT_DEBUG //---------------------------------------------------------|
-	fprintf(stderr, "DEBUG (%s): Last iteration\n", __func__);
-	#endif //-------------------------------------------------------------------|	
-	if(args->use_dift == false) // Seq?
-	{ iftSICLE_RunSeedIFT(sicle, args, &data); }
-	else 
-	{ iftSICLE_RunSeedDIFT(sicle, args, &data, &irre_seeds); }
-	segm[ni->n - 1] = iftSICLE_CreateLabelImage(sicle, data);
-
-  #ifdef IFT_DEBUG //---------------------------------------------------------|
-	iftImage *seed_img = iftSICLE_CreateSeedImage(sicle, data);
-	iftWriteImageByExt(seed_img, "debug/seeds_%d_%d.pgm", ni->n, args->nf);
-	iftDestroyImage(&seed_img);
+	assert(sicle != NULL); assert(label_img != NULL);
 	#endif //-------------------------------------------------------------------|
+	bool default_args;
+	int s_id, s_index, d_index, label;
+	iftBoundingBox bb;
+	iftSICLE_IFTData *data;
 
-	if(default_args) { iftDestroySICLEArgs(&args); }
-	iftSICLE_DestroyIFTData(&data);
-	iftDestroyIntArray(&ni);
+	if(args == NULL) { args = iftCreateSICLEArgs(); default_args = true;}
+	else { default_args = false; }
 
-	return segm;
-}
+	data = iftSICLE_BeginSeedEdit(sicle, args, label_img, __func__);
+	s_id = iftSICLE_FindSeedOf(sicle, data, src, __func__);
+	s_index = data->seeds->val[s_id];
+	label = -iftSICLE_PredOf(data, s_index);
 
+	if(iftMValidVoxel(sicle->mimg, dst) && 
+		 iftMGetVoxelIndex(sicle->mimg, dst) == s_index) { d_index = s_index; }
+	else { d_index = iftSICLE_GetNewSeed(sicle, data, dst, __func__); }
+
+	bb.begin.x = bb.begin.y = bb.begin.z = IFT_INFINITY_INT;
+	bb.end.x = bb.end.y = bb.end.z = IFT_INFINITY_INT_NEG;
+	iftSICLE_UprootSeed(sicle, data, s_index, &bb);
+	data->seeds->val[s_id] = d_index;
+	iftSICLE_PlantSeed(data, d_index, label);
+	iftSICLE_EndSeedEdit(sicle, args, data, &bb, label_img);
+
+	if(default_args) { iftDestroySICLEArgs(&args); }
+	return bb;
+}